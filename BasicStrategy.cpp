@@ -0,0 +1,275 @@
+#include "BasicStrategy.h"
+#include "DealerOdds.h"
+#include <algorithm>
+
+namespace CardGameLib {
+namespace Games {
+namespace Blackjack {
+
+namespace {
+    const int HARD_FIRST = 4;
+    const int SOFT_FIRST = 12;
+    
+    // Probability of drawing a card worth the given points (aces as 1) from an infinite shoe
+    double CardProbability(int points)
+    {
+        return points == 10 ? 4.0 / 13.0 : 1.0 / 13.0;
+    }
+    
+    // Hand value counting one ace as 11 when that doesn't bust
+    int BestValue(int hardTotal, bool hasAce)
+    {
+        return (hasAce && hardTotal + 10 <= 21) ? hardTotal + 10 : hardTotal;
+    }
+    
+    // Expected values, in units of the initial bet, of the player's options against
+    // one dealer up card, given the dealer's outcomes for it. Hands are described by
+    // their hard total and whether they hold an ace.
+    class StrategyCalculator {
+    public:
+        StrategyCalculator(const BlackjackRules& rules, const DealerOdds& dealer)
+            : m_rules(rules)
+            , m_dealer(dealer)
+            , m_hitStandMemo()
+            , m_hitStandKnown()
+        {
+        }
+        
+        double Stand(int value) const
+        {
+            double ev = m_dealer.bust - m_dealer.blackjack;
+            for (int dealerValue = 17; dealerValue <= 21; ++dealerValue) {
+                if (value > dealerValue) {
+                    ev += m_dealer.GetTotal(dealerValue);
+                } else if (value < dealerValue) {
+                    ev -= m_dealer.GetTotal(dealerValue);
+                }
+            }
+            return ev;
+        }
+        
+        // Best of standing and hitting from here on (no more doubles)
+        double HitOrStand(int hardTotal, bool hasAce)
+        {
+            if (hardTotal > 21) {
+                return -1.0;
+            }
+            
+            if (!m_hitStandKnown[hardTotal][hasAce]) {
+                m_hitStandMemo[hardTotal][hasAce] = std::max(Stand(BestValue(hardTotal, hasAce)),
+                                                             Hit(hardTotal, hasAce));
+                m_hitStandKnown[hardTotal][hasAce] = true;
+            }
+            
+            return m_hitStandMemo[hardTotal][hasAce];
+        }
+        
+        double Hit(int hardTotal, bool hasAce)
+        {
+            double ev = 0.0;
+            for (int card = 1; card <= 10; ++card) {
+                ev += CardProbability(card) * HitOrStand(hardTotal + card, hasAce || card == 1);
+            }
+            return ev;
+        }
+        
+        double Double(int hardTotal, bool hasAce) const
+        {
+            double ev = 0.0;
+            for (int card = 1; card <= 10; ++card) {
+                int total = hardTotal + card;
+                ev += CardProbability(card) * (total > 21 ? -1.0 : Stand(BestValue(total, hasAce || card == 1)));
+            }
+            return 2.0 * ev;
+        }
+        
+        // Best first decision without splitting
+        double BestFirst(int hardTotal, bool hasAce, bool allowSurrender)
+        {
+            double ev = std::max(HitOrStand(hardTotal, hasAce), Double(hardTotal, hasAce));
+            if (allowSurrender) {
+                ev = std::max(ev, -0.5);
+            }
+            return ev;
+        }
+        
+        // Split a pair into two hands that each draw a second card
+        double Split(int points)
+        {
+            double handEv = 0.0;
+            
+            for (int card = 1; card <= 10; ++card) {
+                int hardTotal = points + card;
+                bool hasAce = points == 1 || card == 1;
+                double ev;
+                
+                if (hasAce && hardTotal == 11 && m_rules.splitTwentyOneIsBlackjack) {
+                    // Pays 3:2, pushes with a dealer blackjack
+                    ev = 1.5 * (1.0 - m_dealer.blackjack);
+                } else if (m_rules.doubleAfterSplit) {
+                    ev = std::max(HitOrStand(hardTotal, hasAce), Double(hardTotal, hasAce));
+                } else {
+                    ev = HitOrStand(hardTotal, hasAce);
+                }
+                
+                handEv += CardProbability(card) * ev;
+            }
+            
+            return 2.0 * handEv;
+        }
+        
+    private:
+        BlackjackRules m_rules;
+        DealerOdds m_dealer;
+        double m_hitStandMemo[22][2];
+        bool m_hitStandKnown[22][2];
+    };
+    
+    // Pack the three decisions of a table cell
+    uint8_t MakeCell(double stand, double hit, double doubleDown, double surrender, bool allowSurrender)
+    {
+        BlackjackAction hitStand = stand >= hit ? BlackjackAction::STAND : BlackjackAction::HIT;
+        double hitStandEv = std::max(stand, hit);
+        
+        BlackjackAction noSurrender = doubleDown > hitStandEv ? BlackjackAction::DOUBLE : hitStand;
+        double noSurrenderEv = std::max(doubleDown, hitStandEv);
+        
+        BlackjackAction best = (allowSurrender && surrender > noSurrenderEv) ? BlackjackAction::SURRENDER : noSurrender;
+        
+        return static_cast<uint8_t>(static_cast<int>(best) |
+                                    (static_cast<int>(noSurrender) << 3) |
+                                    (hitStand == BlackjackAction::STAND ? 0x40 : 0));
+    }
+}
+
+BasicStrategy::BasicStrategy(const BlackjackRules& rules)
+    : m_rules(rules)
+    , m_hard()
+    , m_soft()
+    , m_pairs()
+{
+    Generate();
+}
+
+const BasicStrategy& BasicStrategy::GetDefault()
+{
+    static const BasicStrategy strategy;
+    return strategy;
+}
+
+BlackjackAction BasicStrategy::GetAction(const BlackjackHand& hand, Core::Card dealerUpCard,
+                                         bool canDouble, bool canSplit, bool canSurrender) const
+{
+    int value = hand.GetValue();
+    if (value >= 21) {
+        return BlackjackAction::STAND;
+    }
+    
+    int up = BlackjackHand::GetCardPoints(dealerUpCard.GetRank()) - 1;
+    
+    if (canSplit && hand.Size() == 2) {
+        int points = BlackjackHand::GetCardPoints(hand[0].GetRank());
+        if (points == BlackjackHand::GetCardPoints(hand[1].GetRank()) && m_pairs[points - 1][up]) {
+            return BlackjackAction::SPLIT;
+        }
+    }
+    
+    uint8_t cell;
+    if (hand.IsSoft()) {
+        cell = m_soft[value - SOFT_FIRST][up];
+    } else if (value >= HARD_FIRST) {
+        cell = m_hard[value - HARD_FIRST][up];
+    } else {
+        return BlackjackAction::HIT;
+    }
+    
+    if (!canDouble) {
+        return (cell & 0x40) ? BlackjackAction::STAND : BlackjackAction::HIT;
+    }
+    
+    return static_cast<BlackjackAction>(canSurrender ? (cell & 0x07) : ((cell >> 3) & 0x07));
+}
+
+BlackjackAction BasicStrategy::Decide(const BlackjackHand& hand, Core::Card dealerUpCard,
+                                      bool canDouble, bool canSplit, bool canSurrender) const
+{
+    return GetAction(hand, dealerUpCard, canDouble, canSplit, canSurrender);
+}
+
+const BlackjackRules& BasicStrategy::GetRules() const
+{
+    return m_rules;
+}
+
+std::string BasicStrategy::ToBlob() const
+{
+    std::string blob;
+    blob.reserve(BLOB_SIZE);
+    
+    blob.push_back(static_cast<char>((m_rules.dealerHitsSoft17 ? 0x01 : 0) |
+                                     (m_rules.dealerPeeks ? 0x02 : 0) |
+                                     (m_rules.doubleAfterSplit ? 0x04 : 0) |
+                                     (m_rules.surrenderAllowed ? 0x08 : 0) |
+                                     (m_rules.splitTwentyOneIsBlackjack ? 0x10 : 0)));
+    
+    blob.append(reinterpret_cast<const char*>(m_hard), sizeof(m_hard));
+    blob.append(reinterpret_cast<const char*>(m_soft), sizeof(m_soft));
+    blob.append(reinterpret_cast<const char*>(m_pairs), sizeof(m_pairs));
+    
+    return blob;
+}
+
+bool BasicStrategy::LoadBlob(std::string_view blob)
+{
+    if (blob.size() != BLOB_SIZE) {
+        return false;
+    }
+    
+    uint8_t flags = static_cast<uint8_t>(blob[0]);
+    m_rules.dealerHitsSoft17 = (flags & 0x01) != 0;
+    m_rules.dealerPeeks = (flags & 0x02) != 0;
+    m_rules.doubleAfterSplit = (flags & 0x04) != 0;
+    m_rules.surrenderAllowed = (flags & 0x08) != 0;
+    m_rules.splitTwentyOneIsBlackjack = (flags & 0x10) != 0;
+    
+    const char* cells = blob.data() + 1;
+    std::copy(cells, cells + sizeof(m_hard), reinterpret_cast<char*>(m_hard));
+    cells += sizeof(m_hard);
+    std::copy(cells, cells + sizeof(m_soft), reinterpret_cast<char*>(m_soft));
+    cells += sizeof(m_soft);
+    std::copy(cells, cells + sizeof(m_pairs), reinterpret_cast<char*>(m_pairs));
+    
+    return true;
+}
+
+void BasicStrategy::Generate()
+{
+    DealerOddsCalculator dealerOdds(m_rules);
+    
+    for (int up = 0; up < UP_CARDS; ++up) {
+        Core::Card upCard(Core::Suit::SPADES, static_cast<Core::Rank>(up + 1));
+        StrategyCalculator calculator(m_rules, dealerOdds.ComputeInfinite(upCard));
+        
+        for (int row = 0; row < HARD_ROWS; ++row) {
+            int hardTotal = HARD_FIRST + row;
+            m_hard[row][up] = MakeCell(calculator.Stand(hardTotal), calculator.Hit(hardTotal, false),
+                                       calculator.Double(hardTotal, false), -0.5, m_rules.surrenderAllowed);
+        }
+        
+        for (int row = 0; row < SOFT_ROWS; ++row) {
+            int hardTotal = SOFT_FIRST + row - 10;
+            m_soft[row][up] = MakeCell(calculator.Stand(SOFT_FIRST + row), calculator.Hit(hardTotal, true),
+                                       calculator.Double(hardTotal, true), -0.5, m_rules.surrenderAllowed);
+        }
+        
+        for (int row = 0; row < PAIR_ROWS; ++row) {
+            int points = row + 1;
+            double keep = calculator.BestFirst(2 * points, points == 1, m_rules.surrenderAllowed);
+            m_pairs[row][up] = calculator.Split(points) > keep ? 1 : 0;
+        }
+    }
+}
+
+} // namespace Blackjack
+} // namespace Games
+} // namespace CardGameLib
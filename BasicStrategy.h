@@ -0,0 +1,66 @@
+#pragma once
+
+#include "BlackjackSimulator.h"
+#include "BlackjackRules.h"
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+namespace CardGameLib {
+namespace Games {
+namespace Blackjack {
+
+// Basic strategy decision tables.
+//
+// The tables are generated from exact dealer outcome probabilities for a rule set,
+// assuming an infinite shoe (every rank equally likely on every draw). They hold
+// the best first decision for hard totals 4-20, soft totals 12-20 and every pair
+// against each dealer up card. Lookups are O(1). The tables round-trip through a
+// compact binary blob (the rule flags, then one byte per cell), so they can be
+// generated once and shipped.
+class BasicStrategy : public BlackjackStrategy {
+public:
+    // Generate the tables for a rule set
+    explicit BasicStrategy(const BlackjackRules& rules = BlackjackRules());
+    
+    // Tables for BlackjackGame's rules, generated on first use
+    static const BasicStrategy& GetDefault();
+    
+    // Best action for a hand. Without DOUBLE or SURRENDER the best remaining action is
+    // returned, and hands of 21 or more always stand.
+    BlackjackAction GetAction(const BlackjackHand& hand, Core::Card dealerUpCard,
+                              bool canDouble, bool canSplit, bool canSurrender) const;
+    
+    // BlackjackStrategy interface (for simulations)
+    virtual BlackjackAction Decide(const BlackjackHand& hand, Core::Card dealerUpCard,
+                                   bool canDouble, bool canSplit, bool canSurrender) const override;
+    
+    const BlackjackRules& GetRules() const;
+    
+    // Compact binary form
+    static constexpr int HARD_ROWS = 17;  // Hard 4-20
+    static constexpr int SOFT_ROWS = 9;   // Soft 12-20
+    static constexpr int PAIR_ROWS = 10;  // Pairs of aces, 2s ... 10s
+    static constexpr int UP_CARDS = 10;   // Ace, 2 ... 10
+    static constexpr size_t BLOB_SIZE = 1 + (HARD_ROWS + SOFT_ROWS + PAIR_ROWS) * UP_CARDS;
+    
+    std::string ToBlob() const;
+    bool LoadBlob(std::string_view blob);
+    
+private:
+    // Each cell packs three decisions: the best action in bits 0-2, the best action
+    // without surrender in bits 3-5 and the better of hit and stand in bit 6 (set to
+    // stand). Pair cells are 1 when the pair should be split.
+    BlackjackRules m_rules;
+    uint8_t m_hard[HARD_ROWS][UP_CARDS];
+    uint8_t m_soft[SOFT_ROWS][UP_CARDS];
+    uint8_t m_pairs[PAIR_ROWS][UP_CARDS];
+    
+    void Generate();
+};
+
+} // namespace Blackjack
+} // namespace Games
+} // namespace CardGameLib
@@ -1,4 +1,5 @@
 #include "Blackjack.h"
+#include "BasicStrategy.h"
 #include <algorithm>
 #include <random>
 #include <iostream>
@@ -10,10 +11,11 @@ namespace Blackjack {
 // BlackjackGame implementation
 BlackjackGame::BlackjackGame()
     : Core::Game("Blackjack", Core::GameType::BLACKJACK, 7)  // 7 players max in standard blackjack
-    , m_deck(new Core::Deck())
+    , m_shoe(Shoe::DEFAULT_DECKS, Shoe::DEFAULT_PENETRATION)
     , m_currentPlayer(nullptr)
     , m_dealer(nullptr)
     , m_gameState(GameState::BETTING)
+    , m_dealerOdds()
 {
 }
 
@@ -25,11 +27,9 @@ void BlackjackGame::Initialize()
 {
     std::cout << "Initializing Blackjack game..." << std::endl;
     
-    // Create a standard 52-card deck (create a new one since Initialize has no params)
-    m_deck.reset(new Core::Deck());
-    
-    // Shuffle the deck
-    m_deck->Shuffle();
+    // Shuffle the shoe for a new deal
+    m_shoe.Seed(NextDealNumber());
+    m_shoe.Shuffle();
     
     // Create players and dealer
     InitializePlayers();
@@ -65,9 +65,9 @@ void BlackjackGame::Reset()
         player->Reset();
     }
     
-    // Reset the deck
-    m_deck.reset(new Core::Deck());
-    m_deck->Shuffle();
+    // Reset the shoe
+    m_shoe.Seed(NextDealNumber());
+    m_shoe.Shuffle();
     
     // Reset game state
     m_currentPlayer = m_players.empty() ? nullptr : m_players.front().get();
@@ -75,17 +75,13 @@ void BlackjackGame::Reset()
     SetState(Core::GameState::WAITING_FOR_PLAYERS);
 }
 
-bool BlackjackGame::IsValidMove(const std::string& moveData)
+bool BlackjackGame::IsValidMove(const Core::Move& move)
 {
     // Simple move validation for now
-    if (moveData == "hit" || moveData == "stand" || moveData == "double" || 
-        moveData == "split" || moveData == "surrender") {
-        return true;
-    }
-    return false;
+    return move.type <= static_cast<uint8_t>(BlackjackAction::SURRENDER);
 }
 
-bool BlackjackGame::MakeMove(int playerId, const std::string& moveData)
+bool BlackjackGame::MakeMove(int playerId, const Core::Move& move)
 {
     // Find the player
     BlackjackPlayer* player = nullptr;
@@ -101,21 +97,36 @@ bool BlackjackGame::MakeMove(int playerId, const std::string& moveData)
     }
     
     // Process the move
-    if (moveData == "hit") {
-        PlayerHit(player);
-        return true;
-    } else if (moveData == "stand") {
-        PlayerStand(player);
-        return true;
-    } else if (moveData == "double") {
-        PlayerDouble(player);
-        return true;
-    } else if (moveData == "split") {
-        PlayerSplit(player);
-        return true;
-    } else if (moveData == "surrender") {
-        PlayerSurrender(player);
-        return true;
+    switch (static_cast<BlackjackAction>(move.type)) {
+        case BlackjackAction::HIT:
+            PlayerHit(player);
+            return true;
+        case BlackjackAction::STAND:
+            PlayerStand(player);
+            return true;
+        case BlackjackAction::DOUBLE:
+            PlayerDouble(player);
+            return true;
+        case BlackjackAction::SPLIT:
+            PlayerSplit(player);
+            return true;
+        case BlackjackAction::SURRENDER:
+            PlayerSurrender(player);
+            return true;
+    }
+    
+    return false;
+}
+
+bool BlackjackGame::ParseMove(const std::string& moveData, Core::Move& move) const
+{
+    static const char* const ACTION_NAMES[] = { "hit", "stand", "double", "split", "surrender" };
+    
+    for (size_t i = 0; i < sizeof(ACTION_NAMES) / sizeof(ACTION_NAMES[0]); ++i) {
+        if (moveData == ACTION_NAMES[i]) {
+            move = Core::Move::Make(static_cast<BlackjackAction>(i));
+            return true;
+        }
     }
     
     return false;
@@ -195,8 +206,7 @@ void BlackjackGame::Update(float deltaTime)
             for (auto& player : m_players) {
                 player->Reset();
             }
-            m_deck.reset(new Core::Deck());
-            m_deck->Shuffle();
+            m_shoe.ShuffleIfNeeded();
             m_currentPlayer = m_players.front().get();
             m_gameState = GameState::BETTING;
             break;
@@ -243,15 +253,15 @@ void BlackjackGame::Render()
         // Show hand
         std::cout << "  Hand: ";
         const auto& hand = player->GetHand();
-        if (hand.empty()) {
+        if (hand.IsEmpty()) {
             std::cout << "Empty";
         } else {
-            for (auto card : hand) {
+            for (size_t i = 0; i < hand.Size(); ++i) {
                 // In dealer's first turn, hide the second card
-                if (player->IsDealer() && m_gameState == GameState::PLAYER_TURN && card == hand[1]) {
+                if (player->IsDealer() && m_gameState == GameState::PLAYER_TURN && i == 1) {
                     std::cout << "[Hidden] ";
                 } else {
-                    std::cout << card->ToString() << " ";
+                    std::cout << hand[i].ToString() << " ";
                 }
             }
             std::cout << "= " << CalculateHandValue(hand);
@@ -267,8 +277,8 @@ void BlackjackGame::Render()
         if (player->HasSplitHand()) {
             std::cout << "  Split Hand: ";
             const auto& splitHand = player->GetSplitHand();
-            for (auto card : splitHand) {
-                std::cout << card->ToString() << " ";
+            for (size_t i = 0; i < splitHand.Size(); ++i) {
+                std::cout << splitHand[i].ToString() << " ";
             }
             std::cout << "= " << CalculateHandValue(splitHand);
             if (IsBlackjack(splitHand)) {
@@ -308,8 +318,10 @@ void BlackjackGame::StartNewRound()
         player->Reset();
     }
     
-    m_deck.reset(new Core::Deck());
-    m_deck->Shuffle();
+    // Reshuffle once the cut card has come out
+    if (m_shoe.ShuffleIfNeeded()) {
+        std::cout << "Reshuffling shoe...\n";
+    }
     
     m_currentPlayer = m_players.front().get();
     m_gameState = GameState::BETTING;
@@ -329,76 +341,45 @@ void BlackjackGame::DealInitialCards()
     }
 }
 
-Core::Card* BlackjackGame::DealCard(BlackjackPlayer* player)
+Core::Card BlackjackGame::DealCard(BlackjackPlayer* player)
 {
-    if (player == nullptr) {
-        return nullptr;
+    // Draw a card from the shoe
+    if (m_shoe.IsEmpty()) {
+        // Shoe ran out mid-round; drawing reshuffles the discards, not the cards in play
+        std::cout << "Reshuffling discards...\n";
     }
     
-    // Draw a card from the deck
-    if (m_deck->IsEmpty()) {
-        // Deck is empty, create a new one and shuffle it
-        std::cout << "Reshuffling deck...\n";
-        m_deck.reset(new Core::Deck());
-        m_deck->Shuffle();
-    }
+    Core::Card card = m_shoe.Draw();
     
-    // Create a heap card copy
-    Core::Card* cardPtr = new Core::Card(m_deck->Draw());
+    // Add the card to the player's hand (without a player the card is burned)
+    if (player == nullptr) {
+        return card;
+    }
     
-    // Add the card to the player's hand
     if (player->m_playingSplitHand) {
-        player->AddCardToSplitHand(cardPtr);
+        player->AddCardToSplitHand(card);
     } else {
-        player->AddCard(cardPtr);
+        player->AddCard(card);
     }
     
-    return cardPtr;
+    return card;
 }
 
-int BlackjackGame::CalculateHandValue(const std::vector<Core::Card*>& hand) const
+int BlackjackGame::CalculateHandValue(const BlackjackHand& hand) const
 {
-    int value = 0;
-    int aces = 0;
-    
-    for (auto card : hand) {
-        Core::Rank rank = card->GetRank();
-        int cardValue = static_cast<int>(rank);
-        
-        // Face cards (Jack, Queen, King) are worth 10
-        if (rank == Core::Rank::JACK || rank == Core::Rank::QUEEN || rank == Core::Rank::KING) {
-            value += 10;
-        }
-        // Aces can be worth 1 or 11, count them separately
-        else if (rank == Core::Rank::ACE) {
-            aces++;
-            value += 11; // Initially count as 11
-        }
-        // Number cards are worth their face value
-        else {
-            value += cardValue;
-        }
-    }
-    
-    // Adjust aces from 11 to 1 as needed to avoid busting
-    while (value > 21 && aces > 0) {
-        value -= 10; // Change an ace from 11 to 1
-        aces--;
-    }
-    
-    return value;
+    return hand.GetValue();
 }
 
-bool BlackjackGame::IsBlackjack(const std::vector<Core::Card*>& hand) const
+bool BlackjackGame::IsBlackjack(const BlackjackHand& hand) const
 {
     // Blackjack is exactly two cards with a value of 21
-    return hand.size() == 2 && CalculateHandValue(hand) == 21;
+    return hand.IsBlackjack();
 }
 
-bool BlackjackGame::IsBusted(const std::vector<Core::Card*>& hand) const
+bool BlackjackGame::IsBusted(const BlackjackHand& hand) const
 {
     // Busted is a hand with value over 21
-    return CalculateHandValue(hand) > 21;
+    return hand.IsBusted();
 }
 
 void BlackjackGame::PlayerHit(BlackjackPlayer* player)
@@ -410,7 +391,7 @@ void BlackjackGame::PlayerHit(BlackjackPlayer* player)
     std::cout << player->GetName() << " hits\n";
     
     // Deal a card to the player
-    Core::Card* card = DealCard(player);
+    DealCard(player);
     
     // Check if player busted
     const auto& hand = player->m_playingSplitHand ? player->m_splitHand : player->m_hand;
@@ -460,7 +441,7 @@ void BlackjackGame::PlayerStand(BlackjackPlayer* player)
 void BlackjackGame::PlayerDouble(BlackjackPlayer* player)
 {
     if (player == nullptr || player->m_hasStood || player->m_hasSurrendered ||
-        player->GetHand().size() > 2 || (player->m_playingSplitHand && player->GetSplitHand().size() > 2)) {
+        player->GetHand().Size() > 2 || (player->m_playingSplitHand && player->GetSplitHand().Size() > 2)) {
         return;
     }
     
@@ -470,7 +451,7 @@ void BlackjackGame::PlayerDouble(BlackjackPlayer* player)
     player->SetBet(player->GetBet() * 2);
     
     // Deal one more card
-    Core::Card* card = DealCard(player);
+    DealCard(player);
     
     // Player automatically stands after doubling
     PlayerStand(player);
@@ -479,21 +460,16 @@ void BlackjackGame::PlayerDouble(BlackjackPlayer* player)
 void BlackjackGame::PlayerSplit(BlackjackPlayer* player)
 {
     if (player == nullptr || player->m_hasStood || player->m_hasSurrendered || 
-        player->HasSplitHand() || player->GetHand().size() != 2) {
+        player->HasSplitHand() || player->GetHand().Size() != 2) {
         return;
     }
     
     // Can only split if the two cards have the same value
     const auto& hand = player->GetHand();
-    Core::Rank rank1 = hand[0]->GetRank();
-    Core::Rank rank2 = hand[1]->GetRank();
     
     // Convert ranks to blackjack values
-    int card1Value = (rank1 == Core::Rank::JACK || rank1 == Core::Rank::QUEEN || rank1 == Core::Rank::KING) ? 10 : 
-                     (rank1 == Core::Rank::ACE) ? 1 : static_cast<int>(rank1);
-                     
-    int card2Value = (rank2 == Core::Rank::JACK || rank2 == Core::Rank::QUEEN || rank2 == Core::Rank::KING) ? 10 : 
-                     (rank2 == Core::Rank::ACE) ? 1 : static_cast<int>(rank2);
+    int card1Value = BlackjackHand::GetCardPoints(hand[0].GetRank());
+    int card2Value = BlackjackHand::GetCardPoints(hand[1].GetRank());
     
     if (card1Value != card2Value) {
         std::cout << "Cannot split: cards must have the same value\n";
@@ -503,14 +479,12 @@ void BlackjackGame::PlayerSplit(BlackjackPlayer* player)
     std::cout << player->GetName() << " splits\n";
     
     // Move second card to split hand
-    Core::Card* splitCard = hand[1];
-    player->m_hand.pop_back();
-    player->m_splitHand.push_back(splitCard);
+    player->m_splitHand.Add(player->m_hand.RemoveLast());
     
     // Deal one more card to each hand
-    Core::Card* cardForMainHand = DealCard(player);
+    DealCard(player);
     player->m_playingSplitHand = true;
-    Core::Card* cardForSplitHand = DealCard(player);
+    DealCard(player);
     player->m_playingSplitHand = false;
     
     // Player continues playing the first hand
@@ -519,7 +493,7 @@ void BlackjackGame::PlayerSplit(BlackjackPlayer* player)
 void BlackjackGame::PlayerSurrender(BlackjackPlayer* player)
 {
     if (player == nullptr || player->m_hasStood || player->m_hasSurrendered ||
-        player->GetHand().size() > 2) {
+        player->GetHand().Size() > 2) {
         return;
     }
     
@@ -533,6 +507,23 @@ void BlackjackGame::PlayerSurrender(BlackjackPlayer* player)
     NextPlayer();
 }
 
+BlackjackAction BlackjackGame::GetSuggestedAction(const BlackjackPlayer* player) const
+{
+    if (player == nullptr || m_dealer == nullptr || m_dealer->GetHand().IsEmpty()) {
+        return BlackjackAction::STAND;
+    }
+    
+    const BlackjackHand& hand = player->m_playingSplitHand ? player->m_splitHand : player->m_hand;
+    
+    // Only suggest what PlayerDouble, PlayerSplit and PlayerSurrender would accept
+    bool canDouble = hand.Size() <= 2;
+    bool canSplit = !player->HasSplitHand() && hand.Size() == 2 &&
+                    BlackjackHand::GetCardPoints(hand[0].GetRank()) == BlackjackHand::GetCardPoints(hand[1].GetRank());
+    bool canSurrender = !player->HasSplitHand() && hand.Size() <= 2;
+    
+    return BasicStrategy::GetDefault().GetAction(hand, m_dealer->GetHand()[0], canDouble, canSplit, canSurrender);
+}
+
 void BlackjackGame::DealerPlay()
 {
     std::cout << "Dealer plays\n";
@@ -542,9 +533,9 @@ void BlackjackGame::DealerPlay()
     }
     
     // Dealer follows house rules: must hit on 16 or less, stand on 17 or more
-    while (CalculateHandValue(m_dealer->GetHand()) < 17) {
-        Core::Card* card = DealCard(m_dealer);
-        std::cout << "Dealer draws " << card->ToString() << "\n";
+    while (DealerShouldHit(m_dealer->GetHand())) {
+        Core::Card card = DealCard(m_dealer);
+        std::cout << "Dealer draws " << card.ToString() << "\n";
     }
     
     int finalValue = CalculateHandValue(m_dealer->GetHand());
@@ -555,6 +546,28 @@ void BlackjackGame::DealerPlay()
     }
 }
 
+DealerOdds BlackjackGame::GetDealerOdds(Core::Card upCard, const ShoeComposition& unseen)
+{
+    return m_dealerOdds.Compute(upCard, unseen);
+}
+
+DealerOdds BlackjackGame::GetDealerOdds()
+{
+    if (m_dealer == nullptr || m_dealer->GetHand().IsEmpty()) {
+        return DealerOdds();
+    }
+    
+    const BlackjackHand& hand = m_dealer->GetHand();
+    ShoeComposition unseen = m_shoe.GetComposition();
+    
+    // Put back every dealer card after the up card
+    for (size_t i = 1; i < hand.Size(); ++i) {
+        unseen.Add(hand[i]);
+    }
+    
+    return m_dealerOdds.Compute(hand[0], unseen);
+}
+
 void BlackjackGame::PlaceBet(BlackjackPlayer* player, int amount)
 {
     if (player == nullptr || player->IsDealer()) {
@@ -592,7 +605,7 @@ void BlackjackGame::SettleBets()
     }
 }
 
-void BlackjackGame::SettleHand(BlackjackPlayer* player, const std::vector<Core::Card*>& hand, 
+void BlackjackGame::SettleHand(BlackjackPlayer* player, const BlackjackHand& hand, 
                               int dealerValue, bool dealerBusted, bool dealerBlackjack)
 {
     if (player->m_hasSurrendered) {
@@ -602,41 +615,73 @@ void BlackjackGame::SettleHand(BlackjackPlayer* player, const std::vector<Core::
     }
     
     int playerValue = CalculateHandValue(hand);
-    bool playerBusted = IsBusted(hand);
-    bool playerBlackjack = IsBlackjack(hand);
     
-    if (playerBusted) {
-        std::cout << player->GetName() << " busted and loses\n";
-        player->Lose();
-    }
-    else if (playerBlackjack && !dealerBlackjack) {
-        std::cout << player->GetName() << " has blackjack and wins 3:2\n";
-        player->Win(1.5f);
-    }
-    else if (!playerBlackjack && dealerBlackjack) {
-        std::cout << player->GetName() << " loses to dealer's blackjack\n";
-        player->Lose();
+    switch (GetHandOutcome(hand, dealerValue, dealerBusted, dealerBlackjack)) {
+        case HandOutcome::BLACKJACK:
+            std::cout << player->GetName() << " has blackjack and wins 3:2\n";
+            player->Win(1.5f);
+            break;
+            
+        case HandOutcome::WIN:
+            if (dealerBusted) {
+                std::cout << player->GetName() << " wins as dealer busted\n";
+            } else {
+                std::cout << player->GetName() << " wins with " << playerValue << " vs dealer's " << dealerValue << "\n";
+            }
+            player->Win();
+            break;
+            
+        case HandOutcome::LOSE:
+            if (IsBusted(hand)) {
+                std::cout << player->GetName() << " busted and loses\n";
+            } else if (dealerBlackjack) {
+                std::cout << player->GetName() << " loses to dealer's blackjack\n";
+            } else {
+                std::cout << player->GetName() << " loses with " << playerValue << " vs dealer's " << dealerValue << "\n";
+            }
+            player->Lose();
+            break;
+            
+        case HandOutcome::PUSH:
+            if (dealerBlackjack) {
+                std::cout << player->GetName() << " pushes with dealer's blackjack\n";
+            } else {
+                std::cout << player->GetName() << " pushes with " << playerValue << " vs dealer's " << dealerValue << "\n";
+            }
+            player->Push();
+            break;
     }
-    else if (playerBlackjack && dealerBlackjack) {
-        std::cout << player->GetName() << " pushes with dealer's blackjack\n";
-        player->Push();
+}
+
+bool BlackjackGame::DealerShouldHit(const BlackjackHand& dealerHand)
+{
+    // Hit on 16 or less, stand on all 17s
+    return dealerHand.GetValue() < 17;
+}
+
+HandOutcome BlackjackGame::GetHandOutcome(const BlackjackHand& hand,
+                                          int dealerValue, bool dealerBusted, bool dealerBlackjack)
+{
+    int playerValue = hand.GetValue();
+    bool playerBlackjack = hand.IsBlackjack();
+    
+    if (hand.IsBusted()) {
+        return HandOutcome::LOSE;
     }
-    else if (dealerBusted) {
-        std::cout << player->GetName() << " wins as dealer busted\n";
-        player->Win();
+    if (playerBlackjack && !dealerBlackjack) {
+        return HandOutcome::BLACKJACK;
     }
-    else if (playerValue > dealerValue) {
-        std::cout << player->GetName() << " wins with " << playerValue << " vs dealer's " << dealerValue << "\n";
-        player->Win();
+    if (!playerBlackjack && dealerBlackjack) {
+        return HandOutcome::LOSE;
     }
-    else if (playerValue < dealerValue) {
-        std::cout << player->GetName() << " loses with " << playerValue << " vs dealer's " << dealerValue << "\n";
-        player->Lose();
+    if (playerBlackjack && dealerBlackjack) {
+        return HandOutcome::PUSH;
     }
-    else {
-        std::cout << player->GetName() << " pushes with " << playerValue << " vs dealer's " << dealerValue << "\n";
-        player->Push();
+    if (dealerBusted || playerValue > dealerValue) {
+        return HandOutcome::WIN;
     }
+    
+    return playerValue < dealerValue ? HandOutcome::LOSE : HandOutcome::PUSH;
 }
 
 void BlackjackGame::NextPlayer()
@@ -706,9 +751,9 @@ BlackjackPlayer::~BlackjackPlayer()
 
 void BlackjackPlayer::Reset()
 {
-    // Clear hands but don't delete cards as they belong to the deck
-    m_hand.clear();
-    m_splitHand.clear();
+    // Clear hands
+    m_hand.Clear();
+    m_splitHand.Clear();
     
     // Reset player state
     m_currentBet = 0;
@@ -717,18 +762,14 @@ void BlackjackPlayer::Reset()
     m_playingSplitHand = false;
 }
 
-void BlackjackPlayer::AddCard(Core::Card* card)
+void BlackjackPlayer::AddCard(const Core::Card& card)
 {
-    if (card != nullptr) {
-        m_hand.push_back(card);
-    }
+    m_hand.Add(card);
 }
 
-void BlackjackPlayer::AddCardToSplitHand(Core::Card* card)
+void BlackjackPlayer::AddCardToSplitHand(const Core::Card& card)
 {
-    if (card != nullptr) {
-        m_splitHand.push_back(card);
-    }
+    m_splitHand.Add(card);
 }
 
 void BlackjackPlayer::Win(float multiplier)
@@ -4,6 +4,9 @@
 #include "../../core/Card.h"
 #include "../../core/Deck.h"
 #include "../../core/Player.h"
+#include "Shoe.h"
+#include "BlackjackHand.h"
+#include "DealerOdds.h"
 
 #include <vector>
 #include <string>
@@ -25,6 +28,14 @@ enum class BlackjackAction {
     SURRENDER // Give up hand, receive half the bet back
 };
 
+// Result of a finished hand against the dealer
+enum class HandOutcome {
+    LOSE,      // Lose the bet
+    PUSH,      // Bet returned
+    WIN,       // Win 1:1
+    BLACKJACK  // Win 3:2
+};
+
 // Class for Blackjack game implementation
 class BlackjackGame : public Core::Game {
 public:
@@ -37,8 +48,13 @@ public:
     virtual bool Start() override;
     virtual bool CanStart() const override;
     virtual void Reset() override;
-    virtual bool IsValidMove(const std::string& moveData) override;
-    virtual bool MakeMove(int playerId, const std::string& moveData) override;
+    using Core::Game::IsValidMove;
+    using Core::Game::MakeMove;
+    virtual bool IsValidMove(const Core::Move& move) override;
+    virtual bool MakeMove(int playerId, const Core::Move& move) override;
+    
+    // Move data is the action name: hit, stand, double, split or surrender
+    virtual bool ParseMove(const std::string& moveData, Core::Move& move) const override;
     virtual std::string SerializeGameState() const override;
     virtual bool DeserializeGameState(const std::string& data) override;
     
@@ -50,9 +66,9 @@ public:
     // Blackjack specific methods
     void StartNewRound();
     void DealInitialCards();
-    int CalculateHandValue(const std::vector<Core::Card*>& hand) const;
-    bool IsBlackjack(const std::vector<Core::Card*>& hand) const;
-    bool IsBusted(const std::vector<Core::Card*>& hand) const;
+    int CalculateHandValue(const BlackjackHand& hand) const;
+    bool IsBlackjack(const BlackjackHand& hand) const;
+    bool IsBusted(const BlackjackHand& hand) const;
     
     // Player actions
     void PlayerHit(BlackjackPlayer* player);
@@ -61,15 +77,33 @@ public:
     void PlayerSplit(BlackjackPlayer* player);
     void PlayerSurrender(BlackjackPlayer* player);
     
+    // Basic-strategy hint for the hand the player is playing (bot seats, hints)
+    BlackjackAction GetSuggestedAction(const BlackjackPlayer* player) const;
+    
     // Dealer actions
     void DealerPlay();
     
+    // Exact dealer outcome odds for an up card and the cards still unseen (memoized)
+    DealerOdds GetDealerOdds(Core::Card upCard, const ShoeComposition& unseen);
+    
+    // Odds for the current up card as the players see them: the hole card counts as unseen
+    DealerOdds GetDealerOdds();
+    
+    // Shoe configuration (number of decks, cut card penetration)
+    Shoe& GetShoe() { return m_shoe; }
+    const Shoe& GetShoe() const { return m_shoe; }
+    
     // Betting
     void PlaceBet(BlackjackPlayer* player, int amount);
     void SettleBets();
-    void SettleHand(BlackjackPlayer* player, const std::vector<Core::Card*>& hand, 
+    void SettleHand(BlackjackPlayer* player, const BlackjackHand& hand, 
                    int dealerValue, bool dealerBusted, bool dealerBlackjack);
     
+    // Table rules (shared with BlackjackSimulator)
+    static bool DealerShouldHit(const BlackjackHand& dealerHand);
+    static HandOutcome GetHandOutcome(const BlackjackHand& hand,
+                                      int dealerValue, bool dealerBusted, bool dealerBlackjack);
+    
 private:
     // Game state
     enum class GameState {
@@ -82,15 +116,16 @@ private:
     };
     
     // Member variables
-    std::unique_ptr<Core::Deck> m_deck;
+    Shoe m_shoe;
     std::vector<std::unique_ptr<BlackjackPlayer>> m_players;
     BlackjackPlayer* m_currentPlayer;
     BlackjackPlayer* m_dealer;
     GameState m_gameState;
+    DealerOddsCalculator m_dealerOdds;
     
     // Helper methods
     void InitializePlayers(int numPlayers = 1);
-    Core::Card* DealCard(BlackjackPlayer* player);
+    Core::Card DealCard(BlackjackPlayer* player);
     void NextPlayer();
     bool AllPlayersDone() const;
 };
@@ -104,13 +139,13 @@ public:
     
     // Player actions
     void Reset();
-    void AddCard(Core::Card* card);
-    void AddCardToSplitHand(Core::Card* card);
+    void AddCard(const Core::Card& card);
+    void AddCardToSplitHand(const Core::Card& card);
     
     // Getters and setters
-    const std::vector<Core::Card*>& GetHand() const { return m_hand; }
-    const std::vector<Core::Card*>& GetSplitHand() const { return m_splitHand; }
-    bool HasSplitHand() const { return !m_splitHand.empty(); }
+    const BlackjackHand& GetHand() const { return m_hand; }
+    const BlackjackHand& GetSplitHand() const { return m_splitHand; }
+    bool HasSplitHand() const { return !m_splitHand.IsEmpty(); }
     bool IsDealer() const { return m_isDealer; }
     
     // Betting methods
@@ -121,8 +156,8 @@ public:
     void Push(); // Tie with dealer
     
 private:
-    std::vector<Core::Card*> m_hand;
-    std::vector<Core::Card*> m_splitHand;
+    BlackjackHand m_hand;
+    BlackjackHand m_splitHand;
     bool m_isDealer;
     int m_currentBet;
     bool m_hasSurrendered;
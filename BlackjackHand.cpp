@@ -0,0 +1,80 @@
+#include "BlackjackHand.h"
+
+namespace CardGameLib {
+namespace Games {
+namespace Blackjack {
+
+BlackjackHand::BlackjackHand()
+    : m_codes()
+    , m_size(0)
+    , m_hardTotal(0)
+    , m_aces(0)
+{
+}
+
+bool BlackjackHand::Add(const Core::Card& card)
+{
+    if (m_size >= MAX_CARDS) {
+        return false;
+    }
+    
+    m_codes[m_size++] = card.GetCode();
+    m_hardTotal = static_cast<uint8_t>(m_hardTotal + GetCardPoints(card.GetRank()));
+    
+    if (card.GetRank() == Core::Rank::ACE) {
+        m_aces++;
+    }
+    
+    return true;
+}
+
+Core::Card BlackjackHand::RemoveLast()
+{
+    Core::Card card = Core::Card::FromCode(m_codes[--m_size]);
+    m_hardTotal = static_cast<uint8_t>(m_hardTotal - GetCardPoints(card.GetRank()));
+    
+    if (card.GetRank() == Core::Rank::ACE) {
+        m_aces--;
+    }
+    
+    return card;
+}
+
+void BlackjackHand::Clear()
+{
+    m_size = 0;
+    m_hardTotal = 0;
+    m_aces = 0;
+}
+
+int BlackjackHand::GetValue() const
+{
+    // At most one ace can count 11 without busting
+    return IsSoft() ? m_hardTotal + 10 : m_hardTotal;
+}
+
+bool BlackjackHand::IsSoft() const
+{
+    return m_aces > 0 && m_hardTotal + 10 <= 21;
+}
+
+bool BlackjackHand::IsBlackjack() const
+{
+    return m_size == 2 && GetValue() == 21;
+}
+
+bool BlackjackHand::IsBusted() const
+{
+    return m_hardTotal > 21;
+}
+
+int BlackjackHand::GetCardPoints(Core::Rank rank)
+{
+    // Face cards (Jack, Queen, King) are worth 10, the rest their face value
+    int value = static_cast<int>(rank);
+    return value > 10 ? 10 : value;
+}
+
+} // namespace Blackjack
+} // namespace Games
+} // namespace CardGameLib
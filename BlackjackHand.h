@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../../core/Card.h"
+
+#include <cstdint>
+#include <cstddef>
+
+namespace CardGameLib {
+namespace Games {
+namespace Blackjack {
+
+// A blackjack hand stored by value in fixed inline storage.
+//
+// Cards are kept as their one-byte codes, and the hard total and ace count are
+// updated as cards are added, so valuing a hand never walks the cards. Adding or
+// clearing never allocates.
+class BlackjackHand {
+public:
+    // The longest hand that can still draw: 21 aces count 21, and one more card busts it
+    static constexpr size_t MAX_CARDS = 22;
+    
+    BlackjackHand();
+    
+    // Hand contents. Add fails when the hand is full; RemoveLast needs a non-empty hand.
+    bool Add(const Core::Card& card);
+    Core::Card RemoveLast();
+    void Clear();
+    
+    size_t Size() const { return m_size; }
+    bool IsEmpty() const { return m_size == 0; }
+    Core::Card operator[](size_t index) const { return Core::Card::FromCode(m_codes[index]); }
+    
+    // Best total (an ace counts 11 when that doesn't bust), and whether an ace still counts 11
+    int GetValue() const;
+    bool IsSoft() const;
+    
+    // Two-card 21, and over 21
+    bool IsBlackjack() const;
+    bool IsBusted() const;
+    
+    // Blackjack points of a card with aces as 1
+    static int GetCardPoints(Core::Rank rank);
+    
+private:
+    uint8_t m_codes[MAX_CARDS];
+    uint8_t m_size;
+    uint8_t m_hardTotal;  // Sum with every ace counted as 1
+    uint8_t m_aces;
+};
+
+} // namespace Blackjack
+} // namespace Games
+} // namespace CardGameLib
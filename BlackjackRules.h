@@ -0,0 +1,19 @@
+#pragma once
+
+namespace CardGameLib {
+namespace Games {
+namespace Blackjack {
+
+// Table rules that change the odds and the optimal play. The defaults are
+// BlackjackGame's rules.
+struct BlackjackRules {
+    bool dealerHitsSoft17 = false;           // Dealer hits soft 17 (stands on all 17s otherwise)
+    bool dealerPeeks = false;                // Dealer checks for blackjack before anyone plays
+    bool doubleAfterSplit = true;            // Split hands may double
+    bool surrenderAllowed = true;            // First two cards may surrender for half the bet
+    bool splitTwentyOneIsBlackjack = true;   // A two-card 21 after a split pays 3:2
+};
+
+} // namespace Blackjack
+} // namespace Games
+} // namespace CardGameLib
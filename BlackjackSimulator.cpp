@@ -0,0 +1,195 @@
+#include "BlackjackSimulator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace CardGameLib {
+namespace Games {
+namespace Blackjack {
+
+BlackjackAction DealerMimicStrategy::Decide(const BlackjackHand& hand, Core::Card,
+                                            bool, bool, bool) const
+{
+    return BlackjackGame::DealerShouldHit(hand) ? BlackjackAction::HIT : BlackjackAction::STAND;
+}
+
+BlackjackSimulator::BlackjackSimulator(const BlackjackStrategy& strategy)
+    : m_strategy(strategy)
+{
+}
+
+SimulationResult BlackjackSimulator::Run(const SimulationConfig& config) const
+{
+    SimulationResult result;
+    
+    if (config.rounds == 0) {
+        return result;
+    }
+    
+    size_t threadCount = config.threadCount;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = static_cast<size_t>(std::min<uint64_t>(threadCount, config.rounds));
+    
+    // Totals in half-bets, added to once by each thread
+    std::atomic<int64_t> totalReturn(0);
+    std::atomic<uint64_t> totalSquares(0);
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    
+    for (size_t i = 0; i < threadCount; ++i) {
+        uint64_t rounds = config.rounds / threadCount + (i < config.rounds % threadCount ? 1 : 0);
+        
+        threads.emplace_back([this, &config, &totalReturn, &totalSquares, i, rounds]() {
+            // Each thread deals from its own shoe with its own random stream
+            Shoe shoe(config.numberOfDecks, config.penetration, config.seed + i);
+            
+            int64_t sum = 0;
+            uint64_t squares = 0;
+            
+            for (uint64_t round = 0; round < rounds; ++round) {
+                shoe.ShuffleIfNeeded();
+                
+                int64_t halfBets = PlayRound(shoe);
+                sum += halfBets;
+                squares += static_cast<uint64_t>(halfBets * halfBets);
+            }
+            
+            totalReturn.fetch_add(sum, std::memory_order_relaxed);
+            totalSquares.fetch_add(squares, std::memory_order_relaxed);
+        });
+    }
+    
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    
+    double rounds = static_cast<double>(config.rounds);
+    double mean = static_cast<double>(totalReturn.load()) / 2.0 / rounds;
+    double meanSquare = static_cast<double>(totalSquares.load()) / 4.0 / rounds;
+    
+    result.rounds = config.rounds;
+    result.expectedValue = mean;
+    result.standardDeviation = std::sqrt(std::max(0.0, meanSquare - mean * mean));
+    result.seconds = elapsed.count();
+    result.roundsPerSecond = result.seconds > 0.0 ? rounds / result.seconds : 0.0;
+    
+    return result;
+}
+
+int BlackjackSimulator::PlayRound(Shoe& shoe) const
+{
+    BlackjackHand hand;
+    BlackjackHand splitHand;
+    BlackjackHand dealerHand;
+    
+    // Deal two cards each, alternating as BlackjackGame does
+    hand.Add(shoe.Draw());
+    dealerHand.Add(shoe.Draw());
+    hand.Add(shoe.Draw());
+    dealerHand.Add(shoe.Draw());
+    
+    Core::Card upCard = dealerHand[0];
+    
+    bool surrendered = false;
+    int bet = PlayHand(shoe, hand, upCard, &splitHand, surrendered);
+    
+    // Surrender loses half the bet
+    if (surrendered) {
+        return -1;
+    }
+    
+    int splitBet = 0;
+    if (!splitHand.IsEmpty()) {
+        splitBet = PlayHand(shoe, splitHand, upCard, nullptr, surrendered);
+    }
+    
+    // The dealer only needs to draw while a player hand is still standing
+    if (!hand.IsBusted() || (splitBet > 0 && !splitHand.IsBusted())) {
+        while (BlackjackGame::DealerShouldHit(dealerHand)) {
+            dealerHand.Add(shoe.Draw());
+        }
+    }
+    
+    int dealerValue = dealerHand.GetValue();
+    bool dealerBusted = dealerHand.IsBusted();
+    bool dealerBlackjack = dealerHand.IsBlackjack();
+    
+    // Half-bets won or lost per unit of bet
+    auto settle = [&](const BlackjackHand& playerHand, int units) {
+        switch (BlackjackGame::GetHandOutcome(playerHand, dealerValue, dealerBusted, dealerBlackjack)) {
+            case HandOutcome::BLACKJACK: return 3 * units;
+            case HandOutcome::WIN:       return 2 * units;
+            case HandOutcome::PUSH:      return 0;
+            case HandOutcome::LOSE:      return -2 * units;
+        }
+        return 0;
+    };
+    
+    int result = settle(hand, bet);
+    if (splitBet > 0) {
+        result += settle(splitHand, splitBet);
+    }
+    
+    return result;
+}
+
+int BlackjackSimulator::PlayHand(Shoe& shoe, BlackjackHand& hand, Core::Card dealerUpCard,
+                                 BlackjackHand* splitHand, bool& surrendered) const
+{
+    // Stop at 21 or over; there is nothing left to decide
+    while (hand.GetValue() < 21) {
+        bool firstDecision = hand.Size() == 2;
+        bool canSplit = splitHand && firstDecision &&
+                        BlackjackHand::GetCardPoints(hand[0].GetRank()) == BlackjackHand::GetCardPoints(hand[1].GetRank());
+        bool canSurrender = splitHand && firstDecision;
+        
+        BlackjackAction action = m_strategy.Decide(hand, dealerUpCard, firstDecision, canSplit, canSurrender);
+        
+        if ((action == BlackjackAction::DOUBLE && !firstDecision) ||
+            (action == BlackjackAction::SPLIT && !canSplit) ||
+            (action == BlackjackAction::SURRENDER && !canSurrender)) {
+            action = BlackjackAction::HIT;
+        }
+        
+        switch (action) {
+            case BlackjackAction::HIT:
+                hand.Add(shoe.Draw());
+                break;
+                
+            case BlackjackAction::STAND:
+                return 1;
+                
+            case BlackjackAction::DOUBLE:
+                hand.Add(shoe.Draw());
+                return 2;
+                
+            case BlackjackAction::SPLIT:
+                // One split per round; each hand gets a second card
+                splitHand->Add(hand.RemoveLast());
+                hand.Add(shoe.Draw());
+                splitHand->Add(shoe.Draw());
+                splitHand = nullptr;
+                break;
+                
+            case BlackjackAction::SURRENDER:
+                surrendered = true;
+                return 1;
+        }
+    }
+    
+    return 1;
+}
+
+} // namespace Blackjack
+} // namespace Games
+} // namespace CardGameLib
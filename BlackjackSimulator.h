@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Blackjack.h"
+#include "BlackjackHand.h"
+#include "Shoe.h"
+
+#include <cstdint>
+#include <cstddef>
+
+namespace CardGameLib {
+namespace Games {
+namespace Blackjack {
+
+// Player decisions for simulated hands. Simulation threads share one strategy and
+// call it concurrently, so implementations must not modify state in Decide.
+class BlackjackStrategy {
+public:
+    virtual ~BlackjackStrategy() = default;
+    
+    // Pick an action for the hand being played. HIT and STAND are always allowed;
+    // the flags say whether DOUBLE, SPLIT and SURRENDER are. An action that isn't
+    // allowed is played as HIT.
+    virtual BlackjackAction Decide(const BlackjackHand& hand, Core::Card dealerUpCard,
+                                   bool canDouble, bool canSplit, bool canSurrender) const = 0;
+};
+
+// Plays like the dealer: hit below 17, never double, split or surrender
+class DealerMimicStrategy : public BlackjackStrategy {
+public:
+    virtual BlackjackAction Decide(const BlackjackHand& hand, Core::Card dealerUpCard,
+                                   bool canDouble, bool canSplit, bool canSurrender) const override;
+};
+
+// Simulation settings
+struct SimulationConfig {
+    uint64_t rounds = 1000000;                  // Rounds to play in total
+    size_t threadCount = 0;                     // 0 uses every hardware thread
+    int numberOfDecks = Shoe::DEFAULT_DECKS;
+    float penetration = Shoe::DEFAULT_PENETRATION;
+    uint64_t seed = 1;                          // Thread i plays deal number seed + i
+};
+
+// Aggregate results. Returns are in units of the initial bet per round.
+struct SimulationResult {
+    uint64_t rounds = 0;
+    double expectedValue = 0.0;        // Mean return per round (negative is the house edge)
+    double standardDeviation = 0.0;    // Per-round standard deviation
+    double seconds = 0.0;
+    double roundsPerSecond = 0.0;
+};
+
+// Headless Monte Carlo blackjack. Plays one player against the dealer with the
+// same table rules as BlackjackGame but without any output: the dealer stands on
+// all 17s and doesn't peek for blackjack, any two-card 21 pays 3:2, one split is
+// allowed, doubling is allowed on any two cards and surrender on the first two.
+//
+// Rounds are split evenly across threads. Each thread has its own shoe and random
+// stream and keeps its totals locally. The totals are exact because every return
+// is a whole number of half-bets. Threads add them into shared atomics once, when
+// they finish, so the reduction takes no locks.
+class BlackjackSimulator {
+public:
+    explicit BlackjackSimulator(const BlackjackStrategy& strategy);
+    
+    // Run a simulation and block until every thread has finished
+    SimulationResult Run(const SimulationConfig& config) const;
+    
+    // Play one round from the shoe and return the result in half-bets
+    int PlayRound(Shoe& shoe) const;
+    
+private:
+    const BlackjackStrategy& m_strategy;
+    
+    // Play a player hand to completion and return its bet in units (1, or 2 after a
+    // double). splitHand is only given for the initial hand, which may split or surrender.
+    int PlayHand(Shoe& shoe, BlackjackHand& hand, Core::Card dealerUpCard,
+                 BlackjackHand* splitHand, bool& surrendered) const;
+};
+
+} // namespace Blackjack
+} // namespace Games
+} // namespace CardGameLib
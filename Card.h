@@ -1,18 +1,20 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
+#include <type_traits>
 
 namespace CardGameLib {
 namespace Core {
 
-enum class Suit {
+enum class Suit : uint8_t {
     HEARTS,
     DIAMONDS,
     CLUBS,
     SPADES
 };
 
-enum class Rank {
+enum class Rank : uint8_t {
     ACE = 1,
     TWO,
     THREE,
@@ -28,43 +30,139 @@ enum class Rank {
     KING
 };
 
-enum class Color {
+enum class Color : uint8_t {
     RED,
     BLACK
 };
 
+// A card packed into one byte: the rank (1-13) in bits 0-3, the suit in bits 4-5
+// and the face-up flag in bit 6. Cards are trivially copyable, so piles of them
+// can be copied with memcpy.
 class Card {
 public:
-    Card(Suit suit, Rank rank);
+    constexpr Card(Suit suit, Rank rank);
     
-    // Copy constructor and assignment operator
-    Card(const Card& other);
-    Card& operator=(const Card& other);
+    // A blank card (rank 0, not a valid face) so fixed-size arrays of cards can be
+    // declared and filled later
+    constexpr Card() : m_code(0) {}
+    constexpr bool IsBlank() const;
     
     // Card properties
-    Suit GetSuit() const;
-    Rank GetRank() const;
-    Color GetColor() const;
-    bool IsFaceUp() const;
+    constexpr Suit GetSuit() const;
+    constexpr Rank GetRank() const;
+    constexpr Color GetColor() const;
+    constexpr bool IsFaceUp() const;
     
     // Card actions
-    void Flip();
-    void SetFaceUp(bool faceUp);
+    constexpr void Flip();
+    constexpr void SetFaceUp(bool faceUp);
     
     // Utility functions
-    bool IsRed() const;
-    bool IsBlack() const;
+    constexpr bool IsRed() const;
+    constexpr bool IsBlack() const;
     std::string ToString() const;
     
-    // Comparison operators
-    bool operator==(const Card& other) const;
-    bool operator!=(const Card& other) const;
+    // Packed form (for binary snapshots). FromCode expects a valid code.
+    constexpr uint8_t GetCode() const;
+    static constexpr Card FromCode(uint8_t code);
+    
+    // Index of the face (0-51, ignoring the face-up flag)
+    constexpr int GetIndex() const;
+    
+    // Comparison operators (the face-up flag is ignored)
+    constexpr bool operator==(const Card& other) const;
+    constexpr bool operator!=(const Card& other) const;
+    
+    // Bit layout
+    static constexpr uint8_t RANK_MASK = 0x0F;
+    static constexpr int SUIT_SHIFT = 4;
+    static constexpr uint8_t SUIT_MASK = 0x30;
+    static constexpr uint8_t FACE_UP_BIT = 0x40;
     
 private:
-    Suit m_suit;
-    Rank m_rank;
-    bool m_faceUp;
+    explicit constexpr Card(uint8_t code) : m_code(code) {}
+    
+    uint8_t m_code;
 };
 
+static_assert(sizeof(Card) == 1, "Card must pack into one byte");
+static_assert(std::is_trivially_copyable<Card>::value, "Card must be trivially copyable");
+
+constexpr Card::Card(Suit suit, Rank rank)
+    : m_code(static_cast<uint8_t>(static_cast<uint8_t>(rank) | (static_cast<uint8_t>(suit) << SUIT_SHIFT)))
+{
+}
+
+constexpr Suit Card::GetSuit() const
+{
+    return static_cast<Suit>((m_code & SUIT_MASK) >> SUIT_SHIFT);
+}
+
+constexpr Rank Card::GetRank() const
+{
+    return static_cast<Rank>(m_code & RANK_MASK);
+}
+
+constexpr Color Card::GetColor() const
+{
+    // Hearts and diamonds are suits 0 and 1
+    return (m_code & (2 << SUIT_SHIFT)) == 0 ? Color::RED : Color::BLACK;
+}
+
+constexpr bool Card::IsBlank() const
+{
+    return m_code == 0;
+}
+
+constexpr bool Card::IsFaceUp() const
+{
+    return (m_code & FACE_UP_BIT) != 0;
+}
+
+constexpr void Card::Flip()
+{
+    m_code ^= FACE_UP_BIT;
+}
+
+constexpr void Card::SetFaceUp(bool faceUp)
+{
+    m_code = static_cast<uint8_t>(faceUp ? (m_code | FACE_UP_BIT) : (m_code & ~FACE_UP_BIT));
+}
+
+constexpr bool Card::IsRed() const
+{
+    return GetColor() == Color::RED;
+}
+
+constexpr bool Card::IsBlack() const
+{
+    return GetColor() == Color::BLACK;
+}
+
+constexpr uint8_t Card::GetCode() const
+{
+    return m_code;
+}
+
+constexpr Card Card::FromCode(uint8_t code)
+{
+    return Card(code);
+}
+
+constexpr int Card::GetIndex() const
+{
+    return static_cast<int>(GetSuit()) * 13 + static_cast<int>(GetRank()) - 1;
+}
+
+constexpr bool Card::operator==(const Card& other) const
+{
+    return ((m_code ^ other.m_code) & ~FACE_UP_BIT) == 0;
+}
+
+constexpr bool Card::operator!=(const Card& other) const
+{
+    return !(*this == other);
+}
+
 } // namespace Core
 } // namespace CardGameLib
@@ -0,0 +1,307 @@
+#include "core/DealIndex.h"
+#include <cstring>
+#include <fstream>
+
+#ifdef PLATFORM_WINDOWS
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace CardGameLib {
+namespace Core {
+
+namespace {
+    const char MAGIC[4] = { 'C', 'G', 'D', 'I' };
+    const size_t HEADER_SIZE = 16;
+    const size_t SECTION_SIZE = 48;
+    const uint64_t MAX_SECTION_DEALS = uint64_t(1) << 32;
+    
+    uint64_t LoadLE(const uint8_t* data, int bytes)
+    {
+        uint64_t value = 0;
+        for (int i = bytes - 1; i >= 0; --i) {
+            value = (value << 8) | data[i];
+        }
+        return value;
+    }
+    
+    void StoreLE(std::vector<uint8_t>& out, uint64_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; ++i) {
+            out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+    
+    size_t Align8(size_t size)
+    {
+        return (size + 7) & ~size_t(7);
+    }
+    
+    size_t BitsSize(uint64_t dealCount)
+    {
+        return static_cast<size_t>((dealCount + 63) / 64) * 8;
+    }
+}
+
+DealIndex::DealIndex()
+    : m_data(nullptr)
+    , m_size(0)
+#ifdef PLATFORM_WINDOWS
+    , m_file(INVALID_HANDLE_VALUE)
+    , m_mapping(nullptr)
+#endif
+{
+}
+
+DealIndex::~DealIndex()
+{
+    Close();
+}
+
+bool DealIndex::Open(const std::string& path)
+{
+    Close();
+
+#ifdef PLATFORM_WINDOWS
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0) {
+        Close();
+        return false;
+    }
+    
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        Close();
+        return false;
+    }
+    
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    
+    // The mapping stays valid after the descriptor is closed
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = static_cast<size_t>(info.st_size);
+#endif
+
+    if (!m_data || !Parse()) {
+        Close();
+        return false;
+    }
+    
+    return true;
+}
+
+void DealIndex::Close()
+{
+#ifdef PLATFORM_WINDOWS
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (m_data) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_sections.clear();
+}
+
+bool DealIndex::IsOpen() const
+{
+    return m_data != nullptr;
+}
+
+bool DealIndex::IsWinnable(GameType type, int variant, uint64_t dealNumber) const
+{
+    for (const SectionView& section : m_sections) {
+        if (section.type == type && section.variant == variant && dealNumber >= section.firstDeal &&
+            dealNumber - section.firstDeal < section.dealCount) {
+            uint64_t offset = dealNumber - section.firstDeal;
+            return (section.bits[offset / 8] >> (offset % 8)) & 1;
+        }
+    }
+    
+    return false;
+}
+
+uint64_t DealIndex::GetWinnableCount(GameType type, int variant) const
+{
+    uint64_t count = 0;
+    for (const SectionView& section : m_sections) {
+        if (section.type == type && section.variant == variant) {
+            count += section.winnableCount;
+        }
+    }
+    
+    return count;
+}
+
+bool DealIndex::Sample(GameType type, int variant, uint64_t random, uint64_t& dealNumber) const
+{
+    uint64_t count = GetWinnableCount(type, variant);
+    if (count == 0) {
+        return false;
+    }
+    
+    uint64_t pick = random % count;
+    for (const SectionView& section : m_sections) {
+        if (section.type != type || section.variant != variant) {
+            continue;
+        }
+        if (pick < section.winnableCount) {
+            dealNumber = section.firstDeal + LoadLE(section.list + pick * 4, 4);
+            return true;
+        }
+        pick -= section.winnableCount;
+    }
+    
+    return false;
+}
+
+bool DealIndex::Write(const std::string& path, const std::vector<Section>& sections)
+{
+    std::vector<uint8_t> out;
+    out.insert(out.end(), MAGIC, MAGIC + 4);
+    StoreLE(out, VERSION, 4);
+    StoreLE(out, sections.size(), 4);
+    StoreLE(out, 0, 4);
+    
+    // Section table first, then each section's bitset and list
+    size_t offset = HEADER_SIZE + SECTION_SIZE * sections.size();
+    std::vector<std::vector<uint32_t>> lists(sections.size());
+    
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const Section& section = sections[i];
+        if (section.dealCount > MAX_SECTION_DEALS || section.bits.size() * 64 < section.dealCount) {
+            return false;
+        }
+        
+        for (uint64_t deal = 0; deal < section.dealCount; ++deal) {
+            if ((section.bits[deal / 64] >> (deal % 64)) & 1) {
+                lists[i].push_back(static_cast<uint32_t>(deal));
+            }
+        }
+        
+        size_t bitsOffset = offset;
+        size_t listOffset = bitsOffset + BitsSize(section.dealCount);
+        offset = Align8(listOffset + lists[i].size() * 4);
+        
+        StoreLE(out, static_cast<uint8_t>(section.type), 1);
+        StoreLE(out, section.variant, 1);
+        StoreLE(out, 0, 6);
+        StoreLE(out, section.firstDeal, 8);
+        StoreLE(out, section.dealCount, 8);
+        StoreLE(out, lists[i].size(), 8);
+        StoreLE(out, bitsOffset, 8);
+        StoreLE(out, listOffset, 8);
+    }
+    
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const Section& section = sections[i];
+        for (size_t word = 0; word < BitsSize(section.dealCount) / 8; ++word) {
+            StoreLE(out, section.bits[word], 8);
+        }
+        for (uint32_t deal : lists[i]) {
+            StoreLE(out, deal, 4);
+        }
+        out.resize(Align8(out.size()), 0);
+    }
+    
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+    return file.good();
+}
+
+const DealIndex& DealIndex::GetDefault()
+{
+    return GetDefaultInstance();
+}
+
+bool DealIndex::LoadDefault(const std::string& path)
+{
+    return GetDefaultInstance().Open(path);
+}
+
+bool DealIndex::Parse()
+{
+    if (m_size < HEADER_SIZE || std::memcmp(m_data, MAGIC, 4) != 0 || LoadLE(m_data + 4, 4) != VERSION) {
+        return false;
+    }
+    
+    uint64_t sectionCount = LoadLE(m_data + 8, 4);
+    if (sectionCount > (m_size - HEADER_SIZE) / SECTION_SIZE) {
+        return false;
+    }
+    
+    for (uint64_t i = 0; i < sectionCount; ++i) {
+        const uint8_t* entry = m_data + HEADER_SIZE + i * SECTION_SIZE;
+        
+        SectionView section;
+        section.type = static_cast<GameType>(entry[0]);
+        section.variant = entry[1];
+        section.firstDeal = LoadLE(entry + 8, 8);
+        section.dealCount = LoadLE(entry + 16, 8);
+        section.winnableCount = LoadLE(entry + 24, 8);
+        uint64_t bitsOffset = LoadLE(entry + 32, 8);
+        uint64_t listOffset = LoadLE(entry + 40, 8);
+        
+        // Both arrays must lie inside the file
+        if (section.dealCount > MAX_SECTION_DEALS || section.winnableCount > section.dealCount ||
+            bitsOffset > m_size || BitsSize(section.dealCount) > m_size - bitsOffset ||
+            listOffset > m_size || section.winnableCount * 4 > m_size - listOffset) {
+            return false;
+        }
+        
+        section.bits = m_data + bitsOffset;
+        section.list = m_data + listOffset;
+        m_sections.push_back(section);
+    }
+    
+    return true;
+}
+
+DealIndex& DealIndex::GetDefaultInstance()
+{
+    static DealIndex index;
+    return index;
+}
+
+} // namespace Core
+} // namespace CardGameLib
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "core/Game.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace CardGameLib {
+namespace Core {
+
+// Winnable deal numbers, precomputed offline and read from a memory-mapped file.
+//
+// The file is a list of sections keyed by game type and variant (Spider's
+// difficulty, 0 for the other games). A section covers a run of deal numbers with
+// one bit per deal, so IsWinnable is a single bit test, followed by the winnable
+// deals as 32-bit offsets from the first deal, so Sample is a single array read.
+// All integers are little endian:
+//
+//   header   "CGDI", version u32, section count u32, reserved u32
+//   section  type u8, variant u8, reserved u16 + u32, first deal u64,
+//            deal count u64, winnable count u64, bits offset u64, list offset u64
+//   data     the bitsets and lists, 8-byte aligned, at their file offsets
+class DealIndex {
+public:
+    static constexpr uint32_t VERSION = 1;
+    
+    // A run of deals with their results, for writing an index
+    struct Section {
+        GameType type;
+        uint8_t variant;
+        uint64_t firstDeal;
+        uint64_t dealCount;
+        std::vector<uint64_t> bits;  // Bit i % 64 of word i / 64 is set if deal firstDeal + i is winnable
+    };
+    
+    DealIndex();
+    ~DealIndex();
+    
+    DealIndex(const DealIndex&) = delete;
+    DealIndex& operator=(const DealIndex&) = delete;
+    
+    // Map an index file read-only. Fails, leaving the index empty, if the file is
+    // missing or malformed.
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const;
+    
+    // True if the index lists the deal as winnable
+    bool IsWinnable(GameType type, int variant, uint64_t dealNumber) const;
+    
+    // Winnable deals listed for a game type and variant
+    uint64_t GetWinnableCount(GameType type, int variant) const;
+    
+    // The winnable deal a random value picks, uniformly over the listed ones.
+    // Fails if none are listed.
+    bool Sample(GameType type, int variant, uint64_t random, uint64_t& dealNumber) const;
+    
+    // Write sections to an index file (each covers at most 2^32 deals)
+    static bool Write(const std::string& path, const std::vector<Section>& sections);
+    
+    // Process-wide index the games sample from, empty until LoadDefault succeeds.
+    // Load it once at startup, before games are created.
+    static const DealIndex& GetDefault();
+    static bool LoadDefault(const std::string& path);
+    
+private:
+    struct SectionView {
+        GameType type;
+        int variant;
+        uint64_t firstDeal;
+        uint64_t dealCount;
+        uint64_t winnableCount;
+        const uint8_t* bits;
+        const uint8_t* list;
+    };
+    
+    const uint8_t* m_data;
+    size_t m_size;
+    std::vector<SectionView> m_sections;
+
+#ifdef PLATFORM_WINDOWS
+    void* m_file;
+    void* m_mapping;
+#endif
+
+    bool Parse();
+    
+    static DealIndex& GetDefaultInstance();
+};
+
+} // namespace Core
+} // namespace CardGameLib
@@ -0,0 +1,229 @@
+#include "games/solitaire/DealIndexBuilder.h"
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace CardGameLib {
+namespace Games {
+namespace Solitaire {
+
+namespace {
+    const uint64_t BLOCK_DEALS = 64;  // One bitset word, so threads never share a word
+    
+    bool ParseGameType(const std::string& name, Core::GameType& type)
+    {
+        if (name == "klondike") {
+            type = Core::GameType::SOLITAIRE_KLONDIKE;
+        } else if (name == "freecell") {
+            type = Core::GameType::SOLITAIRE_FREECELL;
+        } else if (name == "spider") {
+            type = Core::GameType::SOLITAIRE_SPIDER;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    
+    // game:variant:first:count
+    bool ParseSpec(const std::string& spec, std::string& name, Core::GameType& type, int& variant,
+                   uint64_t& firstDeal, uint64_t& dealCount)
+    {
+        std::string field;
+        std::vector<std::string> fields;
+        std::istringstream ss(spec);
+        while (std::getline(ss, field, ':')) {
+            fields.push_back(field);
+        }
+        
+        if (fields.size() != 4 || !ParseGameType(fields[0], type)) {
+            return false;
+        }
+        
+        try {
+            name = fields[0];
+            variant = std::stoi(fields[1]);
+            firstDeal = std::stoull(fields[2]);
+            dealCount = std::stoull(fields[3]);
+        } catch (const std::exception&) {
+            return false;
+        }
+        return dealCount > 0;
+    }
+}
+
+WinnabilityChecker::WinnabilityChecker(Core::GameType type, int variant, size_t nodeBudget)
+    : m_difficulty(static_cast<SpiderDifficulty>(variant))
+{
+    if (!IsSupported(type, variant)) {
+        return;
+    }
+    
+    switch (type) {
+        case Core::GameType::SOLITAIRE_KLONDIKE:
+            m_klondike.reset(new KlondikeSolver(nodeBudget > 0 ? nodeBudget : KlondikeSolver::BULK_NODE_BUDGET));
+            break;
+        
+        case Core::GameType::SOLITAIRE_FREECELL:
+            m_freeCell.reset(new FreeCellSolver(nodeBudget > 0 ? nodeBudget : FreeCellSolver::DEFAULT_NODE_BUDGET));
+            break;
+        
+        case Core::GameType::SOLITAIRE_SPIDER:
+            // The deals run on separate threads, so each search gets one, and no
+            // time budget so the result does not depend on the machine
+            m_spider.reset(new SpiderSolver(std::chrono::milliseconds(0), 1,
+                                            nodeBudget > 0 ? nodeBudget : SpiderSolver::BULK_NODE_BUDGET));
+            break;
+        
+        default:
+            break;
+    }
+}
+
+bool WinnabilityChecker::IsSupported(Core::GameType type, int variant)
+{
+    switch (type) {
+        case Core::GameType::SOLITAIRE_KLONDIKE:
+        case Core::GameType::SOLITAIRE_FREECELL:
+            return variant == 0;
+        
+        case Core::GameType::SOLITAIRE_SPIDER:
+            return variant >= 0 && variant <= static_cast<int>(SpiderDifficulty::FOUR_SUITS);
+        
+        default:
+            return false;
+    }
+}
+
+bool WinnabilityChecker::IsWinnable(uint64_t dealNumber)
+{
+    if (m_klondike) {
+        return m_klondike->SolveDeal(dealNumber) == SolveResult::SOLVED;
+    }
+    if (m_freeCell) {
+        return m_freeCell->SolveDeal(dealNumber) == SolveResult::SOLVED;
+    }
+    if (m_spider) {
+        return m_spider->SolveDeal(dealNumber, m_difficulty) == SolveResult::SOLVED;
+    }
+    return false;
+}
+
+bool DealIndexBuilder::BuildSection(Core::GameType type, int variant, uint64_t firstDeal, uint64_t dealCount,
+                                    int threadCount, Core::DealIndex::Section& section, size_t nodeBudget)
+{
+    if (!WinnabilityChecker::IsSupported(type, variant)) {
+        return false;
+    }
+    
+    section.type = type;
+    section.variant = static_cast<uint8_t>(variant);
+    section.firstDeal = firstDeal;
+    section.dealCount = dealCount;
+    section.bits.assign(static_cast<size_t>((dealCount + 63) / 64), 0);
+    
+    uint64_t blocks = (dealCount + BLOCK_DEALS - 1) / BLOCK_DEALS;
+    size_t threads = threadCount > 0 ? static_cast<size_t>(threadCount)
+                                     : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<size_t>(std::max<uint64_t>(1, std::min<uint64_t>(threads, blocks)));
+    
+    // Threads take the next block of deals, each with its own checker
+    std::atomic<uint64_t> next(0);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([&section, &next, type, variant, firstDeal, dealCount, blocks, nodeBudget]() {
+            WinnabilityChecker checker(type, variant, nodeBudget);
+            for (uint64_t block = next++; block < blocks; block = next++) {
+                uint64_t word = 0;
+                uint64_t end = std::min(dealCount, (block + 1) * BLOCK_DEALS);
+                for (uint64_t deal = block * BLOCK_DEALS; deal < end; ++deal) {
+                    if (checker.IsWinnable(firstDeal + deal)) {
+                        word |= uint64_t(1) << (deal % BLOCK_DEALS);
+                    }
+                }
+                section.bits[static_cast<size_t>(block)] = word;
+            }
+        });
+    }
+    
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    
+    return true;
+}
+
+int DealIndexBuilder::RunCommandLine(int argc, char** argv)
+{
+    size_t nodeBudget = 0;
+    if (argc >= 2 && std::string(argv[0]) == "--node-budget") {
+        try {
+            nodeBudget = static_cast<size_t>(std::stoull(argv[1]));
+        } catch (const std::exception&) {
+            std::cerr << "Invalid node budget: " << argv[1] << std::endl;
+            return 1;
+        }
+        argc -= 2;
+        argv += 2;
+    }
+    
+    if (argc < 2) {
+        std::cerr << "Usage: --build-deal-index [--node-budget <nodes>] <file> <game:variant:first:count>..." << std::endl;
+        std::cerr << "  game is klondike, freecell or spider; variant is 0, or Spider's difficulty (0-2)" << std::endl;
+        std::cerr << "  the node budget bounds each search (default " << KlondikeSolver::BULK_NODE_BUDGET << " for Klondike, "
+                  << FreeCellSolver::DEFAULT_NODE_BUDGET << " for FreeCell, " << SpiderSolver::BULK_NODE_BUDGET
+                  << " for Spider)" << std::endl;
+        return 1;
+    }
+    
+    std::vector<Core::DealIndex::Section> sections;
+    
+    for (int i = 1; i < argc; ++i) {
+        std::string name;
+        Core::GameType type = Core::GameType::SOLITAIRE_KLONDIKE;
+        int variant = 0;
+        uint64_t firstDeal = 0;
+        uint64_t dealCount = 0;
+        
+        if (!ParseSpec(argv[i], name, type, variant, firstDeal, dealCount)) {
+            std::cerr << "Invalid section: " << argv[i] << std::endl;
+            return 1;
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        Core::DealIndex::Section section;
+        if (!BuildSection(type, variant, firstDeal, dealCount, 0, section, nodeBudget)) {
+            std::cerr << "No solver for " << argv[i] << std::endl;
+            return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        uint64_t winnable = 0;
+        for (uint64_t word : section.bits) {
+            winnable += static_cast<uint64_t>(std::bitset<64>(word).count());
+        }
+        
+        std::cout << name << ":" << variant << " deals " << firstDeal << "-" << (firstDeal + dealCount - 1)
+                  << ": " << winnable << " winnable (" << (100.0 * winnable / dealCount) << "%) in "
+                  << seconds << " s" << std::endl;
+        
+        sections.push_back(std::move(section));
+    }
+    
+    if (!Core::DealIndex::Write(argv[0], sections)) {
+        std::cerr << "Failed to write " << argv[0] << std::endl;
+        return 1;
+    }
+    
+    std::cout << "Wrote " << argv[0] << std::endl;
+    return 0;
+}
+
+} // namespace Solitaire
+} // namespace Games
+} // namespace CardGameLib
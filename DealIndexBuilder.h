@@ -0,0 +1,54 @@
+#pragma once
+
+#include "core/DealIndex.h"
+#include "games/solitaire/KlondikeSolver.h"
+#include "games/solitaire/FreeCellSolver.h"
+#include "games/solitaire/SpiderSolver.h"
+
+#include <memory>
+#include <cstdint>
+
+namespace CardGameLib {
+namespace Games {
+namespace Solitaire {
+
+// Search-based winnability check for one solitaire game type and variant. A deal
+// counts as winnable only when the game's solver finds a win within its node
+// budget, so an index never lists a deal the solver gave up on, and the same
+// budget gives the same index on any machine. Each checker owns its solver; use
+// one per thread. A node budget of 0 picks the solver's bulk budget
+// (KlondikeSolver::BULK_NODE_BUDGET, FreeCellSolver::DEFAULT_NODE_BUDGET or
+// SpiderSolver::BULK_NODE_BUDGET).
+class WinnabilityChecker {
+public:
+    WinnabilityChecker(Core::GameType type, int variant, size_t nodeBudget = 0);
+    
+    // False for game types without a solver, or an unknown variant
+    static bool IsSupported(Core::GameType type, int variant);
+    
+    bool IsWinnable(uint64_t dealNumber);
+    
+private:
+    SpiderDifficulty m_difficulty;
+    std::unique_ptr<KlondikeSolver> m_klondike;
+    std::unique_ptr<FreeCellSolver> m_freeCell;
+    std::unique_ptr<SpiderSolver> m_spider;
+};
+
+// Offline builder for Core::DealIndex files
+class DealIndexBuilder {
+public:
+    // Check a run of deals on several threads (0 picks the hardware count), with
+    // WinnabilityChecker's node budget
+    static bool BuildSection(Core::GameType type, int variant, uint64_t firstDeal, uint64_t dealCount,
+                             int threadCount, Core::DealIndex::Section& section, size_t nodeBudget = 0);
+    
+    // Batch command line: optionally --node-budget <nodes>, then the output file,
+    // then one section per argument as game:variant:first:count (game is klondike,
+    // freecell or spider). Prints progress and returns a process exit code.
+    static int RunCommandLine(int argc, char** argv);
+};
+
+} // namespace Solitaire
+} // namespace Games
+} // namespace CardGameLib
@@ -0,0 +1,144 @@
+#include "DealerOdds.h"
+
+namespace CardGameLib {
+namespace Games {
+namespace Blackjack {
+
+namespace {
+    const int ACE_INDEX = 0;
+    const int TEN_INDEX = 9;
+}
+
+double DealerOdds::GetTotal(int value) const
+{
+    return (value >= 17 && value <= 21) ? total[value - 17] : 0.0;
+}
+
+DealerOddsCalculator::DealerOddsCalculator(const BlackjackRules& rules)
+    : m_rules(rules)
+{
+}
+
+DealerOdds DealerOddsCalculator::Compute(Core::Card upCard, const ShoeComposition& unseen)
+{
+    int upIndex = ShoeComposition::GetIndex(upCard);
+    uint64_t key = unseen.GetHash() ^ (static_cast<uint64_t>(upIndex + 1) * 0x9E3779B97F4A7C15ULL);
+    
+    auto it = m_cache.find(key);
+    if (it != m_cache.end() && it->second.upCard == upIndex && it->second.unseen == unseen) {
+        return it->second.odds;
+    }
+    
+    DealerOdds odds = Evaluate(upIndex, unseen, false);
+    
+    if (m_cache.size() >= MAX_CACHED) {
+        m_cache.clear();
+    }
+    m_cache[key] = CacheEntry{ upIndex, unseen, odds };
+    
+    return odds;
+}
+
+DealerOdds DealerOddsCalculator::ComputeInfinite(Core::Card upCard) const
+{
+    // One deck's proportions: one card of each value, four worth ten
+    ShoeComposition deck;
+    for (uint16_t& count : deck.counts) {
+        count = 1;
+    }
+    deck.counts[TEN_INDEX] = 4;
+    
+    return Evaluate(ShoeComposition::GetIndex(upCard), deck, true);
+}
+
+DealerOdds DealerOddsCalculator::Evaluate(int upIndex, ShoeComposition unseen, bool replace) const
+{
+    DealerOdds odds;
+    Draw(unseen, replace, upIndex + 1, upIndex == ACE_INDEX, 1, 1.0, odds);
+    
+    // Scale back up for the hands left out when the shoe ran out of cards
+    double sum = odds.bust + odds.blackjack;
+    for (double p : odds.total) {
+        sum += p;
+    }
+    
+    // A peeking dealer has already shown any blackjack, so players only act without one
+    if (m_rules.dealerPeeks && odds.blackjack < sum) {
+        sum -= odds.blackjack;
+        odds.blackjack = 0.0;
+    }
+    
+    if (sum > 0.0) {
+        double scale = 1.0 / sum;
+        for (double& p : odds.total) {
+            p *= scale;
+        }
+        odds.bust *= scale;
+        odds.blackjack *= scale;
+    }
+    
+    return odds;
+}
+
+void DealerOddsCalculator::Draw(ShoeComposition& unseen, bool replace, int hardTotal, bool hasAce, int cardCount,
+                                double probability, DealerOdds& odds) const
+{
+    if (hardTotal > 21) {
+        odds.bust += probability;
+        return;
+    }
+    
+    int value = (hasAce && hardTotal + 10 <= 21) ? hardTotal + 10 : hardTotal;
+    bool soft = value != hardTotal;
+    
+    if (cardCount == 2 && value == 21) {
+        odds.blackjack += probability;
+        return;
+    }
+    
+    if (cardCount >= 2 && (value > 17 || (value == 17 && !(soft && m_rules.dealerHitsSoft17)))) {
+        odds.total[value - 17] += probability;
+        return;
+    }
+    
+    // Hands that would empty the shoe drop out here; Evaluate scales the rest back up
+    int remaining = unseen.GetTotal();
+    if (remaining == 0) {
+        return;
+    }
+    
+    for (int index = ACE_INDEX; index <= TEN_INDEX; ++index) {
+        uint16_t count = unseen.counts[index];
+        if (count == 0) {
+            continue;
+        }
+        
+        if (!replace) {
+            unseen.counts[index]--;
+        }
+        Draw(unseen, replace, hardTotal + index + 1, hasAce || index == ACE_INDEX, cardCount + 1,
+             probability * count / remaining, odds);
+        if (!replace) {
+            unseen.counts[index]++;
+        }
+    }
+}
+
+void DealerOddsCalculator::ClearCache()
+{
+    m_cache.clear();
+}
+
+size_t DealerOddsCalculator::GetCacheSize() const
+{
+    return m_cache.size();
+}
+
+const BlackjackRules& DealerOddsCalculator::GetRules() const
+{
+    return m_rules;
+}
+
+} // namespace Blackjack
+} // namespace Games
+} // namespace CardGameLib
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "BlackjackRules.h"
+#include "Shoe.h"
+#include "../../core/Card.h"
+
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace CardGameLib {
+namespace Games {
+namespace Blackjack {
+
+// Distribution of the dealer's final hand. The probabilities sum to 1, except when
+// the dealer can't finish a hand from the cards left (say, an empty composition),
+// which gives all zeros.
+struct DealerOdds {
+    double total[5] = {};   // Final totals 17-21 that are not a natural
+    double bust = 0.0;
+    double blackjack = 0.0;
+    
+    // Probability of finishing on a total from 17 to 21 (0 otherwise)
+    double GetTotal(int value) const;
+};
+
+// Exact dealer outcome probabilities for a finite or an infinite shoe.
+//
+// Every order in which the dealer can draw from the unseen cards is followed, with
+// each draw weighted by the cards of that value left, so the result accounts for
+// the exact composition. For an infinite shoe the same draws are made with
+// replacement from one deck's proportions. Hands that would need more cards than a
+// finite composition holds are left out (the game reshuffles there) and the rest
+// scaled back up to sum to 1. Finite results are memoized by up card and
+// composition hash: repeated queries within a round are a hash lookup.
+class DealerOddsCalculator {
+public:
+    // Cached results kept before the cache is cleared
+    static constexpr size_t MAX_CACHED = 1024;
+    
+    explicit DealerOddsCalculator(const BlackjackRules& rules = BlackjackRules());
+    
+    // Odds for a dealer up card with the given cards still unseen (the up card must
+    // not be among them, the hole card must).
+    DealerOdds Compute(Core::Card upCard, const ShoeComposition& unseen);
+    
+    // Odds for a dealer up card with every value drawn at its single-deck frequency
+    // (the infinite shoe basic strategy assumes)
+    DealerOdds ComputeInfinite(Core::Card upCard) const;
+    
+    // Cache management
+    void ClearCache();
+    size_t GetCacheSize() const;
+    
+    const BlackjackRules& GetRules() const;
+    
+private:
+    struct CacheEntry {
+        int upCard;
+        ShoeComposition unseen;
+        DealerOdds odds;
+    };
+    
+    BlackjackRules m_rules;
+    std::unordered_map<uint64_t, CacheEntry> m_cache;
+    
+    // Odds from an up card, drawing from unseen with or without replacement
+    DealerOdds Evaluate(int upIndex, ShoeComposition unseen, bool replace) const;
+    
+    // Follow every draw from a hand, adding the probability of each final hand to odds
+    void Draw(ShoeComposition& unseen, bool replace, int hardTotal, bool hasAce, int cardCount,
+              double probability, DealerOdds& odds) const;
+};
+
+} // namespace Blackjack
+} // namespace Games
+} // namespace CardGameLib
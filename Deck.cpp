@@ -1,29 +1,42 @@
 #include "core/Deck.h"
 #include <algorithm>
 #include <stdexcept>
-#include <chrono>
 
 namespace CardGameLib {
 namespace Core {
 
 Deck::Deck()
-    : m_rng(std::chrono::system_clock::now().time_since_epoch().count())
+    : m_rng(Rng::RandomSeed())
 {
     InitializeStandardDeck(1);
 }
 
 Deck::Deck(int numberOfDecks)
-    : m_rng(std::chrono::system_clock::now().time_since_epoch().count())
+    : m_rng(Rng::RandomSeed())
 {
     InitializeStandardDeck(numberOfDecks);
 }
 
 Deck::Deck(const std::vector<Card>& cards)
     : m_cards(cards)
-    , m_rng(std::chrono::system_clock::now().time_since_epoch().count())
+    , m_rng(Rng::RandomSeed())
 {
 }
 
+Deck::Deck(int numberOfDecks, uint64_t dealNumber)
+    : m_rng(dealNumber)
+{
+    InitializeStandardDeck(numberOfDecks);
+    Shuffle();
+}
+
+Deck::Deck(const std::vector<Card>& cards, uint64_t dealNumber)
+    : m_cards(cards)
+    , m_rng(dealNumber)
+{
+    Shuffle();
+}
+
 Deck Deck::CreateEmpty()
 {
     return Deck(std::vector<Card>());
@@ -32,6 +45,7 @@ Deck Deck::CreateEmpty()
 void Deck::InitializeStandardDeck(int numberOfDecks)
 {
     m_cards.clear();
+    m_cards.reserve(static_cast<size_t>(numberOfDecks) * 52);
     
     for (int deckIndex = 0; deckIndex < numberOfDecks; ++deckIndex) {
         for (int suit = 0; suit < 4; ++suit) {
@@ -44,7 +58,17 @@ void Deck::InitializeStandardDeck(int numberOfDecks)
 
 void Deck::Shuffle()
 {
-    std::shuffle(m_cards.begin(), m_cards.end(), m_rng);
+    Shuffle(m_rng);
+}
+
+void Deck::Shuffle(Rng& rng)
+{
+    // Fisher-Yates. std::shuffle's order differs between standard libraries, which
+    // would make numbered deals unportable.
+    for (size_t i = m_cards.size(); i > 1; --i) {
+        size_t j = rng.NextBelow(static_cast<uint32_t>(i));
+        std::swap(m_cards[i - 1], m_cards[j]);
+    }
 }
 
 Card Deck::Draw()
@@ -106,5 +130,10 @@ const std::vector<Card>& Deck::GetCards() const
     return m_cards;
 }
 
+std::vector<Card>& Deck::GetCards()
+{
+    return m_cards;
+}
+
 } // namespace Core
 } // namespace CardGameLib
@@ -2,8 +2,9 @@
 
 #include <vector>
 #include <memory>
-#include <random>
+#include <cstdint>
 #include "core/Card.h"
+#include "core/Rng.h"
 
 namespace CardGameLib {
 namespace Core {
@@ -19,11 +20,17 @@ public:
     // Create a custom deck from a list of cards
     explicit Deck(const std::vector<Card>& cards);
     
+    // Create a shuffled deck for a numbered deal. The same deal number always gives the
+    // same order, and so do any later shuffles of the deck.
+    Deck(int numberOfDecks, uint64_t dealNumber);
+    Deck(const std::vector<Card>& cards, uint64_t dealNumber);
+    
     // Create an empty deck
     static Deck CreateEmpty();
     
     // Deck operations
     void Shuffle();
+    void Shuffle(Rng& rng);
     Card Draw();
     bool IsEmpty() const;
     size_t Size() const;
@@ -36,9 +43,12 @@ public:
     const Card& PeekAt(size_t index) const;
     const std::vector<Card>& GetCards() const;
     
+    // Direct access for games that use the deck as a pile
+    std::vector<Card>& GetCards();
+    
 private:
     std::vector<Card> m_cards;
-    std::mt19937 m_rng;
+    Rng m_rng;
     
     void InitializeStandardDeck(int numberOfDecks);
 };
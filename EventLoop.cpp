@@ -0,0 +1,286 @@
+#include "network/EventLoop.h"
+#include <cerrno>
+
+#ifndef PLATFORM_WINDOWS
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+#endif
+
+namespace CardGameLib {
+namespace Network {
+
+#ifndef PLATFORM_WINDOWS
+namespace {
+
+uint32_t ToEpollEvents(uint32_t flags)
+{
+    // Always edge-triggered; peer hang-ups are reported with the read event
+    uint32_t events = EPOLLET | EPOLLRDHUP;
+    if (flags & EVENT_READ) {
+        events |= EPOLLIN;
+    }
+    if (flags & EVENT_WRITE) {
+        events |= EPOLLOUT;
+    }
+    return events;
+}
+
+uint32_t FromEpollEvents(uint32_t events)
+{
+    uint32_t flags = EVENT_NONE;
+    if (events & (EPOLLIN | EPOLLRDHUP)) {
+        flags |= EVENT_READ;
+    }
+    if (events & EPOLLOUT) {
+        flags |= EVENT_WRITE;
+    }
+    if (events & (EPOLLERR | EPOLLHUP)) {
+        flags |= EVENT_ERROR;
+    }
+    return flags;
+}
+
+} // namespace
+#endif
+
+#ifdef PLATFORM_WINDOWS
+EventLoop::EventLoop()
+    : m_created(false)
+{
+}
+#else
+EventLoop::EventLoop()
+    : m_epollHandle(-1)
+    , m_wakeupHandle(-1)
+{
+}
+#endif
+
+EventLoop::~EventLoop()
+{
+    Close();
+}
+
+bool EventLoop::Create()
+{
+    Close();
+
+#ifdef PLATFORM_WINDOWS
+    m_created = true;
+    return true;
+#else
+    m_epollHandle = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeupHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    
+    if (m_epollHandle == -1 || m_wakeupHandle == -1) {
+        Close();
+        return false;
+    }
+    
+    // The wakeup handle is level-triggered and drained by Wait
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = 0;
+    event.data.fd = m_wakeupHandle;
+    
+    if (epoll_ctl(m_epollHandle, EPOLL_CTL_ADD, m_wakeupHandle, &event) == -1) {
+        Close();
+        return false;
+    }
+    
+    return true;
+#endif
+}
+
+void EventLoop::Close()
+{
+#ifdef PLATFORM_WINDOWS
+    std::lock_guard<std::mutex> lock(m_interestMutex);
+    m_interest.clear();
+    m_created = false;
+#else
+    if (m_wakeupHandle != -1) {
+        close(m_wakeupHandle);
+        m_wakeupHandle = -1;
+    }
+    
+    if (m_epollHandle != -1) {
+        close(m_epollHandle);
+        m_epollHandle = -1;
+    }
+#endif
+}
+
+bool EventLoop::IsValid() const
+{
+#ifdef PLATFORM_WINDOWS
+    return m_created;
+#else
+    return m_epollHandle != -1;
+#endif
+}
+
+bool EventLoop::Add(SocketHandle handle, uint32_t flags)
+{
+    if (!IsValid() || handle == INVALID_SOCKET_HANDLE) {
+        return false;
+    }
+
+#ifdef PLATFORM_WINDOWS
+    std::lock_guard<std::mutex> lock(m_interestMutex);
+    return m_interest.emplace(handle, flags).second;
+#else
+    epoll_event event;
+    event.events = ToEpollEvents(flags);
+    event.data.u64 = 0;
+    event.data.fd = handle;
+    return epoll_ctl(m_epollHandle, EPOLL_CTL_ADD, handle, &event) != -1;
+#endif
+}
+
+bool EventLoop::Modify(SocketHandle handle, uint32_t flags)
+{
+    if (!IsValid() || handle == INVALID_SOCKET_HANDLE) {
+        return false;
+    }
+
+#ifdef PLATFORM_WINDOWS
+    std::lock_guard<std::mutex> lock(m_interestMutex);
+    auto it = m_interest.find(handle);
+    if (it == m_interest.end()) {
+        return false;
+    }
+    it->second = flags;
+    return true;
+#else
+    epoll_event event;
+    event.events = ToEpollEvents(flags);
+    event.data.u64 = 0;
+    event.data.fd = handle;
+    return epoll_ctl(m_epollHandle, EPOLL_CTL_MOD, handle, &event) != -1;
+#endif
+}
+
+bool EventLoop::Remove(SocketHandle handle)
+{
+    if (!IsValid() || handle == INVALID_SOCKET_HANDLE) {
+        return false;
+    }
+
+#ifdef PLATFORM_WINDOWS
+    std::lock_guard<std::mutex> lock(m_interestMutex);
+    return m_interest.erase(handle) > 0;
+#else
+    // A non-null event pointer keeps pre-2.6.9 kernels happy
+    epoll_event event = {};
+    return epoll_ctl(m_epollHandle, EPOLL_CTL_DEL, handle, &event) != -1;
+#endif
+}
+
+int EventLoop::Wait(std::vector<SocketEvent>& events, double timeoutSeconds)
+{
+    events.clear();
+    
+    if (!IsValid()) {
+        return -1;
+    }
+
+#ifdef PLATFORM_WINDOWS
+    // Level-triggered fallback; FD_SETSIZE bounds the number of sockets
+    fd_set readSet, writeSet, errorSet;
+    FD_ZERO(&readSet);
+    FD_ZERO(&writeSet);
+    FD_ZERO(&errorSet);
+    
+    std::vector<std::pair<SocketHandle, uint32_t>> registered;
+    {
+        std::lock_guard<std::mutex> lock(m_interestMutex);
+        registered.assign(m_interest.begin(), m_interest.end());
+    }
+    
+    if (registered.empty()) {
+        return 0;
+    }
+    
+    for (const auto& entry : registered) {
+        if (entry.second & EVENT_READ) {
+            FD_SET(entry.first, &readSet);
+        }
+        if (entry.second & EVENT_WRITE) {
+            FD_SET(entry.first, &writeSet);
+        }
+        FD_SET(entry.first, &errorSet);
+    }
+    
+    if (timeoutSeconds < 0 || timeoutSeconds > MAX_FALLBACK_WAIT_SECONDS) {
+        timeoutSeconds = MAX_FALLBACK_WAIT_SECONDS;
+    }
+    
+    struct timeval timeout;
+    timeout.tv_sec = static_cast<long>(timeoutSeconds);
+    timeout.tv_usec = static_cast<long>((timeoutSeconds - timeout.tv_sec) * 1000000);
+    
+    int result = select(0, &readSet, &writeSet, &errorSet, &timeout);
+    if (result <= 0) {
+        return result < 0 ? -1 : 0;
+    }
+    
+    for (const auto& entry : registered) {
+        uint32_t flags = EVENT_NONE;
+        if (FD_ISSET(entry.first, &readSet)) {
+            flags |= EVENT_READ;
+        }
+        if (FD_ISSET(entry.first, &writeSet)) {
+            flags |= EVENT_WRITE;
+        }
+        if (FD_ISSET(entry.first, &errorSet)) {
+            flags |= EVENT_ERROR;
+        }
+        if (flags != EVENT_NONE) {
+            events.push_back({ entry.first, flags });
+        }
+    }
+    
+    return static_cast<int>(events.size());
+#else
+    epoll_event ready[MAX_EVENTS_PER_WAIT];
+    int timeoutMs = timeoutSeconds < 0 ? -1 : static_cast<int>(timeoutSeconds * 1000);
+    
+    int result = epoll_wait(m_epollHandle, ready, MAX_EVENTS_PER_WAIT, timeoutMs);
+    if (result <= 0) {
+        // EINTR is treated as a timeout
+        return result < 0 && errno != EINTR ? -1 : 0;
+    }
+    
+    events.reserve(result);
+    for (int i = 0; i < result; ++i) {
+        if (ready[i].data.fd == m_wakeupHandle) {
+            // Reset the wakeup counter; the caller just sees an early return
+            uint64_t counter;
+            while (read(m_wakeupHandle, &counter, sizeof(counter)) > 0) {
+            }
+            continue;
+        }
+        
+        events.push_back({ ready[i].data.fd, FromEpollEvents(ready[i].events) });
+    }
+    
+    return static_cast<int>(events.size());
+#endif
+}
+
+void EventLoop::Wakeup()
+{
+#ifdef PLATFORM_WINDOWS
+    // Fallback waits are short enough to pick up new work on their own
+#else
+    if (m_wakeupHandle != -1) {
+        uint64_t increment = 1;
+        ssize_t result = write(m_wakeupHandle, &increment, sizeof(increment));
+        (void)result;
+    }
+#endif
+}
+
+} // namespace Network
+} // namespace CardGameLib
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "network/Socket.h"
+
+#ifdef PLATFORM_WINDOWS
+    #include <unordered_map>
+    #include <mutex>
+#endif
+
+namespace CardGameLib {
+namespace Network {
+
+// Readiness flags for registered sockets
+enum EventFlags : uint32_t {
+    EVENT_NONE  = 0,
+    EVENT_READ  = 1 << 0,
+    EVENT_WRITE = 1 << 1,
+    EVENT_ERROR = 1 << 2   // Hang-up or socket error (reported only)
+};
+
+// A readiness notification for a single socket
+struct SocketEvent {
+    SocketHandle handle;
+    uint32_t flags;
+};
+
+// Readiness multiplexer for large numbers of sockets.
+// On Linux this is an edge-triggered epoll set: a socket is reported once each
+// time it becomes ready, so callers must drain it until the operation would block.
+// Other platforms fall back to select() over the registered handles.
+class EventLoop {
+public:
+    EventLoop();
+    ~EventLoop();
+    
+    // Create and destroy the underlying poller
+    bool Create();
+    void Close();
+    bool IsValid() const;
+    
+    // Register, update or unregister a socket (thread-safe)
+    bool Add(SocketHandle handle, uint32_t flags);
+    bool Modify(SocketHandle handle, uint32_t flags);
+    bool Remove(SocketHandle handle);
+    
+    // Wait for readiness. Fills events and returns the number of ready sockets,
+    // 0 on timeout or -1 on error. A negative timeout waits indefinitely.
+    int Wait(std::vector<SocketEvent>& events, double timeoutSeconds);
+    
+    // Make a concurrent or upcoming Wait return early (thread-safe)
+    void Wakeup();
+    
+    // Maximum number of events returned by a single Wait
+    static constexpr int MAX_EVENTS_PER_WAIT = 256;
+    
+private:
+#ifdef PLATFORM_WINDOWS
+    // Longest a fallback Wait blocks, since Wakeup cannot interrupt select()
+    static constexpr double MAX_FALLBACK_WAIT_SECONDS = 0.005;
+    
+    bool m_created;
+    std::unordered_map<SocketHandle, uint32_t> m_interest;
+    std::mutex m_interestMutex;
+#else
+    int m_epollHandle;
+    int m_wakeupHandle;  // eventfd signalled by Wakeup
+#endif
+};
+
+} // namespace Network
+} // namespace CardGameLib
@@ -0,0 +1,118 @@
+#include "network/FrameDecoder.h"
+#include <cstring>
+
+namespace CardGameLib {
+namespace Network {
+
+FrameDecoder::FrameDecoder(size_t maxFrameSize)
+    : m_readPos(0)
+    , m_writePos(0)
+    , m_maxFrameSize(maxFrameSize)
+    , m_error(false)
+{
+}
+
+char* FrameDecoder::PrepareWrite(size_t minSize, size_t& available)
+{
+    if (m_buffer.size() - m_writePos < minSize) {
+        size_t pending = m_writePos - m_readPos;
+        
+        // Reclaim consumed space by moving the unread tail to the front
+        if (m_readPos > 0) {
+            if (pending > 0) {
+                std::memmove(m_buffer.data(), m_buffer.data() + m_readPos, pending);
+            }
+            m_readPos = 0;
+            m_writePos = pending;
+        }
+        
+        // Grow geometrically if that still isn't enough
+        if (m_buffer.size() - m_writePos < minSize) {
+            size_t newSize = m_buffer.empty() ? minSize : m_buffer.size();
+            while (newSize - m_writePos < minSize) {
+                newSize *= 2;
+            }
+            m_buffer.resize(newSize);
+        }
+    }
+    
+    available = m_buffer.size() - m_writePos;
+    return m_buffer.data() + m_writePos;
+}
+
+void FrameDecoder::CommitWrite(size_t size)
+{
+    m_writePos += size;
+}
+
+bool FrameDecoder::NextFrame(std::string_view& frame)
+{
+    if (m_error) {
+        return false;
+    }
+    
+    size_t pending = m_writePos - m_readPos;
+    if (pending < HEADER_SIZE) {
+        return false;
+    }
+    
+    const char* header = m_buffer.data() + m_readPos;
+    uint32_t length = DecodeHeader(header);
+    
+    if (length > m_maxFrameSize) {
+        m_error = true;
+        return false;
+    }
+    
+    if (pending - HEADER_SIZE < length) {
+        return false;
+    }
+    
+    frame = std::string_view(header + HEADER_SIZE, length);
+    m_readPos += HEADER_SIZE + length;
+    
+    // Rewind for free once everything has been consumed
+    if (m_readPos == m_writePos) {
+        m_readPos = 0;
+        m_writePos = 0;
+    }
+    
+    return true;
+}
+
+bool FrameDecoder::HasError() const
+{
+    return m_error;
+}
+
+size_t FrameDecoder::BufferedBytes() const
+{
+    return m_writePos - m_readPos;
+}
+
+void FrameDecoder::Reset()
+{
+    m_readPos = 0;
+    m_writePos = 0;
+    m_error = false;
+}
+
+void FrameDecoder::EncodeHeader(uint32_t length, char* header)
+{
+    // Network byte order (big endian)
+    header[0] = static_cast<char>((length >> 24) & 0xFF);
+    header[1] = static_cast<char>((length >> 16) & 0xFF);
+    header[2] = static_cast<char>((length >> 8) & 0xFF);
+    header[3] = static_cast<char>(length & 0xFF);
+}
+
+uint32_t FrameDecoder::DecodeHeader(const char* header)
+{
+    return (static_cast<uint32_t>(header[0] & 0xFF) << 24) |
+           (static_cast<uint32_t>(header[1] & 0xFF) << 16) |
+           (static_cast<uint32_t>(header[2] & 0xFF) << 8) |
+           (static_cast<uint32_t>(header[3] & 0xFF));
+}
+
+} // namespace Network
+} // namespace CardGameLib
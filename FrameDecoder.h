@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace CardGameLib {
+namespace Network {
+
+// Streaming decoder for length-prefixed frames (4-byte big-endian length, then payload).
+//
+// Bytes are received straight into the decoder's buffer, and every complete frame in it
+// is handed out as a view into that buffer. Consumed bytes are reclaimed lazily: when
+// the free space at the end runs short, the unread tail is moved back to the front
+// (growing the buffer if a single frame needs more room), so a frame never straddles
+// the end of the buffer and can always be returned without copying.
+class FrameDecoder {
+public:
+    // Size of the length prefix on every frame
+    static constexpr size_t HEADER_SIZE = 4;
+    
+    // Frames larger than this are treated as a protocol error
+    static constexpr size_t DEFAULT_MAX_FRAME_SIZE = 16 * 1024 * 1024;
+    
+    explicit FrameDecoder(size_t maxFrameSize = DEFAULT_MAX_FRAME_SIZE);
+    
+    // Get writable space for the next receive. At least minSize bytes are
+    // available on return; all free space is reported through available.
+    // Invalidates views returned by NextFrame.
+    char* PrepareWrite(size_t minSize, size_t& available);
+    
+    // Mark size bytes written by the last PrepareWrite as received
+    void CommitWrite(size_t size);
+    
+    // Extract the next complete frame. The view stays valid until the next PrepareWrite.
+    bool NextFrame(std::string_view& frame);
+    
+    // True once a frame header exceeded the maximum frame size
+    bool HasError() const;
+    
+    // Number of received bytes not yet returned as frames
+    size_t BufferedBytes() const;
+    
+    // Drop all buffered data and clear the error state
+    void Reset();
+    
+    // Frame header helpers
+    static void EncodeHeader(uint32_t length, char* header);
+    static uint32_t DecodeHeader(const char* header);
+    
+private:
+    std::vector<char> m_buffer;
+    size_t m_readPos;
+    size_t m_writePos;
+    size_t m_maxFrameSize;
+    bool m_error;
+};
+
+} // namespace Network
+} // namespace CardGameLib
@@ -7,13 +7,10 @@ namespace CardGameLib {
 namespace Games {
 namespace Solitaire {
 
-FreeCell::FreeCell()
+FreeCell::FreeCell(bool winnableDealsOnly)
     : Core::Game("FreeCell", Core::GameType::SOLITAIRE_FREECELL, 1)
 {
-    // Initialize free cells to nullptr
-    for (auto& cell : m_freeCells) {
-        cell = nullptr;
-    }
+    SetWinnableDealsOnly(winnableDealsOnly);
 }
 
 void FreeCell::Initialize()
@@ -27,8 +24,18 @@ bool FreeCell::Start()
         return false;
     }
     
+    // A deal number set since the last Reset takes effect now
+    if (m_dealNumberSet) {
+        Reset();
+    }
+    
     SetState(Core::GameState::STARTING);
-    DealInitialLayout();
+    
+    // After Deal (or a loaded position) the cards are already out
+    if (!IsLayoutDealt()) {
+        DealInitialLayout();
+    }
+    
     SetState(Core::GameState::IN_PROGRESS);
     return true;
 }
@@ -41,11 +48,8 @@ bool FreeCell::CanStart() const
 
 void FreeCell::Reset()
 {
-    // Clean up any cards in free cells
-    for (auto& cell : m_freeCells) {
-        delete cell;
-        cell = nullptr;
-    }
+    // Empty the free cells
+    m_freeCells.fill(Core::Card());
     
     // Clear all other piles
     for (auto& foundation : m_foundations) {
@@ -56,177 +60,253 @@ void FreeCell::Reset()
         pile.clear();
     }
     
+    m_positionHash = ComputePositionHash();
+    
     SetState(Core::GameState::WAITING_FOR_PLAYERS);
 }
 
-bool FreeCell::IsValidMove(const std::string& moveData)
+void FreeCell::Deal(uint64_t dealNumber)
 {
-    std::istringstream ss(moveData);
-    std::string moveTypeStr;
-    ss >> moveTypeStr;
+    SetDealNumber(dealNumber);
+    Reset();
+    DealInitialLayout();
+}
+
+void FreeCell::DealMicrosoft(uint32_t gameNumber)
+{
+    Reset();
     
-    try {
-        FreeCellMoveType moveType = static_cast<FreeCellMoveType>(std::stoi(moveTypeStr));
-        
-        switch (moveType) {
-            case FreeCellMoveType::TABLEAU_TO_FREECELL: {
-                int tableauIndex, freeCellIndex;
-                ss >> tableauIndex >> freeCellIndex;
-                
-                if (tableauIndex < 0 || tableauIndex >= 8 || 
-                    freeCellIndex < 0 || freeCellIndex >= 4 || 
-                    m_tableau[tableauIndex].empty() || 
-                    m_freeCells[freeCellIndex] != nullptr) {
-                    return false;
-                }
-                
-                return true;
+    // Cards numbered rank-major in club, diamond, heart, spade order, dealt from the
+    // highest number down and shuffled with the C runtime's rand()
+    static const Core::Suit suits[4] = { Core::Suit::CLUBS, Core::Suit::DIAMONDS,
+                                         Core::Suit::HEARTS, Core::Suit::SPADES };
+    
+    int cards[52];
+    for (int i = 0; i < 52; ++i) {
+        cards[i] = 51 - i;
+    }
+    
+    uint32_t seed = gameNumber;
+    for (int i = 0; i < 51; ++i) {
+        seed = (seed * 214013u + 2531011u) & 0x7FFFFFFFu;
+        int j = 51 - static_cast<int>((seed >> 16) % static_cast<uint32_t>(52 - i));
+        std::swap(cards[i], cards[j]);
+    }
+    
+    for (int i = 0; i < 52; ++i) {
+        Core::Card card(suits[cards[i] % 4], static_cast<Core::Rank>(cards[i] / 4 + 1));
+        card.SetFaceUp(true);
+        m_tableau[i % 8].push_back(card);
+    }
+    
+    m_journal.Clear();
+    m_positionHash = ComputePositionHash();
+}
+
+bool FreeCell::IsValidMove(const Core::Move& move)
+{
+    switch (static_cast<FreeCellMoveType>(move.type)) {
+        case FreeCellMoveType::TABLEAU_TO_FREECELL: {
+            int tableauIndex = move.args[0];
+            int freeCellIndex = move.args[1];
+            
+            if (tableauIndex >= 8 || freeCellIndex >= 4 || 
+                m_tableau[tableauIndex].empty() || 
+                !m_freeCells[freeCellIndex].IsBlank()) {
+                return false;
             }
-                
-            case FreeCellMoveType::TABLEAU_TO_FOUNDATION: {
-                int tableauIndex, foundationIndex;
-                ss >> tableauIndex >> foundationIndex;
-                
-                if (tableauIndex < 0 || tableauIndex >= 8 || 
-                    foundationIndex < 0 || foundationIndex >= 4 || 
-                    m_tableau[tableauIndex].empty()) {
-                    return false;
-                }
-                
-                const Core::Card& card = m_tableau[tableauIndex].back();
-                return IsValidCardForFoundation(card, m_foundations[foundationIndex]);
+            
+            return true;
+        }
+            
+        case FreeCellMoveType::TABLEAU_TO_FOUNDATION: {
+            int tableauIndex = move.args[0];
+            int foundationIndex = move.args[1];
+            
+            if (tableauIndex >= 8 || foundationIndex >= 4 || m_tableau[tableauIndex].empty()) {
+                return false;
             }
-                
-            case FreeCellMoveType::TABLEAU_TO_TABLEAU: {
-                int sourceIndex, targetIndex, cardCount;
-                ss >> sourceIndex >> targetIndex >> cardCount;
-                
-                if (sourceIndex < 0 || sourceIndex >= 8 || 
-                    targetIndex < 0 || targetIndex >= 8 || 
-                    sourceIndex == targetIndex || 
-                    m_tableau[sourceIndex].empty() || 
-                    cardCount <= 0 || 
-                    cardCount > static_cast<int>(m_tableau[sourceIndex].size()) ||
-                    cardCount > GetMaxMovableCards()) {
-                    return false;
-                }
-                
-                // Check if the specified sequence is valid (descending alternating colors)
-                for (int i = 1; i < cardCount; ++i) {
-                    size_t cardIndex = m_tableau[sourceIndex].size() - cardCount + i;
-                    size_t prevCardIndex = cardIndex - 1;
-                    
-                    const Core::Card& card = m_tableau[sourceIndex][cardIndex];
-                    const Core::Card& prevCard = m_tableau[sourceIndex][prevCardIndex];
-                    
-                    if (card.GetColor() == prevCard.GetColor() || 
-                        static_cast<int>(card.GetRank()) != static_cast<int>(prevCard.GetRank()) - 1) {
-                        return false;
-                    }
-                }
-                
-                // Get the first card to move
-                size_t cardIndex = m_tableau[sourceIndex].size() - cardCount;
-                const Core::Card& card = m_tableau[sourceIndex][cardIndex];
-                
-                return IsValidTableauToTableauMove(card, m_tableau[targetIndex]);
+            
+            const Core::Card& card = m_tableau[tableauIndex].back();
+            return IsValidCardForFoundation(card, m_foundations[foundationIndex]);
+        }
+            
+        case FreeCellMoveType::TABLEAU_TO_TABLEAU: {
+            int sourceIndex = move.args[0];
+            int targetIndex = move.args[1];
+            int cardCount = move.args[2];
+            
+            if (sourceIndex >= 8 || targetIndex >= 8 || 
+                sourceIndex == targetIndex || 
+                m_tableau[sourceIndex].empty() || 
+                cardCount <= 0 || 
+                cardCount > static_cast<int>(m_tableau[sourceIndex].size()) ||
+                cardCount > GetMaxMovableCards()) {
+                return false;
             }
+            
+            // Check if the specified sequence is valid (descending alternating colors)
+            for (int i = 1; i < cardCount; ++i) {
+                size_t cardIndex = m_tableau[sourceIndex].size() - cardCount + i;
+                size_t prevCardIndex = cardIndex - 1;
                 
-            case FreeCellMoveType::FREECELL_TO_FOUNDATION: {
-                int freeCellIndex, foundationIndex;
-                ss >> freeCellIndex >> foundationIndex;
+                const Core::Card& card = m_tableau[sourceIndex][cardIndex];
+                const Core::Card& prevCard = m_tableau[sourceIndex][prevCardIndex];
                 
-                if (freeCellIndex < 0 || freeCellIndex >= 4 || 
-                    foundationIndex < 0 || foundationIndex >= 4 || 
-                    m_freeCells[freeCellIndex] == nullptr) {
+                if (card.GetColor() == prevCard.GetColor() || 
+                    static_cast<int>(card.GetRank()) != static_cast<int>(prevCard.GetRank()) - 1) {
                     return false;
                 }
-                
-                const Core::Card& card = *m_freeCells[freeCellIndex];
-                return IsValidCardForFoundation(card, m_foundations[foundationIndex]);
             }
-                
-            case FreeCellMoveType::FREECELL_TO_TABLEAU: {
-                int freeCellIndex, tableauIndex;
-                ss >> freeCellIndex >> tableauIndex;
-                
-                if (freeCellIndex < 0 || freeCellIndex >= 4 || 
-                    tableauIndex < 0 || tableauIndex >= 8 || 
-                    m_freeCells[freeCellIndex] == nullptr) {
-                    return false;
-                }
-                
-                const Core::Card& card = *m_freeCells[freeCellIndex];
-                return IsValidTableauToTableauMove(card, m_tableau[tableauIndex]);
+            
+            // Get the first card to move
+            size_t cardIndex = m_tableau[sourceIndex].size() - cardCount;
+            const Core::Card& card = m_tableau[sourceIndex][cardIndex];
+            
+            return IsValidTableauToTableauMove(card, m_tableau[targetIndex]);
+        }
+            
+        case FreeCellMoveType::FREECELL_TO_FOUNDATION: {
+            int freeCellIndex = move.args[0];
+            int foundationIndex = move.args[1];
+            
+            if (freeCellIndex >= 4 || foundationIndex >= 4 || m_freeCells[freeCellIndex].IsBlank()) {
+                return false;
             }
-                
-            default:
+            
+            const Core::Card& card = m_freeCells[freeCellIndex];
+            return IsValidCardForFoundation(card, m_foundations[foundationIndex]);
+        }
+            
+        case FreeCellMoveType::FREECELL_TO_TABLEAU: {
+            int freeCellIndex = move.args[0];
+            int tableauIndex = move.args[1];
+            
+            if (freeCellIndex >= 4 || tableauIndex >= 8 || m_freeCells[freeCellIndex].IsBlank()) {
                 return false;
+            }
+            
+            const Core::Card& card = m_freeCells[freeCellIndex];
+            return IsValidTableauToTableauMove(card, m_tableau[tableauIndex]);
         }
-    } catch (const std::exception&) {
-        return false;
+            
+        default:
+            return false;
     }
-    
-    return false;
 }
 
-bool FreeCell::MakeMove(int playerId, const std::string& moveData)
+bool FreeCell::MakeMove(int playerId, const Core::Move& move)
 {
     // Only the current player can make moves
     if (m_players.empty() || m_players[0]->GetId() != playerId) {
         return false;
     }
     
-    if (!IsValidMove(moveData)) {
+    if (!IsValidMove(move)) {
         return false;
     }
     
-    std::istringstream ss(moveData);
-    std::string moveTypeStr;
-    ss >> moveTypeStr;
+    // Journal the move's pile operations for undo
+    m_journal.BeginMove();
+    
+    switch (static_cast<FreeCellMoveType>(move.type)) {
+        case FreeCellMoveType::TABLEAU_TO_FREECELL:
+            return MoveTableauToFreeCell(move.args[0], move.args[1]);
+            
+        case FreeCellMoveType::TABLEAU_TO_FOUNDATION:
+            return MoveTableauToFoundation(move.args[0], move.args[1]);
+            
+        case FreeCellMoveType::TABLEAU_TO_TABLEAU:
+            return MoveTableauToTableau(move.args[0], move.args[1], move.args[2]);
+            
+        case FreeCellMoveType::FREECELL_TO_FOUNDATION:
+            return MoveFreeCellToFoundation(move.args[0], move.args[1]);
+            
+        case FreeCellMoveType::FREECELL_TO_TABLEAU:
+            return MoveFreeCellToTableau(move.args[0], move.args[1]);
+            
+        default:
+            return false;
+    }
+}
+
+void FreeCell::GenerateMoves(Core::MoveList& moves) const
+{
+    moves.Clear();
+    
+    for (int freeCellIndex = 0; freeCellIndex < 4; ++freeCellIndex) {
+        if (m_freeCells[freeCellIndex].IsBlank()) {
+            continue;
+        }
+        const Core::Card& card = m_freeCells[freeCellIndex];
+        for (int foundationIndex = 0; foundationIndex < 4; ++foundationIndex) {
+            if (IsValidCardForFoundation(card, m_foundations[foundationIndex])) {
+                moves.Add(Core::Move::Make(FreeCellMoveType::FREECELL_TO_FOUNDATION, freeCellIndex, foundationIndex));
+            }
+        }
+        for (int tableauIndex = 0; tableauIndex < 8; ++tableauIndex) {
+            if (IsValidTableauToTableauMove(card, m_tableau[tableauIndex])) {
+                moves.Add(Core::Move::Make(FreeCellMoveType::FREECELL_TO_TABLEAU, freeCellIndex, tableauIndex));
+            }
+        }
+    }
+    
+    int maxMovable = GetMaxMovableCards();
     
-    try {
-        FreeCellMoveType moveType = static_cast<FreeCellMoveType>(std::stoi(moveTypeStr));
+    for (int sourceIndex = 0; sourceIndex < 8; ++sourceIndex) {
+        const std::vector<Core::Card>& source = m_tableau[sourceIndex];
+        if (source.empty()) {
+            continue;
+        }
         
-        switch (moveType) {
-            case FreeCellMoveType::TABLEAU_TO_FREECELL: {
-                int tableauIndex, freeCellIndex;
-                ss >> tableauIndex >> freeCellIndex;
-                return MoveTableauToFreeCell(tableauIndex, freeCellIndex);
+        const Core::Card& top = source.back();
+        for (int foundationIndex = 0; foundationIndex < 4; ++foundationIndex) {
+            if (IsValidCardForFoundation(top, m_foundations[foundationIndex])) {
+                moves.Add(Core::Move::Make(FreeCellMoveType::TABLEAU_TO_FOUNDATION, sourceIndex, foundationIndex));
             }
-                
-            case FreeCellMoveType::TABLEAU_TO_FOUNDATION: {
-                int tableauIndex, foundationIndex;
-                ss >> tableauIndex >> foundationIndex;
-                return MoveTableauToFoundation(tableauIndex, foundationIndex);
+        }
+        for (int freeCellIndex = 0; freeCellIndex < 4; ++freeCellIndex) {
+            if (m_freeCells[freeCellIndex].IsBlank()) {
+                moves.Add(Core::Move::Make(FreeCellMoveType::TABLEAU_TO_FREECELL, sourceIndex, freeCellIndex));
             }
-                
-            case FreeCellMoveType::TABLEAU_TO_TABLEAU: {
-                int sourceIndex, targetIndex, cardCount;
-                ss >> sourceIndex >> targetIndex >> cardCount;
-                return MoveTableauToTableau(sourceIndex, targetIndex, cardCount);
+        }
+        
+        // Length of the alternating-color run on top, capped by what can move at once
+        int runLength = 1;
+        for (size_t i = source.size() - 1; i > 0 && runLength < maxMovable; --i) {
+            const Core::Card& card = source[i];
+            const Core::Card& below = source[i - 1];
+            if (card.GetColor() == below.GetColor() ||
+                static_cast<int>(card.GetRank()) != static_cast<int>(below.GetRank()) - 1) {
+                break;
             }
-                
-            case FreeCellMoveType::FREECELL_TO_FOUNDATION: {
-                int freeCellIndex, foundationIndex;
-                ss >> freeCellIndex >> foundationIndex;
-                return MoveFreeCellToFoundation(freeCellIndex, foundationIndex);
+            runLength++;
+        }
+        runLength = std::min(runLength, maxMovable);
+        
+        // A non-empty target takes only the run card one rank below its top card;
+        // an empty one takes any part of the run
+        int topRank = static_cast<int>(top.GetRank());
+        for (int targetIndex = 0; targetIndex < 8; ++targetIndex) {
+            if (targetIndex == sourceIndex) {
+                continue;
             }
-                
-            case FreeCellMoveType::FREECELL_TO_TABLEAU: {
-                int freeCellIndex, tableauIndex;
-                ss >> freeCellIndex >> tableauIndex;
-                return MoveFreeCellToTableau(freeCellIndex, tableauIndex);
+            
+            const std::vector<Core::Card>& target = m_tableau[targetIndex];
+            if (target.empty()) {
+                for (int cardCount = 1; cardCount <= runLength; ++cardCount) {
+                    moves.Add(Core::Move::Make(FreeCellMoveType::TABLEAU_TO_TABLEAU, sourceIndex, targetIndex, cardCount));
+                }
+                continue;
+            }
+            
+            int cardCount = static_cast<int>(target.back().GetRank()) - topRank;
+            if (cardCount >= 1 && cardCount <= runLength &&
+                IsValidTableauToTableauMove(source[source.size() - cardCount], target)) {
+                moves.Add(Core::Move::Make(FreeCellMoveType::TABLEAU_TO_TABLEAU, sourceIndex, targetIndex, cardCount));
             }
-                
-            default:
-                return false;
         }
-    } catch (const std::exception&) {
-        return false;
     }
-    
-    return false;
 }
 
 std::string FreeCell::SerializeGameState() const
@@ -236,11 +316,11 @@ std::string FreeCell::SerializeGameState() const
     // Serialize free cells
     ss << "FREECELLS ";
     for (const auto& cell : m_freeCells) {
-        if (cell == nullptr) {
+        if (cell.IsBlank()) {
             ss << "0 ";
         } else {
-            ss << "1 " << static_cast<int>(cell->GetSuit()) << " " 
-               << static_cast<int>(cell->GetRank()) << " ";
+            ss << "1 " << static_cast<int>(cell.GetSuit()) << " " 
+               << static_cast<int>(cell.GetRank()) << " ";
         }
     }
     
@@ -286,8 +366,8 @@ bool FreeCell::DeserializeGameState(const std::string& data)
         if (hasCard == 1) {
             int suit, rank;
             ss >> suit >> rank;
-            cell = new Core::Card(static_cast<Core::Suit>(suit), static_cast<Core::Rank>(rank));
-            cell->SetFaceUp(true);
+            cell = Core::Card(static_cast<Core::Suit>(suit), static_cast<Core::Rank>(rank));
+            cell.SetFaceUp(true);
         }
     }
     
@@ -327,6 +407,9 @@ bool FreeCell::DeserializeGameState(const std::string& data)
         }
     }
     
+    m_journal.Clear();
+    m_positionHash = ComputePositionHash();
+    
     // Set game state
     SetState(Core::GameState::IN_PROGRESS);
     
@@ -343,15 +426,12 @@ bool FreeCell::MoveTableauToFreeCell(int tableauIndex, int freeCellIndex)
     if (tableauIndex < 0 || tableauIndex >= 8 || 
         freeCellIndex < 0 || freeCellIndex >= 4 || 
         m_tableau[tableauIndex].empty() || 
-        m_freeCells[freeCellIndex] != nullptr) {
+        !m_freeCells[freeCellIndex].IsBlank()) {
         return false;
     }
     
-    m_freeCells[freeCellIndex] = new Core::Card(m_tableau[tableauIndex].back());
-    m_freeCells[freeCellIndex]->SetFaceUp(true);
-    m_tableau[tableauIndex].pop_back();
-    
-    return true;
+    return ApplyPileOp(Core::MakePileOp(FIRST_TABLEAU_PILE + tableauIndex, FIRST_FREECELL_PILE + freeCellIndex, 1,
+                                        Core::PILE_OP_FACE_UP));
 }
 
 bool FreeCell::MoveTableauToFoundation(int tableauIndex, int foundationIndex)
@@ -367,8 +447,7 @@ bool FreeCell::MoveTableauToFoundation(int tableauIndex, int foundationIndex)
         return false;
     }
     
-    m_foundations[foundationIndex].push_back(m_tableau[tableauIndex].back());
-    m_tableau[tableauIndex].pop_back();
+    ApplyPileOp(Core::MakePileOp(FIRST_TABLEAU_PILE + tableauIndex, FIRST_FOUNDATION_PILE + foundationIndex, 1));
     
     // Check for win condition
     if (IsGameWon()) {
@@ -413,36 +492,23 @@ bool FreeCell::MoveTableauToTableau(int sourceIndex, int targetIndex, int cardCo
     }
     
     // Move the cards
-    std::vector<Core::Card> cardsToMove;
-    cardsToMove.insert(cardsToMove.begin(), 
-                      m_tableau[sourceIndex].begin() + cardIndex,
-                      m_tableau[sourceIndex].end());
-    
-    m_tableau[targetIndex].insert(m_tableau[targetIndex].end(),
-                                 cardsToMove.begin(), cardsToMove.end());
-    
-    m_tableau[sourceIndex].erase(m_tableau[sourceIndex].begin() + cardIndex,
-                               m_tableau[sourceIndex].end());
-    
-    return true;
+    return ApplyPileOp(Core::MakePileOp(FIRST_TABLEAU_PILE + sourceIndex, FIRST_TABLEAU_PILE + targetIndex, cardCount));
 }
 
 bool FreeCell::MoveFreeCellToFoundation(int freeCellIndex, int foundationIndex)
 {
     if (freeCellIndex < 0 || freeCellIndex >= 4 || 
         foundationIndex < 0 || foundationIndex >= 4 || 
-        m_freeCells[freeCellIndex] == nullptr) {
+        m_freeCells[freeCellIndex].IsBlank()) {
         return false;
     }
     
-    const Core::Card& card = *m_freeCells[freeCellIndex];
+    const Core::Card& card = m_freeCells[freeCellIndex];
     if (!IsValidCardForFoundation(card, m_foundations[foundationIndex])) {
         return false;
     }
     
-    m_foundations[foundationIndex].push_back(*m_freeCells[freeCellIndex]);
-    delete m_freeCells[freeCellIndex];
-    m_freeCells[freeCellIndex] = nullptr;
+    ApplyPileOp(Core::MakePileOp(FIRST_FREECELL_PILE + freeCellIndex, FIRST_FOUNDATION_PILE + foundationIndex, 1));
     
     // Check for win condition
     if (IsGameWon()) {
@@ -456,22 +522,127 @@ bool FreeCell::MoveFreeCellToTableau(int freeCellIndex, int tableauIndex)
 {
     if (freeCellIndex < 0 || freeCellIndex >= 4 || 
         tableauIndex < 0 || tableauIndex >= 8 || 
-        m_freeCells[freeCellIndex] == nullptr) {
+        m_freeCells[freeCellIndex].IsBlank()) {
         return false;
     }
     
-    const Core::Card& card = *m_freeCells[freeCellIndex];
+    const Core::Card& card = m_freeCells[freeCellIndex];
     if (!IsValidTableauToTableauMove(card, m_tableau[tableauIndex])) {
         return false;
     }
     
-    m_tableau[tableauIndex].push_back(*m_freeCells[freeCellIndex]);
-    delete m_freeCells[freeCellIndex];
-    m_freeCells[freeCellIndex] = nullptr;
+    return ApplyPileOp(Core::MakePileOp(FIRST_FREECELL_PILE + freeCellIndex, FIRST_TABLEAU_PILE + tableauIndex, 1));
+}
+
+bool FreeCell::WriteSnapshotBody(Core::SnapshotWriter& writer) const
+{
+    for (const auto& cell : m_freeCells) {
+        if (cell.IsBlank()) {
+            writer.WriteUInt8(0);
+        } else {
+            writer.WriteUInt8(1);
+            writer.WriteCard(cell);
+        }
+    }
+    
+    for (const auto& foundation : m_foundations) {
+        writer.WritePile(foundation);
+    }
+    
+    for (const auto& pile : m_tableau) {
+        writer.WritePile(pile);
+    }
+    
+    return true;
+}
+
+bool FreeCell::ReadSnapshotBody(Core::SnapshotReader& reader)
+{
+    bool ok = true;
+    
+    for (auto& cell : m_freeCells) {
+        cell = Core::Card();
+        
+        uint8_t count = reader.ReadUInt8();
+        if (count == 1) {
+            ok = ok && reader.ReadCard(cell);
+        } else {
+            ok = ok && count == 0;
+        }
+    }
+    
+    for (auto& foundation : m_foundations) {
+        foundation.clear();
+        ok = ok && reader.ReadPile(foundation);
+    }
+    
+    for (auto& pile : m_tableau) {
+        pile.clear();
+        ok = ok && reader.ReadPile(pile);
+    }
     
+    return ok;
+}
+
+bool FreeCell::SupportsDeltas() const
+{
     return true;
 }
 
+bool FreeCell::ExecutePileOp(const Core::PileOp& op)
+{
+    // A free cell is a one-card slot, so it never receives more than one card
+    Core::PileView source = GetPile(op.source);
+    Core::PileView target = GetPile(op.target);
+    
+    return source.IsValid() && target.IsValid() && TransferCards(source, target, op);
+}
+
+void FreeCell::OnDeltaApplied()
+{
+    // Check for win condition
+    if (IsGameWon()) {
+        SetState(Core::GameState::GAME_OVER);
+    }
+}
+
+uint64_t FreeCell::ComputePositionHash() const
+{
+    uint64_t hash = 0;
+    
+    for (size_t i = 0; i < m_tableau.size(); ++i) {
+        hash ^= Core::ZobristPileHash(FIRST_TABLEAU_PILE + static_cast<int>(i), m_tableau[i]);
+    }
+    
+    // A free cell is a pile of at most one card
+    for (size_t i = 0; i < m_freeCells.size(); ++i) {
+        if (!m_freeCells[i].IsBlank()) {
+            hash ^= Core::ZobristKey(FIRST_FREECELL_PILE + static_cast<int>(i), 0, m_freeCells[i]);
+        }
+    }
+    
+    for (size_t i = 0; i < m_foundations.size(); ++i) {
+        hash ^= Core::ZobristPileHash(FIRST_FOUNDATION_PILE + static_cast<int>(i), m_foundations[i]);
+    }
+    
+    return hash;
+}
+
+Core::PileView FreeCell::GetPile(int pileId)
+{
+    if (pileId >= FIRST_TABLEAU_PILE && pileId < FIRST_TABLEAU_PILE + static_cast<int>(m_tableau.size())) {
+        return Core::PileView(m_tableau[pileId - FIRST_TABLEAU_PILE]);
+    }
+    if (pileId >= FIRST_FREECELL_PILE && pileId < FIRST_FREECELL_PILE + static_cast<int>(m_freeCells.size())) {
+        return Core::PileView(m_freeCells[pileId - FIRST_FREECELL_PILE]);
+    }
+    if (pileId >= FIRST_FOUNDATION_PILE && pileId < FIRST_FOUNDATION_PILE + static_cast<int>(m_foundations.size())) {
+        return Core::PileView(m_foundations[pileId - FIRST_FOUNDATION_PILE]);
+    }
+    
+    return Core::PileView();
+}
+
 bool FreeCell::IsGameWon() const
 {
     // Game is won when all foundations have 13 cards each (A through K of each suit)
@@ -493,7 +664,7 @@ int FreeCell::GetMaxMovableCards() const
     return (1 + emptyFreeCells) * (1 << emptyTableau);
 }
 
-const std::array<Core::Card*, 4>& FreeCell::GetFreeCells() const
+const std::array<Core::Card, 4>& FreeCell::GetFreeCells() const
 {
     return m_freeCells;
 }
@@ -540,7 +711,7 @@ int FreeCell::CountEmptyFreeCells() const
 {
     int count = 0;
     for (const auto& cell : m_freeCells) {
-        if (cell == nullptr) {
+        if (cell.IsBlank()) {
             count++;
         }
     }
@@ -560,9 +731,11 @@ int FreeCell::CountEmptyTableauPiles() const
 
 void FreeCell::DealInitialLayout()
 {
+    // A new deal starts a fresh undo history
+    m_journal.Clear();
+    
     // Create a new shuffled deck
-    Core::Deck deck;
-    deck.Shuffle();
+    Core::Deck deck(1, NextDealNumber());
     
     // Deal all cards to the tableau piles
     int currentPile = 0;
@@ -572,6 +745,31 @@ void FreeCell::DealInitialLayout()
         m_tableau[currentPile].push_back(card);
         currentPile = (currentPile + 1) % 8;
     }
+    
+    m_positionHash = ComputePositionHash();
+}
+
+bool FreeCell::IsLayoutDealt() const
+{
+    for (const Core::Card& cell : m_freeCells) {
+        if (!cell.IsBlank()) {
+            return true;
+        }
+    }
+    
+    for (const auto& foundation : m_foundations) {
+        if (!foundation.empty()) {
+            return true;
+        }
+    }
+    
+    for (const auto& pile : m_tableau) {
+        if (!pile.empty()) {
+            return true;
+        }
+    }
+    
+    return false;
 }
 
 } // namespace Solitaire
@@ -21,8 +21,8 @@ enum class FreeCellMoveType {
 
 class FreeCell : public Core::Game {
 public:
-    // Constructor
-    FreeCell();
+    // Constructor. With winnableDealsOnly, random deals come from the default DealIndex.
+    explicit FreeCell(bool winnableDealsOnly = false);
     
     // Game setup
     virtual void Initialize() override;
@@ -30,13 +30,30 @@ public:
     virtual bool CanStart() const override;
     virtual void Reset() override;
     
+    // Reset and lay out a deal without waiting for a player (solvers, previews). The
+    // game state is left at WAITING_FOR_PLAYERS; Start then plays this layout.
+    void Deal(uint64_t dealNumber);
+    
+    // Lay out one of the classic Microsoft FreeCell deals (game numbers 1-32000 and
+    // beyond, generated with the original rand() sequence)
+    void DealMicrosoft(uint32_t gameNumber);
+    
     // Game moves
-    virtual bool IsValidMove(const std::string& moveData) override;
-    virtual bool MakeMove(int playerId, const std::string& moveData) override;
+    using Core::Game::IsValidMove;
+    using Core::Game::MakeMove;
+    virtual bool IsValidMove(const Core::Move& move) override;
+    virtual bool MakeMove(int playerId, const Core::Move& move) override;
+    virtual void GenerateMoves(Core::MoveList& moves) const override;
     
     // Game state serialization
     virtual std::string SerializeGameState() const override;
     virtual bool DeserializeGameState(const std::string& data) override;
+    virtual bool SupportsDeltas() const override;
+    
+    // Pile ids used in game deltas
+    static constexpr int FIRST_TABLEAU_PILE = 0;
+    static constexpr int FIRST_FREECELL_PILE = 8;
+    static constexpr int FIRST_FOUNDATION_PILE = 12;
     
     // FreeCell-specific methods
     bool MoveTableauToFreeCell(int tableauIndex, int freeCellIndex);
@@ -50,22 +67,34 @@ public:
     int GetMaxMovableCards() const; // Calculate max cards that can be moved at once
     
     // Access game state
-    const std::array<Core::Card*, 4>& GetFreeCells() const;
+    // Free cells; an empty cell holds a blank card
+    const std::array<Core::Card, 4>& GetFreeCells() const;
     const std::array<std::vector<Core::Card>, 4>& GetFoundations() const;
     const std::array<std::vector<Core::Card>, 8>& GetTableau() const;
     
 private:
     // Game components
-    std::array<Core::Card*, 4> m_freeCells;        // 4 free cells (single card spaces)
+    std::array<Core::Card, 4> m_freeCells;         // 4 free cells (blank when empty)
     std::array<std::vector<Core::Card>, 4> m_foundations; // 4 foundation piles (A to K by suit)
     std::array<std::vector<Core::Card>, 8> m_tableau;     // 8 tableau piles
     
+    // Binary snapshot: free cells (as piles of zero or one card), foundations, tableau
+    virtual bool WriteSnapshotBody(Core::SnapshotWriter& writer) const override;
+    virtual bool ReadSnapshotBody(Core::SnapshotReader& reader) override;
+    
+    // Delta sync. Free cells are one-card pile views.
+    virtual bool ExecutePileOp(const Core::PileOp& op) override;
+    virtual void OnDeltaApplied() override;
+    virtual uint64_t ComputePositionHash() const override;
+    Core::PileView GetPile(int pileId);
+    
     // Helper methods
     bool IsValidTableauToTableauMove(const Core::Card& card, const std::vector<Core::Card>& targetPile) const;
     bool IsValidCardForFoundation(const Core::Card& card, const std::vector<Core::Card>& foundation) const;
     int CountEmptyFreeCells() const;
     int CountEmptyTableauPiles() const;
     void DealInitialLayout();
+    bool IsLayoutDealt() const;
 };
 
 } // namespace Solitaire
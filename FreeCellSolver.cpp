@@ -0,0 +1,614 @@
+#include "games/solitaire/FreeCellSolver.h"
+#include "core/Rng.h"
+#include <algorithm>
+#include <cstring>
+#include <queue>
+
+namespace CardGameLib {
+namespace Games {
+namespace Solitaire {
+
+namespace {
+    const int COLUMNS = 8;
+    const int CELLS = 4;
+    const int SUITS = 4;
+    const int CARDS = 52;
+    const int MAX_COLUMN = 20;   // Seven dealt cards plus a built run of twelve
+    const int MAX_MOVES = 256;
+    const uint8_t EMPTY_CELL = 0xFF;
+    const uint32_t NO_PARENT = 0xFFFFFFFF;
+    
+    // Random keys for the position hash
+    struct ZobristKeys {
+        uint64_t card[CARDS][MAX_COLUMN];   // Card at a depth in a column
+        uint64_t cell[CARDS];               // Card in a free cell
+        
+        ZobristKeys()
+        {
+            Core::Rng rng(0x46524545434C4C53ULL);
+            FillKeys(rng, &card[0][0], CARDS * MAX_COLUMN);
+            FillKeys(rng, cell, CARDS);
+        }
+    };
+    
+    enum SolverMoveKind : uint8_t {
+        COLUMN_TO_FOUNDATION,
+        CELL_TO_FOUNDATION,
+        COLUMN_TO_COLUMN,
+        CELL_TO_COLUMN,
+        COLUMN_TO_CELL
+    };
+    
+    struct SolverMove {
+        uint8_t kind;
+        uint8_t from;
+        uint8_t to;
+        uint8_t count;
+    };
+    
+    // Position as stored in the search: the columns' cards back to back
+    struct PackedPosition {
+        uint8_t cards[CARDS];
+        uint8_t size[COLUMNS];
+        uint8_t cells[CELLS];
+        uint8_t foundation[SUITS];
+        int8_t foundationSlot[SUITS];
+    };
+    
+    // Position being worked on
+    struct Position : SuitFoundations {
+        uint8_t columns[COLUMNS][MAX_COLUMN];   // Bottom to top
+        uint8_t size[COLUMNS];
+        uint8_t cells[CELLS];                   // Card index or EMPTY_CELL
+        
+        void Pack(PackedPosition& packed) const
+        {
+            int offset = 0;
+            for (int column = 0; column < COLUMNS; ++column) {
+                std::memcpy(packed.cards + offset, columns[column], size[column]);
+                offset += size[column];
+            }
+            std::memcpy(packed.size, size, sizeof(size));
+            std::memcpy(packed.cells, cells, sizeof(cells));
+            std::memcpy(packed.foundation, foundation, sizeof(foundation));
+            std::memcpy(packed.foundationSlot, foundationSlot, sizeof(foundationSlot));
+        }
+        
+        void Unpack(const PackedPosition& packed)
+        {
+            int offset = 0;
+            for (int column = 0; column < COLUMNS; ++column) {
+                std::memcpy(columns[column], packed.cards + offset, packed.size[column]);
+                offset += packed.size[column];
+            }
+            std::memcpy(size, packed.size, sizeof(size));
+            std::memcpy(cells, packed.cells, sizeof(cells));
+            std::memcpy(foundation, packed.foundation, sizeof(foundation));
+            std::memcpy(foundationSlot, packed.foundationSlot, sizeof(foundationSlot));
+        }
+        
+        // Summing the column hashes and XORing the cell keys makes the hash
+        // independent of which column or cell holds what
+        uint64_t GetHash() const
+        {
+            const ZobristKeys& keys = GetKeys<ZobristKeys>();
+            uint64_t hash = 0;
+            for (int column = 0; column < COLUMNS; ++column) {
+                uint64_t columnHash = 0;
+                for (int i = 0; i < size[column]; ++i) {
+                    columnHash ^= keys.card[columns[column][i]][i];
+                }
+                hash += columnHash;
+            }
+            for (uint8_t card : cells) {
+                if (card != EMPTY_CELL) {
+                    hash ^= keys.cell[card];
+                }
+            }
+            return hash;
+        }
+        
+        uint8_t Top(int column) const { return columns[column][size[column] - 1]; }
+        
+        int CountEmptyCells() const
+        {
+            return static_cast<int>(std::count(cells, cells + CELLS, EMPTY_CELL));
+        }
+        
+        int CountEmptyColumns() const
+        {
+            return static_cast<int>(std::count(size, size + COLUMNS, 0));
+        }
+        
+        int FindEmptyCell() const
+        {
+            for (int cell = 0; cell < CELLS; ++cell) {
+                if (cells[cell] == EMPTY_CELL) {
+                    return cell;
+                }
+            }
+            return -1;
+        }
+        
+        int FindEmptyColumn() const
+        {
+            for (int column = 0; column < COLUMNS; ++column) {
+                if (size[column] == 0) {
+                    return column;
+                }
+            }
+            return -1;
+        }
+        
+        // Cards on top of a column that form one alternating descending run
+        int GetRunLength(int column) const
+        {
+            int length = size[column] > 0 ? 1 : 0;
+            while (length < size[column] &&
+                   IndexBuildsOn(columns[column][size[column] - length], columns[column][size[column] - length - 1])) {
+                length++;
+            }
+            return length;
+        }
+        
+        // Lower bound on the moves left: one foundation move per card, and one more
+        // for each column holding a card above a lower card of its own suit
+        int GetHeuristic() const
+        {
+            int moves = CARDS - foundation[0] - foundation[1] - foundation[2] - foundation[3];
+            
+            for (int column = 0; column < COLUMNS; ++column) {
+                int lowest[SUITS] = { 14, 14, 14, 14 };
+                for (int i = 0; i < size[column]; ++i) {
+                    uint8_t card = columns[column][i];
+                    int suit = IndexSuit(card);
+                    if (lowest[suit] < IndexRank(card)) {
+                        moves++;
+                        break;
+                    }
+                    lowest[suit] = static_cast<int>(IndexRank(card));
+                }
+            }
+            
+            return moves;
+        }
+        
+        // How badly the position is tangled (not a bound): occupied free cells count
+        // double, plus every card covering the next card a foundation needs and every
+        // card lying above a lower card
+        int GetCongestion() const
+        {
+            int congestion = 2 * (CELLS - CountEmptyCells());
+            
+            for (int column = 0; column < COLUMNS; ++column) {
+                int lowest = 14;
+                for (int i = 0; i < size[column]; ++i) {
+                    uint8_t card = columns[column][i];
+                    if (FitsFoundation(card)) {
+                        congestion += size[column] - 1 - i;
+                    }
+                    if (IndexRank(card) > lowest) {
+                        congestion++;
+                    } else {
+                        lowest = IndexRank(card);
+                    }
+                }
+            }
+            
+            return congestion;
+        }
+        
+        void Apply(const SolverMove& move)
+        {
+            switch (move.kind) {
+                case COLUMN_TO_FOUNDATION:
+                    AddToFoundation(columns[move.from][--size[move.from]]);
+                    break;
+                case CELL_TO_FOUNDATION:
+                    AddToFoundation(cells[move.from]);
+                    cells[move.from] = EMPTY_CELL;
+                    break;
+                case COLUMN_TO_COLUMN:
+                    std::memcpy(columns[move.to] + size[move.to], columns[move.from] + size[move.from] - move.count,
+                                move.count);
+                    size[move.to] = static_cast<uint8_t>(size[move.to] + move.count);
+                    size[move.from] = static_cast<uint8_t>(size[move.from] - move.count);
+                    break;
+                case CELL_TO_COLUMN:
+                    columns[move.to][size[move.to]++] = cells[move.from];
+                    cells[move.from] = EMPTY_CELL;
+                    break;
+                case COLUMN_TO_CELL:
+                    cells[move.to] = columns[move.from][--size[move.from]];
+                    break;
+            }
+        }
+        
+        // FreeCell move data for a move from this position
+        std::string Describe(const SolverMove& move) const
+        {
+            switch (move.kind) {
+                case COLUMN_TO_FOUNDATION:
+                    return MoveData(FreeCellMoveType::TABLEAU_TO_FOUNDATION, move.from, GetFoundationSlot(Top(move.from)));
+                case CELL_TO_FOUNDATION:
+                    return MoveData(FreeCellMoveType::FREECELL_TO_FOUNDATION, move.from, GetFoundationSlot(cells[move.from]));
+                case COLUMN_TO_COLUMN:
+                    return MoveData(FreeCellMoveType::TABLEAU_TO_TABLEAU, move.from, move.to, move.count);
+                case CELL_TO_COLUMN:
+                    return MoveData(FreeCellMoveType::FREECELL_TO_TABLEAU, move.from, move.to);
+                default:
+                    return MoveData(FreeCellMoveType::TABLEAU_TO_FREECELL, move.from, move.to);
+            }
+        }
+        
+        // Make every safe foundation move, optionally recording the move data
+        int AutoMove(std::vector<std::string>* out)
+        {
+            int count = 0;
+            bool moved = true;
+            
+            while (moved) {
+                moved = false;
+                
+                for (int column = 0; column < COLUMNS; ++column) {
+                    if (size[column] > 0 && IsSafeForFoundation(Top(column))) {
+                        SolverMove move{ COLUMN_TO_FOUNDATION, static_cast<uint8_t>(column), 0, 1 };
+                        if (out) {
+                            out->push_back(Describe(move));
+                        }
+                        Apply(move);
+                        moved = true;
+                        count++;
+                    }
+                }
+                
+                for (int cell = 0; cell < CELLS; ++cell) {
+                    if (cells[cell] != EMPTY_CELL && IsSafeForFoundation(cells[cell])) {
+                        SolverMove move{ CELL_TO_FOUNDATION, static_cast<uint8_t>(cell), 0, 1 };
+                        if (out) {
+                            out->push_back(Describe(move));
+                        }
+                        Apply(move);
+                        moved = true;
+                        count++;
+                    }
+                }
+            }
+            
+            return count;
+        }
+        
+        int GenerateMoves(SolverMove* moves) const
+        {
+            int count = 0;
+            auto add = [&](uint8_t kind, int from, int to, int cards) {
+                if (count < MAX_MOVES) {
+                    moves[count++] = SolverMove{ kind, static_cast<uint8_t>(from), static_cast<uint8_t>(to),
+                                                 static_cast<uint8_t>(cards) };
+                }
+            };
+            
+            int emptyCell = FindEmptyCell();
+            int emptyColumn = FindEmptyColumn();
+            
+            // Supermove capacity onto a card, and onto an empty column
+            int freeCells = CountEmptyCells();
+            int freeColumns = CountEmptyColumns();
+            int capacity = (freeCells + 1) << freeColumns;
+            int emptyCapacity = freeColumns > 0 ? (freeCells + 1) << (freeColumns - 1) : 0;
+            
+            for (int cell = 0; cell < CELLS; ++cell) {
+                uint8_t card = cells[cell];
+                if (card == EMPTY_CELL) {
+                    continue;
+                }
+                if (FitsFoundation(card)) {
+                    add(CELL_TO_FOUNDATION, cell, 0, 1);
+                }
+                for (int column = 0; column < COLUMNS; ++column) {
+                    if (size[column] > 0 && IndexBuildsOn(card, Top(column))) {
+                        add(CELL_TO_COLUMN, cell, column, 1);
+                    }
+                }
+                if (emptyColumn >= 0) {
+                    add(CELL_TO_COLUMN, cell, emptyColumn, 1);
+                }
+            }
+            
+            for (int source = 0; source < COLUMNS; ++source) {
+                if (size[source] == 0) {
+                    continue;
+                }
+                
+                uint8_t top = Top(source);
+                if (FitsFoundation(top)) {
+                    add(COLUMN_TO_FOUNDATION, source, 0, 1);
+                }
+                
+                // The run card that fits a target is fixed by the target's rank
+                int run = GetRunLength(source);
+                for (int target = 0; target < COLUMNS; ++target) {
+                    if (target == source || size[target] == 0) {
+                        continue;
+                    }
+                    int cards = IndexRank(Top(target)) - IndexRank(top);
+                    if (cards >= 1 && cards <= run && cards <= capacity &&
+                        IndexBuildsOn(columns[source][size[source] - cards], Top(target))) {
+                        add(COLUMN_TO_COLUMN, source, target, cards);
+                    }
+                }
+                
+                // Runs to an empty column, except a whole column
+                if (emptyColumn >= 0) {
+                    int most = std::min(run, emptyCapacity);
+                    for (int cards = most; cards >= 1; --cards) {
+                        if (cards < size[source]) {
+                            add(COLUMN_TO_COLUMN, source, emptyColumn, cards);
+                        }
+                    }
+                }
+                
+                if (emptyCell >= 0) {
+                    add(COLUMN_TO_CELL, source, emptyCell, 1);
+                }
+            }
+            
+            return count;
+        }
+    };
+    
+    Position MakePosition(const FreeCell& game)
+    {
+        Position position;
+        std::memset(&position, 0, sizeof(position));
+        std::fill(position.cells, position.cells + CELLS, EMPTY_CELL);
+        std::fill(position.foundationSlot, position.foundationSlot + SUITS, -1);
+        
+        const auto& tableau = game.GetTableau();
+        for (int column = 0; column < COLUMNS; ++column) {
+            for (const Core::Card& card : tableau[column]) {
+                if (position.size[column] < MAX_COLUMN) {
+                    position.columns[column][position.size[column]++] = static_cast<uint8_t>(card.GetIndex());
+                }
+            }
+        }
+        
+        const auto& cells = game.GetFreeCells();
+        for (int cell = 0; cell < CELLS; ++cell) {
+            if (!cells[cell].IsBlank()) {
+                position.cells[cell] = static_cast<uint8_t>(cells[cell].GetIndex());
+            }
+        }
+        
+        const auto& foundations = game.GetFoundations();
+        for (int slot = 0; slot < SUITS; ++slot) {
+            if (!foundations[slot].empty()) {
+                int suit = static_cast<int>(foundations[slot].back().GetSuit());
+                position.foundation[suit] = static_cast<uint8_t>(foundations[slot].size());
+                position.foundationSlot[suit] = static_cast<int8_t>(slot);
+            }
+        }
+        
+        return position;
+    }
+    
+    // Weighted A* over packed positions
+    class Search {
+    public:
+        Search(TranspositionTable& table, size_t nodeBudget, int weight, int congestionWeight)
+            : m_table(table)
+            , m_nodeBudget(nodeBudget)
+            , m_weight(std::max(weight, 1))
+            , m_congestionWeight(std::max(congestionWeight, 0))
+            , m_goal(NO_PARENT)
+        {
+        }
+        
+        SolveResult Run(const Position& start, std::vector<std::string>& solution)
+        {
+            m_table.NewSearch();
+            m_nodes.clear();
+            m_nodes.reserve(std::min<size_t>(m_nodeBudget, 1 << 16));
+            
+            Position root = start;
+            std::vector<std::string> rootMoves;
+            int rootCost = root.AutoMove(&rootMoves);
+            m_table.Insert(root.GetHash());
+            Store(root, NO_PARENT, SolverMove{}, rootCost);
+            
+            if (root.IsWon()) {
+                solution = rootMoves;
+                return SolveResult::SOLVED;
+            }
+            
+            bool exhausted = false;
+            SolverMove moves[MAX_MOVES];
+            
+            while (!m_open.empty() && m_goal == NO_PARENT && !exhausted) {
+                OpenEntry entry = m_open.top();
+                m_open.pop();
+                
+                Position position;
+                position.Unpack(m_nodes[entry.node].position);
+                int cost = m_nodes[entry.node].cost;
+                
+                int moveCount = position.GenerateMoves(moves);
+                for (int i = 0; i < moveCount; ++i) {
+                    Position child = position;
+                    child.Apply(moves[i]);
+                    int childCost = cost + 1 + child.AutoMove(nullptr);
+                    
+                    if (!m_table.Insert(child.GetHash())) {
+                        continue;
+                    }
+                    if (m_nodes.size() >= m_nodeBudget) {
+                        exhausted = true;
+                        break;
+                    }
+                    
+                    uint32_t node = Store(child, entry.node, moves[i], childCost);
+                    if (child.IsWon()) {
+                        m_goal = node;
+                        break;
+                    }
+                }
+            }
+            
+            if (m_goal == NO_PARENT) {
+                return exhausted ? SolveResult::BUDGET_EXHAUSTED : SolveResult::UNSOLVABLE;
+            }
+            
+            // Walk back to the root, then replay to write out the moves with the auto-moves
+            std::vector<SolverMove> line;
+            for (uint32_t node = m_goal; m_nodes[node].parent != NO_PARENT; node = m_nodes[node].parent) {
+                line.push_back(m_nodes[node].move);
+            }
+            std::reverse(line.begin(), line.end());
+            
+            solution = rootMoves;
+            Position position = root;
+            for (const SolverMove& move : line) {
+                solution.push_back(position.Describe(move));
+                position.Apply(move);
+                position.AutoMove(&solution);
+            }
+            
+            return SolveResult::SOLVED;
+        }
+        
+        size_t GetNodes() const { return m_nodes.size(); }
+    
+    private:
+        struct Node {
+            PackedPosition position;
+            uint32_t parent;
+            SolverMove move;
+            uint16_t cost;
+        };
+        
+        struct OpenEntry {
+            uint32_t priority;
+            uint32_t heuristic;
+            uint32_t node;
+            
+            bool operator<(const OpenEntry& other) const
+            {
+                // priority_queue pops the largest, so invert: lowest priority, then closest to done
+                if (priority != other.priority) {
+                    return priority > other.priority;
+                }
+                return heuristic > other.heuristic;
+            }
+        };
+        
+        TranspositionTable& m_table;
+        size_t m_nodeBudget;
+        int m_weight;
+        int m_congestionWeight;
+        uint32_t m_goal;
+        std::vector<Node> m_nodes;
+        std::priority_queue<OpenEntry> m_open;
+        
+        uint32_t Store(const Position& position, uint32_t parent, const SolverMove& move, int cost)
+        {
+            Node node;
+            position.Pack(node.position);
+            node.parent = parent;
+            node.move = move;
+            node.cost = static_cast<uint16_t>(cost);
+            
+            uint32_t index = static_cast<uint32_t>(m_nodes.size());
+            m_nodes.push_back(node);
+            
+            int heuristic = position.GetHeuristic();
+            int priority = cost + m_weight * heuristic;
+            if (m_congestionWeight > 0) {
+                priority += m_congestionWeight * position.GetCongestion();
+            }
+            m_open.push(OpenEntry{ static_cast<uint32_t>(priority), static_cast<uint32_t>(heuristic), index });
+            return index;
+        }
+    };
+}
+
+FreeCellSolver::FreeCellSolver(size_t nodeBudget, int weight, int congestionWeight)
+    : m_table()
+    , m_nodeBudget(nodeBudget)
+    , m_weight(weight)
+    , m_congestionWeight(congestionWeight)
+    , m_nodesSearched(0)
+{
+}
+
+SolveResult FreeCellSolver::Solve(const FreeCell& game)
+{
+    m_solution.clear();
+    
+    Search search(m_table, m_nodeBudget, m_weight, m_congestionWeight);
+    SolveResult result = search.Run(MakePosition(game), m_solution);
+    m_nodesSearched = search.GetNodes();
+    
+    if (result != SolveResult::SOLVED) {
+        m_solution.clear();
+    }
+    
+    return result;
+}
+
+SolveResult FreeCellSolver::SolveDeal(uint64_t dealNumber)
+{
+    FreeCell game;
+    game.Deal(dealNumber);
+    return Solve(game);
+}
+
+SolveResult FreeCellSolver::SolveMicrosoftDeal(uint32_t gameNumber)
+{
+    FreeCell game;
+    game.DealMicrosoft(gameNumber);
+    return Solve(game);
+}
+
+const std::vector<std::string>& FreeCellSolver::GetSolution() const
+{
+    return m_solution;
+}
+
+size_t FreeCellSolver::GetNodesSearched() const
+{
+    return m_nodesSearched;
+}
+
+size_t FreeCellSolver::GetNodeBudget() const
+{
+    return m_nodeBudget;
+}
+
+void FreeCellSolver::SetNodeBudget(size_t nodeBudget)
+{
+    m_nodeBudget = nodeBudget;
+}
+
+int FreeCellSolver::GetWeight() const
+{
+    return m_weight;
+}
+
+void FreeCellSolver::SetWeight(int weight)
+{
+    m_weight = weight;
+}
+
+int FreeCellSolver::GetCongestionWeight() const
+{
+    return m_congestionWeight;
+}
+
+void FreeCellSolver::SetCongestionWeight(int congestionWeight)
+{
+    m_congestionWeight = congestionWeight;
+}
+
+} // namespace Solitaire
+} // namespace Games
+} // namespace CardGameLib
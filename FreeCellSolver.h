@@ -0,0 +1,73 @@
+#pragma once
+
+#include "games/solitaire/FreeCell.h"
+#include "games/solitaire/SolitaireSolver.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace CardGameLib {
+namespace Games {
+namespace Solitaire {
+
+// Solver for FreeCell.
+//
+// A best-first (A*) search over compact positions: each card is a byte, the free
+// cells hold card indices and the foundations are a count per suit. Positions are
+// deduplicated by a Zobrist hash that ignores the order of the free cells and of
+// the tableau columns, so positions that differ only by which cell or column holds
+// what are searched once. The heuristic is admissible: every card not yet on a
+// foundation needs a move, and every column holding a card above a lower card of
+// its own suit needs at least one more. Nodes are ordered by moves made, plus the heuristic
+// times a weight, plus a congestion score times another weight (occupied cells and
+// buried cards, which steers the search well but is not a bound). Lines are not
+// guaranteed shortest even with weights of 1 and 0: a position is kept at the cost
+// it was first reached with and never reopened, and the search stops when a won
+// position is generated rather than expanded. Lower weights give shorter lines,
+// slowly; the defaults solve typical Microsoft deals in a few milliseconds. Moves
+// include supermoves of as many cards as the free cells and empty columns allow,
+// and safe foundation moves are made automatically.
+class FreeCellSolver {
+public:
+    static constexpr size_t DEFAULT_NODE_BUDGET = 200000;
+    static constexpr int DEFAULT_WEIGHT = 4;
+    static constexpr int DEFAULT_CONGESTION_WEIGHT = 2;
+    
+    explicit FreeCellSolver(size_t nodeBudget = DEFAULT_NODE_BUDGET, int weight = DEFAULT_WEIGHT,
+                            int congestionWeight = DEFAULT_CONGESTION_WEIGHT);
+    
+    // Solve a position
+    SolveResult Solve(const FreeCell& game);
+    
+    // Solve a numbered deal, or a classic Microsoft deal
+    SolveResult SolveDeal(uint64_t dealNumber);
+    SolveResult SolveMicrosoftDeal(uint32_t gameNumber);
+    
+    // Winning line of the last solved position, as FreeCell move data (MakeMove input).
+    // The first move is a hint for the position.
+    const std::vector<std::string>& GetSolution() const;
+    
+    // Positions stored by the last call (the node budget bounds these)
+    size_t GetNodesSearched() const;
+    
+    size_t GetNodeBudget() const;
+    void SetNodeBudget(size_t nodeBudget);
+    int GetWeight() const;
+    void SetWeight(int weight);
+    int GetCongestionWeight() const;
+    void SetCongestionWeight(int congestionWeight);
+    
+private:
+    TranspositionTable m_table;
+    size_t m_nodeBudget;
+    int m_weight;
+    int m_congestionWeight;
+    size_t m_nodesSearched;
+    std::vector<std::string> m_solution;
+};
+
+} // namespace Solitaire
+} // namespace Games
+} // namespace CardGameLib
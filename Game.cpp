@@ -1,4 +1,5 @@
 #include "core/Game.h"
+#include "core/DealIndex.h"
 #include <algorithm>
 
 namespace CardGameLib {
@@ -10,6 +11,12 @@ Game::Game(const std::string& name, GameType type, int maxPlayers)
     , m_maxPlayers(maxPlayers)
     , m_state(GameState::WAITING_FOR_PLAYERS)
     , m_currentPlayerIndex(-1)
+    , m_dealNumber(0)
+    , m_dealNumberSet(false)
+    , m_winnableDealsOnly(false)
+    , m_sequence(0)
+    , m_lastTransferFlipped(false)
+    , m_positionHash(0)
 {
 }
 
@@ -127,5 +134,289 @@ void Game::NextTurn()
     }
 }
 
+bool Game::SupportsDeltas() const
+{
+    return false;
+}
+
+void Game::SetDealNumber(uint64_t dealNumber)
+{
+    m_dealNumber = dealNumber;
+    m_dealNumberSet = true;
+}
+
+uint64_t Game::GetDealNumber() const
+{
+    return m_dealNumber;
+}
+
+bool Game::IsValidMove(const std::string& moveData)
+{
+    Move move;
+    return ParseMove(moveData, move) && IsValidMove(move);
+}
+
+bool Game::MakeMove(int playerId, const std::string& moveData)
+{
+    Move move;
+    return ParseMove(moveData, move) && MakeMove(playerId, move);
+}
+
+bool Game::ParseMove(const std::string& moveData, Move& move) const
+{
+    return Move::Parse(moveData, move);
+}
+
+void Game::GenerateMoves(MoveList& moves) const
+{
+    moves.Clear();
+}
+
+void Game::SetWinnableDealsOnly(bool winnableOnly)
+{
+    m_winnableDealsOnly = winnableOnly;
+}
+
+bool Game::GetWinnableDealsOnly() const
+{
+    return m_winnableDealsOnly;
+}
+
+uint64_t Game::NextDealNumber()
+{
+    if (m_dealNumberSet) {
+        m_dealNumberSet = false;
+    } else if (!m_winnableDealsOnly ||
+               !DealIndex::GetDefault().Sample(m_type, GetDealVariant(), Rng::RandomSeed(), m_dealNumber)) {
+        m_dealNumber = Rng::RandomSeed();
+    }
+    
+    return m_dealNumber;
+}
+
+int Game::GetDealVariant() const
+{
+    return 0;
+}
+
+size_t Game::WriteSnapshot(uint8_t* buffer, size_t capacity) const
+{
+    SnapshotWriter writer(buffer, capacity);
+    
+    // Header: format version, game type and game state
+    writer.WriteUInt8(SNAPSHOT_VERSION);
+    writer.WriteUInt8(static_cast<uint8_t>(m_type));
+    writer.WriteUInt8(static_cast<uint8_t>(m_state));
+    
+    if (!WriteSnapshotBody(writer) || writer.HasError()) {
+        return 0;
+    }
+    
+    return writer.GetSize();
+}
+
+bool Game::ReadSnapshot(const uint8_t* data, size_t size)
+{
+    SnapshotReader reader(data, size);
+    
+    uint8_t version = reader.ReadUInt8();
+    uint8_t type = reader.ReadUInt8();
+    uint8_t state = reader.ReadUInt8();
+    
+    if (reader.HasError() || version != SNAPSHOT_VERSION || type != static_cast<uint8_t>(m_type) ||
+        state > static_cast<uint8_t>(GameState::GAME_OVER)) {
+        return false;
+    }
+    
+    if (!ReadSnapshotBody(reader) || reader.HasError() || !reader.AtEnd()) {
+        return false;
+    }
+    
+    SetState(static_cast<GameState>(state));
+    m_journal.Clear();
+    m_positionHash = ComputePositionHash();
+    return true;
+}
+
+bool Game::WriteSnapshotBody(SnapshotWriter&) const
+{
+    return false;
+}
+
+bool Game::ReadSnapshotBody(SnapshotReader&)
+{
+    return false;
+}
+
+uint32_t Game::GetSequence() const
+{
+    return m_sequence;
+}
+
+GameDelta Game::TakeDelta()
+{
+    GameDelta delta = m_pendingDelta;
+    delta.sequence = ++m_sequence;
+    
+    m_pendingDelta.Clear();
+    return delta;
+}
+
+bool Game::ApplyDelta(const GameDelta& delta)
+{
+    if (!SupportsDeltas() || delta.overflow || delta.sequence != m_sequence + 1) {
+        return false;
+    }
+    
+    for (size_t i = 0; i < delta.opCount; ++i) {
+        if (!ExecutePileOp(delta.ops[i])) {
+            return false;
+        }
+    }
+    
+    m_sequence = delta.sequence;
+    m_journal.Clear();
+    OnDeltaApplied();
+    return true;
+}
+
+void Game::ResetSequence(uint32_t sequence)
+{
+    m_sequence = sequence;
+    m_pendingDelta.Clear();
+    m_journal.Clear();
+}
+
+uint64_t Game::GetPositionHash() const
+{
+    return m_positionHash;
+}
+
+uint64_t Game::ComputePositionHash() const
+{
+    return 0;
+}
+
+bool Game::CanUndo() const
+{
+    return m_journal.CanUndo();
+}
+
+bool Game::CanRedo() const
+{
+    return m_journal.CanRedo();
+}
+
+bool Game::Undo()
+{
+    const PileOp* ops = nullptr;
+    size_t count = 0;
+    return m_journal.Undo(ops, count) && ReplayJournal(ops, count, true);
+}
+
+bool Game::Redo()
+{
+    const PileOp* ops = nullptr;
+    size_t count = 0;
+    return m_journal.Redo(ops, count) && ReplayJournal(ops, count, false);
+}
+
+bool Game::ExecutePileOp(const PileOp&)
+{
+    return false;
+}
+
+bool Game::ApplyPileOp(const PileOp& op)
+{
+    m_lastTransferFlipped = false;
+    if (!ExecutePileOp(op)) {
+        return false;
+    }
+    
+    m_pendingDelta.Add(op);
+    
+    // Face flags that turned nothing would not invert, so the journal drops them
+    PileOp journaled = op;
+    if (!m_lastTransferFlipped) {
+        journaled.flags &= ~(PILE_OP_FACE_UP | PILE_OP_FACE_DOWN);
+    }
+    m_journal.Record(journaled);
+    return true;
+}
+
+void Game::OnDeltaApplied()
+{
+}
+
+bool Game::TransferCards(PileView source, PileView target, const PileOp& op)
+{
+    bool flip = source.IsSamePile(target);
+    if (op.count == 0 || op.count > source.Size() ||
+        (!flip && op.count > target.GetCapacity() - target.Size())) {
+        return false;
+    }
+    
+    // Take the moved cards out of the hash, then add them back where they land
+    for (size_t i = source.Size() - op.count; i < source.Size(); ++i) {
+        m_positionHash ^= ZobristKey(op.source, i, source[i]);
+    }
+    
+    size_t start;
+    
+    if (flip) {
+        // A flip: the cards stay where they are
+        start = source.Size() - op.count;
+    } else {
+        start = target.Size();
+        size_t first = source.Size() - op.count;
+        for (size_t i = 0; i < op.count; ++i) {
+            target.Push(source[first + i]);
+        }
+        source.Pop(op.count);
+        
+        if (op.flags & PILE_OP_REVERSE) {
+            for (size_t i = start, j = target.Size() - 1; i < j; ++i, --j) {
+                std::swap(target[i], target[j]);
+            }
+        }
+    }
+    
+    if (op.flags & (PILE_OP_FACE_UP | PILE_OP_FACE_DOWN)) {
+        bool faceUp = (op.flags & PILE_OP_FACE_UP) != 0;
+        for (size_t i = start; i < target.Size(); ++i) {
+            if (target[i].IsFaceUp() != faceUp) {
+                target[i].SetFaceUp(faceUp);
+                m_lastTransferFlipped = true;
+            }
+        }
+    }
+    
+    for (size_t i = start; i < target.Size(); ++i) {
+        m_positionHash ^= ZobristKey(op.target, i, target[i]);
+    }
+    
+    return true;
+}
+
+bool Game::ReplayJournal(const PileOp* ops, size_t count, bool invert)
+{
+    for (size_t i = 0; i < count; ++i) {
+        PileOp op = invert ? MoveJournal::Invert(ops[count - 1 - i]) : ops[i];
+        if (!ExecutePileOp(op)) {
+            // The layout no longer matches the history
+            m_journal.Clear();
+            return false;
+        }
+        m_pendingDelta.Add(op);
+    }
+    
+    // An undo can take a won position back into play
+    if (m_state == GameState::GAME_OVER) {
+        SetState(GameState::IN_PROGRESS);
+    }
+    OnDeltaApplied();
+    return true;
+}
+
 } // namespace Core
 } // namespace CardGameLib
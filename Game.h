@@ -6,10 +6,54 @@
 #include <functional>
 #include "core/Player.h"
 #include "core/Deck.h"
+#include "core/GameDelta.h"
+#include "core/MoveJournal.h"
+#include "core/Zobrist.h"
+#include "core/Snapshot.h"
+#include "core/Move.h"
 
 namespace CardGameLib {
 namespace Core {
 
+// A pile as Game::TransferCards sees it: a card vector, or a one-card slot such as
+// a free cell, empty while it holds a blank Card. Views don't own their cards.
+class PileView {
+public:
+    PileView() : m_cards(nullptr), m_slot(nullptr) {}
+    PileView(std::vector<Card>& cards) : m_cards(&cards), m_slot(nullptr) {}
+    PileView(Card& slot) : m_cards(nullptr), m_slot(&slot) {}
+    
+    bool IsValid() const { return m_cards != nullptr || m_slot != nullptr; }
+    bool IsSamePile(const PileView& other) const { return m_cards == other.m_cards && m_slot == other.m_slot; }
+    
+    size_t Size() const { return m_cards ? m_cards->size() : (m_slot->IsBlank() ? 0 : 1); }
+    size_t GetCapacity() const { return m_cards ? m_cards->max_size() : 1; }
+    Card& operator[](size_t index) { return m_cards ? (*m_cards)[index] : *m_slot; }
+    
+    void Push(const Card& card)
+    {
+        if (m_cards) {
+            m_cards->push_back(card);
+        } else {
+            *m_slot = card;
+        }
+    }
+    
+    // Remove the top count cards
+    void Pop(size_t count)
+    {
+        if (m_cards) {
+            m_cards->erase(m_cards->end() - count, m_cards->end());
+        } else {
+            *m_slot = Card();
+        }
+    }
+    
+private:
+    std::vector<Card>* m_cards;
+    Card* m_slot;
+};
+
 enum class GameState {
     WAITING_FOR_PLAYERS,
     STARTING,
@@ -64,14 +108,76 @@ public:
     virtual std::shared_ptr<Player> GetCurrentPlayer() const;
     virtual void NextTurn();
     
-    // Game-specific actions (to be implemented by derived classes)
-    virtual bool IsValidMove(const std::string& moveData) = 0;
-    virtual bool MakeMove(int playerId, const std::string& moveData) = 0;
+    // Game-specific actions (to be implemented by derived classes). Moves are
+    // validated and applied in binary form, without parsing.
+    virtual bool IsValidMove(const Move& move) = 0;
+    virtual bool MakeMove(int playerId, const Move& move) = 0;
+    
+    // String move data adapters: parse once with ParseMove, then use the Move overloads
+    bool IsValidMove(const std::string& moveData);
+    bool MakeMove(int playerId, const std::string& moveData);
+    
+    // Parse string move data into a Move. Numeric "type arg arg" unless a game
+    // overrides it.
+    virtual bool ParseMove(const std::string& moveData, Move& move) const;
+    
+    // Replace the list's contents with every move IsValidMove accepts in the current
+    // position, for hints, autoplay and bots. Games without a generator list none.
+    virtual void GenerateMoves(MoveList& moves) const;
     
     // Game state serialization (for networking)
     virtual std::string SerializeGameState() const = 0;
     virtual bool DeserializeGameState(const std::string& data) = 0;
     
+    // Deal numbering. Every deal is generated from a 64-bit deal number so it can be
+    // replayed. SetDealNumber picks the number for the next deal; otherwise a random
+    // one is drawn.
+    void SetDealNumber(uint64_t dealNumber);
+    uint64_t GetDealNumber() const;
+    
+    // Draw random deals only from those the default DealIndex lists as winnable for
+    // this game and variant (falls back to any deal when it lists none)
+    void SetWinnableDealsOnly(bool winnableOnly);
+    bool GetWinnableDealsOnly() const;
+    
+    // Binary snapshots (saves, reconnects). WriteSnapshot fills a caller-supplied buffer
+    // without allocating and returns the number of bytes written, or 0 if the game has
+    // no binary form or the buffer is too small. MAX_SNAPSHOT_SIZE fits every game.
+    static constexpr size_t MAX_SNAPSHOT_SIZE = 256;
+    static constexpr uint8_t SNAPSHOT_VERSION = 1;
+    size_t WriteSnapshot(uint8_t* buffer, size_t capacity) const;
+    bool ReadSnapshot(const uint8_t* data, size_t size);
+    
+    // Delta sync (for networking). Pile-based games record each pile operation as
+    // moves are made. The server packages the operations of every accepted move with
+    // TakeDelta, and clients replay them with ApplyDelta instead of a full state.
+    virtual bool SupportsDeltas() const;
+    uint32_t GetSequence() const;
+    
+    // Stamp the operations recorded since the last call with the next sequence number
+    GameDelta TakeDelta();
+    
+    // Apply the delta following the current sequence. Fails on a gap or if an operation
+    // doesn't fit the layout; the state is then undefined until a full state is loaded.
+    bool ApplyDelta(const GameDelta& delta);
+    
+    // Set the sequence of a freshly loaded full state and drop pending operations
+    void ResetSequence(uint32_t sequence);
+    
+    // Zobrist hash of the card layout (0 for games without piles). Equal layouts hash
+    // equally on every build, so clients and servers can compare hashes after each
+    // move to detect desyncs, and the hash suits repetition checks and dedup.
+    uint64_t GetPositionHash() const;
+    
+    // Undo and redo for pile-based games. Each accepted move's pile operations are
+    // journaled; Undo applies their inverses and Redo applies them again, and both
+    // are recorded for the next delta. A new move drops the moves that could be
+    // redone, and a new deal or loaded state clears the history.
+    bool CanUndo() const;
+    bool CanRedo() const;
+    bool Undo();
+    bool Redo();
+    
 protected:
     std::string m_name;
     GameType m_type;
@@ -79,6 +185,55 @@ protected:
     std::vector<std::shared_ptr<Player>> m_players;
     GameState m_state;
     int m_currentPlayerIndex;
+    
+    // Number of the current deal, and whether SetDealNumber chose the next one
+    uint64_t m_dealNumber;
+    bool m_dealNumberSet;
+    bool m_winnableDealsOnly;
+    
+    // Deal number for a new deal
+    uint64_t NextDealNumber();
+    
+    // Variant of the game deals are indexed under (0 unless the deal depends on a setting)
+    virtual int GetDealVariant() const;
+    
+    // Delta sync state
+    uint32_t m_sequence;
+    GameDelta m_pendingDelta;
+    
+    // Undo history; games call m_journal.BeginMove() for each accepted move
+    MoveJournal m_journal;
+    bool m_lastTransferFlipped;
+    
+    // Kept up to date by TransferCards; games set it from ComputePositionHash after
+    // changing their piles any other way (dealing, loading a state)
+    uint64_t m_positionHash;
+    
+    // Hash of the current layout from scratch
+    virtual uint64_t ComputePositionHash() const;
+    
+    // Perform a pile operation on this game's layout (false if it doesn't fit)
+    virtual bool ExecutePileOp(const PileOp& op);
+    
+    // Perform a pile operation and record it for the next delta and the journal
+    bool ApplyPileOp(const PileOp& op);
+    
+    // Called after a delta has been applied, e.g. to detect the end of the game
+    virtual void OnDeltaApplied();
+    
+    // Game-specific snapshot contents after the common header (false if unsupported)
+    virtual bool WriteSnapshotBody(SnapshotWriter& writer) const;
+    virtual bool ReadSnapshotBody(SnapshotReader& reader);
+    
+    // Pile operation on two piles (which may be the same pile for a flip). Fails if
+    // the target can't hold the cards.
+    // Sets m_lastTransferFlipped if the face flags turned any card, and updates
+    // m_positionHash for the cards it moves.
+    bool TransferCards(PileView source, PileView target, const PileOp& op);
+    
+private:
+    // Apply journaled operations, inverted last to first for an undo
+    bool ReplayJournal(const PileOp* ops, size_t count, bool invert);
 };
 
 } // namespace Core
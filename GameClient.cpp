@@ -2,6 +2,13 @@
 #include <iostream>
 #include <vector>
 
+namespace {
+
+// Minimum free buffer space offered to each receive call
+const size_t MIN_RECEIVE_SIZE = 16 * 1024;
+
+} // namespace
+
 namespace CardGameLib {
 namespace Network {
 
@@ -45,6 +52,9 @@ bool GameClient::Connect(const std::string& host, int port)
     // Set non-blocking mode
     m_socket->SetNonBlocking(true);
     
+    // Start with an empty receive buffer
+    m_decoder.Reset();
+    
     // Start the receive thread
     m_connected = true;
     m_stopping = false;
@@ -88,18 +98,12 @@ bool GameClient::SendMessage(const std::string& message)
     }
     
     // Prepend message length as a 4-byte integer
-    uint32_t length = static_cast<uint32_t>(message.size());
     std::string finalMessage;
-    finalMessage.resize(4 + message.size());
-    
-    // Store the length in network byte order (big endian)
-    finalMessage[0] = static_cast<char>((length >> 24) & 0xFF);
-    finalMessage[1] = static_cast<char>((length >> 16) & 0xFF);
-    finalMessage[2] = static_cast<char>((length >> 8) & 0xFF);
-    finalMessage[3] = static_cast<char>(length & 0xFF);
+    finalMessage.resize(FrameDecoder::HEADER_SIZE + message.size());
+    FrameDecoder::EncodeHeader(static_cast<uint32_t>(message.size()), &finalMessage[0]);
     
     // Copy the message
-    std::copy(message.begin(), message.end(), finalMessage.begin() + 4);
+    std::copy(message.begin(), message.end(), finalMessage.begin() + FrameDecoder::HEADER_SIZE);
     
     // Send the message
     int bytesSent = m_socket->Send(finalMessage);
@@ -123,9 +127,14 @@ void GameClient::ReceiveLoop()
         bool activity = Socket::Select(readSockets, writeSockets, 0.1);
         
         if (activity && !readSockets.empty()) {
-            // Read the message length (4 bytes)
-            char lengthBuffer[4];
-            int bytesRead = m_socket->Receive(lengthBuffer, 4);
+            // Receive as much as fits into the buffer
+            size_t available = 0;
+            char* buffer = m_decoder.PrepareWrite(MIN_RECEIVE_SIZE, available);
+            int bytesRead = m_socket->Receive(buffer, static_cast<int>(available));
+            
+            if (bytesRead < 0 && Socket::WouldBlock()) {
+                continue;
+            }
             
             if (bytesRead <= 0) {
                 // Server disconnected or error
@@ -133,28 +142,20 @@ void GameClient::ReceiveLoop()
                 break;
             }
             
-            if (bytesRead == 4) {
-                // Extract the message length
-                uint32_t messageLength = 
-                    (static_cast<uint32_t>(lengthBuffer[0] & 0xFF) << 24) |
-                    (static_cast<uint32_t>(lengthBuffer[1] & 0xFF) << 16) |
-                    (static_cast<uint32_t>(lengthBuffer[2] & 0xFF) << 8) |
-                    (static_cast<uint32_t>(lengthBuffer[3] & 0xFF));
-                
-                // Read the message content
-                std::vector<char> messageBuffer(messageLength);
-                bytesRead = m_socket->Receive(messageBuffer.data(), messageLength);
-                
-                if (bytesRead == static_cast<int>(messageLength)) {
-                    // Process the message
-                    std::string message(messageBuffer.data(), messageLength);
-                    
-                    // Call the message callback
-                    if (m_messageCallback) {
-                        m_messageCallback(message);
-                    }
+            m_decoder.CommitWrite(bytesRead);
+            
+            // Dispatch every complete frame in the buffer
+            std::string_view message;
+            while (m_decoder.NextFrame(message)) {
+                if (m_messageCallback) {
+                    m_messageCallback(message);
                 }
             }
+            
+            if (m_decoder.HasError()) {
+                std::cerr << "Oversized frame from server" << std::endl;
+                break;
+            }
         }
     }
     
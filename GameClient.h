@@ -6,14 +6,17 @@
 #include <mutex>
 #include <functional>
 #include <memory>
+#include <string_view>
 
 #include "network/Socket.h"
+#include "network/FrameDecoder.h"
 
 namespace CardGameLib {
 namespace Network {
 
 // Define message callback type for client
-using ClientMessageCallback = std::function<void(const std::string& message)>;
+// The message view is only valid for the duration of the call
+using ClientMessageCallback = std::function<void(std::string_view message)>;
 
 class GameClient {
 public:
@@ -54,6 +57,9 @@ private:
     // Socket for server communication
     std::shared_ptr<Socket> m_socket;
     
+    // Partially received frames
+    FrameDecoder m_decoder;
+    
     // Message callback
     ClientMessageCallback m_messageCallback;
     
@@ -0,0 +1,75 @@
+#include "core/GameDelta.h"
+
+namespace CardGameLib {
+namespace Core {
+
+void GameDelta::Clear()
+{
+    sequence = 0;
+    opCount = 0;
+    overflow = false;
+}
+
+void GameDelta::Add(const PileOp& op)
+{
+    if (opCount >= MAX_OPS) {
+        overflow = true;
+        return;
+    }
+    
+    ops[opCount++] = op;
+}
+
+std::string GameDelta::Serialize() const
+{
+    std::string data(HEADER_SIZE + opCount * OP_SIZE, '\0');
+    
+    data[0] = static_cast<char>(sequence & 0xFF);
+    data[1] = static_cast<char>((sequence >> 8) & 0xFF);
+    data[2] = static_cast<char>((sequence >> 16) & 0xFF);
+    data[3] = static_cast<char>((sequence >> 24) & 0xFF);
+    data[4] = static_cast<char>(opCount);
+    
+    for (size_t i = 0; i < opCount; ++i) {
+        char* out = &data[HEADER_SIZE + i * OP_SIZE];
+        out[0] = static_cast<char>(ops[i].source);
+        out[1] = static_cast<char>(ops[i].target);
+        out[2] = static_cast<char>(ops[i].count);
+        out[3] = static_cast<char>(ops[i].flags);
+    }
+    
+    return data;
+}
+
+bool GameDelta::Deserialize(std::string_view data)
+{
+    Clear();
+    
+    if (data.size() < HEADER_SIZE) {
+        return false;
+    }
+    
+    size_t count = static_cast<uint8_t>(data[4]);
+    if (count > MAX_OPS || data.size() != HEADER_SIZE + count * OP_SIZE) {
+        return false;
+    }
+    
+    sequence = static_cast<uint32_t>(static_cast<uint8_t>(data[0])) |
+               (static_cast<uint32_t>(static_cast<uint8_t>(data[1])) << 8) |
+               (static_cast<uint32_t>(static_cast<uint8_t>(data[2])) << 16) |
+               (static_cast<uint32_t>(static_cast<uint8_t>(data[3])) << 24);
+    
+    for (size_t i = 0; i < count; ++i) {
+        const char* in = &data[HEADER_SIZE + i * OP_SIZE];
+        ops[i].source = static_cast<uint8_t>(in[0]);
+        ops[i].target = static_cast<uint8_t>(in[1]);
+        ops[i].count = static_cast<uint8_t>(in[2]);
+        ops[i].flags = static_cast<uint8_t>(in[3]);
+    }
+    
+    opCount = static_cast<uint8_t>(count);
+    return true;
+}
+
+} // namespace Core
+} // namespace CardGameLib
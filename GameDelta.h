@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+namespace CardGameLib {
+namespace Core {
+
+// Flags for a pile operation
+enum PileOpFlags : uint8_t {
+    PILE_OP_NONE      = 0,
+    PILE_OP_REVERSE   = 1 << 0,  // Moved cards land in reverse order
+    PILE_OP_FACE_UP   = 1 << 1,  // Turn moved cards face up
+    PILE_OP_FACE_DOWN = 1 << 2   // Turn moved cards face down
+};
+
+// One primitive change to a pile-based layout: take the top count cards of the
+// source pile and put them on the target pile, applying the flags. With source
+// equal to target the cards stay put and only the face flags apply (a flip).
+// Pile ids are defined by each game.
+struct PileOp {
+    uint8_t source;
+    uint8_t target;
+    uint8_t count;
+    uint8_t flags;
+};
+
+// Build a pile operation from game-side indices
+inline PileOp MakePileOp(int source, int target, size_t count, uint8_t flags = PILE_OP_NONE)
+{
+    return PileOp{ static_cast<uint8_t>(source), static_cast<uint8_t>(target),
+                   static_cast<uint8_t>(count), flags };
+}
+
+// The pile operations made by one accepted move, stamped with the sequence
+// number of the state they produce
+struct GameDelta {
+    // Enough for the largest single move of any supported game
+    static constexpr size_t MAX_OPS = 32;
+    
+    // Encoded size of the header and of each operation
+    static constexpr size_t HEADER_SIZE = 5;
+    static constexpr size_t OP_SIZE = 4;
+    
+    uint32_t sequence;
+    uint8_t opCount;
+    bool overflow;  // More operations than fit; send a full state instead
+    PileOp ops[MAX_OPS];
+    
+    GameDelta() : sequence(0), opCount(0), overflow(false), ops() {}
+    
+    void Clear();
+    
+    // Append an operation (sets overflow when full)
+    void Add(const PileOp& op);
+    
+    // Wire format: 4-byte little-endian sequence, op count, then 4 bytes per op
+    std::string Serialize() const;
+    bool Deserialize(std::string_view data);
+};
+
+} // namespace Core
+} // namespace CardGameLib
@@ -1,6 +1,13 @@
 #include "network/GameServer.h"
 #include <iostream>
 
+namespace {
+
+// Minimum free buffer space offered to each receive call
+const size_t MIN_RECEIVE_SIZE = 16 * 1024;
+
+} // namespace
+
 namespace CardGameLib {
 namespace Network {
 
@@ -9,6 +16,8 @@ GameServer::GameServer()
     , m_stopping(false)
     , m_port(0)
     , m_nextClientId(1)
+    , m_outboundHighWaterMark(OutboundQueue::DEFAULT_HIGH_WATER_MARK)
+    , m_slowConsumerPolicy(SlowConsumerPolicy::DISCONNECT)
 {
 }
 
@@ -45,12 +54,20 @@ bool GameServer::Start(int port)
     }
     
     // Start listening
-    if (!m_listenSocket->Listen()) {
+    if (!m_listenSocket->Listen(SOMAXCONN)) {
         std::cerr << "Failed to listen on port " << port << std::endl;
         m_listenSocket.reset();
         return false;
     }
     
+    // Create the event loop and watch the listen socket
+    if (!m_eventLoop.Create() || !m_eventLoop.Add(m_listenSocket->GetHandle(), EVENT_READ)) {
+        std::cerr << "Failed to create server event loop" << std::endl;
+        m_eventLoop.Close();
+        m_listenSocket.reset();
+        return false;
+    }
+    
     // Start the server thread
     m_running = true;
     m_stopping = false;
@@ -88,8 +105,18 @@ void GameServer::Stop()
             }
         }
         m_clients.clear();
+        m_clientsByHandle.clear();
+    }
+    
+    // Drop any flushes that were still scheduled
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pendingFlushes.clear();
     }
     
+    // Closing the event loop drops any remaining registrations
+    m_eventLoop.Close();
+    
     m_running = false;
 }
 
@@ -100,48 +127,68 @@ bool GameServer::IsRunning() const
 
 bool GameServer::SendToClient(int clientId, const std::string& message)
 {
-    std::lock_guard<std::mutex> lock(m_clientsMutex);
+    std::shared_ptr<ClientInfo> client;
     
-    auto it = m_clients.find(clientId);
-    if (it == m_clients.end() || !it->second || !it->second->socket) {
-        return false;
+    {
+        std::lock_guard<std::mutex> lock(m_clientsMutex);
+        
+        auto it = m_clients.find(clientId);
+        if (it == m_clients.end() || !it->second || !it->second->socket) {
+            return false;
+        }
+        
+        client = it->second;
     }
     
-    // Prepend message length as a 4-byte integer
-    uint32_t length = static_cast<uint32_t>(message.size());
-    std::string finalMessage;
-    finalMessage.resize(4 + message.size());
+    return QueueFrame(client, OutboundFrame::Create(message));
+}
+
+bool GameServer::SendToClients(const std::vector<int>& clientIds, const std::string& message)
+{
+    std::vector<std::shared_ptr<ClientInfo>> recipients;
+    recipients.reserve(clientIds.size());
     
-    // Store the length in network byte order (big endian)
-    finalMessage[0] = static_cast<char>((length >> 24) & 0xFF);
-    finalMessage[1] = static_cast<char>((length >> 16) & 0xFF);
-    finalMessage[2] = static_cast<char>((length >> 8) & 0xFF);
-    finalMessage[3] = static_cast<char>(length & 0xFF);
+    {
+        std::lock_guard<std::mutex> lock(m_clientsMutex);
+        
+        for (int clientId : clientIds) {
+            auto it = m_clients.find(clientId);
+            if (it != m_clients.end() && it->second && it->second->socket) {
+                recipients.push_back(it->second);
+            }
+        }
+    }
     
-    // Copy the message
-    std::copy(message.begin(), message.end(), finalMessage.begin() + 4);
+    if (recipients.empty()) {
+        return recipients.size() == clientIds.size();
+    }
     
-    // Send the message
-    int bytesSent = it->second->socket->Send(finalMessage);
+    bool allSent = QueueFrameForAll(recipients, OutboundFrame::Create(message));
     
-    return bytesSent == static_cast<int>(finalMessage.size());
+    return allSent && recipients.size() == clientIds.size();
 }
 
 bool GameServer::SendToAllClients(const std::string& message)
 {
-    std::lock_guard<std::mutex> lock(m_clientsMutex);
-    
-    bool allSent = true;
+    // Snapshot the recipients so the clients lock isn't held while queuing
+    std::vector<std::shared_ptr<ClientInfo>> recipients;
     
-    for (auto& client : m_clients) {
-        if (client.second && client.second->socket) {
-            if (!SendToClient(client.first, message)) {
-                allSent = false;
+    {
+        std::lock_guard<std::mutex> lock(m_clientsMutex);
+        
+        recipients.reserve(m_clients.size());
+        for (auto& client : m_clients) {
+            if (client.second && client.second->socket) {
+                recipients.push_back(client.second);
             }
         }
     }
     
-    return allSent;
+    if (recipients.empty()) {
+        return true;
+    }
+    
+    return QueueFrameForAll(recipients, OutboundFrame::Create(message));
 }
 
 void GameServer::DisconnectClient(int clientId)
@@ -167,134 +214,265 @@ void GameServer::SetMessageCallback(ServerMessageCallback callback)
     m_messageCallback = callback;
 }
 
+void GameServer::SetOutboundHighWaterMark(size_t bytes)
+{
+    m_outboundHighWaterMark = bytes;
+}
+
+void GameServer::SetSlowConsumerPolicy(SlowConsumerPolicy policy)
+{
+    m_slowConsumerPolicy = policy;
+}
+
 void GameServer::ServerLoop()
 {
+    std::vector<SocketEvent> events;
+    SocketHandle listenHandle = m_listenSocket->GetHandle();
+    
     // Main server loop
     while (!m_stopping.load()) {
-        // Set up the sockets for select
-        std::vector<Socket*> readSockets;
-        std::vector<Socket*> writeSockets;
-        
-        // Add the listen socket for reading
-        readSockets.push_back(m_listenSocket.get());
+        // Wait for activity (with a timeout so Stop() is noticed);
+        // queuing an outgoing message wakes the loop early
+        m_eventLoop.Wait(events, 0.1);
         
-        // Add all client sockets for reading
-        {
-            std::lock_guard<std::mutex> lock(m_clientsMutex);
-            for (auto& client : m_clients) {
-                if (client.second && client.second->socket) {
-                    readSockets.push_back(client.second->socket.get());
-                }
+        // Only the sockets that became ready are visited
+        for (const SocketEvent& event : events) {
+            if (event.handle == listenHandle) {
+                AcceptConnections();
+                continue;
             }
-        }
-        
-        // Wait for activity (with a timeout)
-        bool activity = Socket::Select(readSockets, writeSockets, 0.1);
-        
-        if (activity) {
-            // Check for new connections
-            AcceptConnections(readSockets);
             
-            // Check for client messages
-            ReceiveMessages(readSockets);
+            if (event.flags & (EVENT_READ | EVENT_ERROR)) {
+                ReceiveMessages(event.handle);
+            }
+            
+            if (event.flags & EVENT_WRITE) {
+                FlushClient(event.handle);
+            }
         }
+        
+        // Write everything queued since the last pass, batching frames per client
+        FlushPendingClients();
     }
     
     m_running = false;
 }
 
-void GameServer::AcceptConnections(std::vector<Socket*>& readySockets)
+void GameServer::AcceptConnections()
 {
-    // Check if the listen socket is ready for reading (new connection)
-    auto it = std::find(readySockets.begin(), readySockets.end(), m_listenSocket.get());
-    if (it != readySockets.end()) {
-        // Accept the new connection
+    // Edge-triggered: accept until the backlog is empty
+    while (true) {
         Socket* clientSocket = m_listenSocket->Accept();
-        if (clientSocket) {
-            // Set non-blocking mode
-            clientSocket->SetNonBlocking(true);
-            
-            // Add the client
-            int clientId = AddClient(std::shared_ptr<Socket>(clientSocket));
-            
-            std::cout << "New client connected: ID=" << clientId 
-                    << ", Address=" << clientSocket->GetRemoteAddress() 
-                    << ", Port=" << clientSocket->GetRemotePort() << std::endl;
+        if (!clientSocket) {
+            break;
+        }
+        
+        // Set non-blocking mode
+        clientSocket->SetNonBlocking(true);
+        
+        // Add the client
+        std::shared_ptr<Socket> socket(clientSocket);
+        int clientId = AddClient(socket);
+        if (clientId < 0) {
+            std::cerr << "Failed to register client socket" << std::endl;
+            continue;
         }
+        
+        std::cout << "New client connected: ID=" << clientId 
+                << ", Address=" << socket->GetRemoteAddress() 
+                << ", Port=" << socket->GetRemotePort() << std::endl;
     }
 }
 
-void GameServer::ReceiveMessages(std::vector<Socket*>& readySockets)
+void GameServer::ReceiveMessages(SocketHandle handle)
 {
-    // Check for messages from clients
     std::lock_guard<std::mutex> lock(m_clientsMutex);
     
-    for (auto& client : m_clients) {
-        if (!client.second || !client.second->socket) {
-            continue;
+    // Look up the connection by its socket handle
+    auto clientIt = m_clientsByHandle.find(handle);
+    if (clientIt == m_clientsByHandle.end()) {
+        return;
+    }
+    
+    std::shared_ptr<ClientInfo> client = clientIt->second;
+    Socket* socket = client->socket.get();
+    
+    // Edge-triggered: keep reading until the socket would block. A short read doesn't
+    // mean the socket is drained; a hang-up arriving with the data is only seen as the
+    // 0-byte read after it, and there is no further edge to report it.
+    while (true) {
+        // Receive as much as fits into the connection's buffer
+        size_t available = 0;
+        char* buffer = client->decoder.PrepareWrite(MIN_RECEIVE_SIZE, available);
+        int bytesRead = socket->Receive(buffer, static_cast<int>(available));
+        
+        if (bytesRead < 0 && Socket::WouldBlock()) {
+            break;
         }
         
-        Socket* socket = client.second->socket.get();
+        if (bytesRead <= 0) {
+            // Client disconnected or error
+            std::cout << "Client disconnected: ID=" << client->id << std::endl;
+            RemoveClientLocked(client);
+            return;
+        }
         
-        // Check if this socket is ready for reading
-        auto it = std::find(readySockets.begin(), readySockets.end(), socket);
-        if (it != readySockets.end()) {
-            // Read the message length (4 bytes)
-            char lengthBuffer[4];
-            int bytesRead = socket->Receive(lengthBuffer, 4);
-            
-            if (bytesRead <= 0) {
-                // Client disconnected or error
-                std::cout << "Client disconnected: ID=" << client.first << std::endl;
-                // Mark for removal
-                client.second->socket.reset();
-                continue;
+        client->decoder.CommitWrite(bytesRead);
+        
+        // Dispatch every complete frame in the buffer
+        std::string_view message;
+        while (client->decoder.NextFrame(message)) {
+            if (m_messageCallback) {
+                m_messageCallback(message, client->id);
             }
-            
-            if (bytesRead == 4) {
-                // Extract the message length
-                uint32_t messageLength = 
-                    (static_cast<uint32_t>(lengthBuffer[0] & 0xFF) << 24) |
-                    (static_cast<uint32_t>(lengthBuffer[1] & 0xFF) << 16) |
-                    (static_cast<uint32_t>(lengthBuffer[2] & 0xFF) << 8) |
-                    (static_cast<uint32_t>(lengthBuffer[3] & 0xFF));
-                
-                // Read the message content
-                std::vector<char> messageBuffer(messageLength);
-                bytesRead = socket->Receive(messageBuffer.data(), messageLength);
-                
-                if (bytesRead == static_cast<int>(messageLength)) {
-                    // Process the message
-                    std::string message(messageBuffer.data(), messageLength);
-                    
-                    // Call the message callback
-                    if (m_messageCallback) {
-                        m_messageCallback(message, client.first);
-                    }
-                }
+        }
+        
+        if (client->decoder.HasError()) {
+            std::cerr << "Oversized frame from client ID=" << client->id << std::endl;
+            RemoveClientLocked(client);
+            return;
+        }
+    }
+}
+
+bool GameServer::QueueFrame(const std::shared_ptr<ClientInfo>& client, const SharedFrame& frame)
+{
+    bool queued = false;
+    
+    {
+        std::lock_guard<std::mutex> sendLock(client->sendMutex);
+        
+        if (client->closing) {
+            return false;
+        }
+        
+        queued = client->outbound.Push(frame);
+        
+        if (!queued) {
+            // Over the high-water mark: shed the message or the client
+            if (m_slowConsumerPolicy.load() == SlowConsumerPolicy::DROP_MESSAGES) {
+                return false;
             }
+            
+            client->closing = true;
+        }
+        
+        // Already scheduled, or waiting for writability which will flush it
+        if (client->flushScheduled || (client->writeArmed && !client->closing)) {
+            return queued;
+        }
+        
+        client->flushScheduled = true;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pendingFlushes.push_back(client);
+    }
+    
+    m_eventLoop.Wakeup();
+    
+    return queued;
+}
+
+bool GameServer::QueueFrameForAll(const std::vector<std::shared_ptr<ClientInfo>>& recipients, const SharedFrame& frame)
+{
+    bool allSent = true;
+    
+    for (const auto& client : recipients) {
+        if (!QueueFrame(client, frame)) {
+            allSent = false;
         }
     }
     
-    // Remove disconnected clients
-    for (auto it = m_clients.begin(); it != m_clients.end();) {
-        if (!it->second || !it->second->socket) {
-            it = m_clients.erase(it);
-        } else {
-            ++it;
+    return allSent;
+}
+
+void GameServer::FlushPendingClients()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        if (m_pendingFlushes.empty()) {
+            return;
         }
+        
+        // Swap so both vectors keep their capacity between passes
+        m_flushBatch.swap(m_pendingFlushes);
     }
+    
+    for (const auto& client : m_flushBatch) {
+        if (!FlushClientQueue(*client)) {
+            std::cout << "Dropping client: ID=" << client->id << std::endl;
+            RemoveClient(client->id);
+        }
+    }
+    
+    m_flushBatch.clear();
+}
+
+void GameServer::FlushClient(SocketHandle handle)
+{
+    std::shared_ptr<ClientInfo> client;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_clientsMutex);
+        
+        auto it = m_clientsByHandle.find(handle);
+        if (it == m_clientsByHandle.end()) {
+            return;
+        }
+        
+        client = it->second;
+    }
+    
+    if (!FlushClientQueue(*client)) {
+        std::cout << "Dropping client: ID=" << client->id << std::endl;
+        RemoveClient(client->id);
+    }
+}
+
+bool GameServer::FlushClientQueue(ClientInfo& client)
+{
+    std::lock_guard<std::mutex> sendLock(client.sendMutex);
+    
+    client.flushScheduled = false;
+    
+    if (client.closing || !client.socket || !client.socket->IsValid()) {
+        return false;
+    }
+    
+    FlushResult result = client.outbound.Flush(*client.socket);
+    if (result == FlushResult::FAILED) {
+        return false;
+    }
+    
+    // Only watch for writability while frames are stuck in the queue
+    bool wantWrite = (result == FlushResult::PENDING);
+    if (wantWrite != client.writeArmed) {
+        m_eventLoop.Modify(client.socket->GetHandle(), wantWrite ? (EVENT_READ | EVENT_WRITE) : EVENT_READ);
+        client.writeArmed = wantWrite;
+    }
+    
+    return true;
 }
 
 int GameServer::AddClient(std::shared_ptr<Socket> socket)
 {
     std::lock_guard<std::mutex> lock(m_clientsMutex);
     
+    // Watch the socket before publishing the client
+    if (!m_eventLoop.Add(socket->GetHandle(), EVENT_READ)) {
+        return -1;
+    }
+    
     int clientId = m_nextClientId++;
     std::string address = socket->GetRemoteAddress();
     int port = socket->GetRemotePort();
     
-    m_clients[clientId] = std::make_shared<ClientInfo>(clientId, socket, address, port);
+    auto client = std::make_shared<ClientInfo>(clientId, socket, address, port);
+    client->outbound.SetHighWaterMark(m_outboundHighWaterMark.load());
+    m_clients[clientId] = client;
+    m_clientsByHandle[socket->GetHandle()] = client;
     
     return clientId;
 }
@@ -305,12 +483,33 @@ void GameServer::RemoveClient(int clientId)
     
     auto it = m_clients.find(clientId);
     if (it != m_clients.end()) {
-        if (it->second && it->second->socket) {
-            it->second->socket->Close();
-        }
-        m_clients.erase(it);
+        // Copy the reference; RemoveClientLocked erases the map entry
+        std::shared_ptr<ClientInfo> client = it->second;
+        RemoveClientLocked(client);
     }
 }
 
+void GameServer::RemoveClientLocked(const std::shared_ptr<ClientInfo>& client)
+{
+    if (!client) {
+        return;
+    }
+    
+    if (client->socket) {
+        // Unregister before closing so a reused handle is never misrouted
+        SocketHandle handle = client->socket->GetHandle();
+        m_eventLoop.Remove(handle);
+        m_clientsByHandle.erase(handle);
+        
+        // Wait out any flush in progress before closing
+        std::lock_guard<std::mutex> sendLock(client->sendMutex);
+        client->socket->Close();
+        client->outbound.Clear();
+        client->closing = true;
+    }
+    
+    m_clients.erase(client->id);
+}
+
 } // namespace Network
 } // namespace CardGameLib
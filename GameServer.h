@@ -8,14 +8,25 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <string_view>
 
 #include "network/Socket.h"
+#include "network/EventLoop.h"
+#include "network/FrameDecoder.h"
+#include "network/OutboundQueue.h"
 
 namespace CardGameLib {
 namespace Network {
 
 // Define message callback type for server
-using ServerMessageCallback = std::function<void(const std::string& message, int clientId)>;
+// The message view is only valid for the duration of the call
+using ServerMessageCallback = std::function<void(std::string_view message, int clientId)>;
+
+// What to do with a client whose unsent data reaches the high-water mark
+enum class SlowConsumerPolicy {
+    DISCONNECT,     // Close the connection
+    DROP_MESSAGES   // Discard new messages until the queue drains
+};
 
 // Client connection info
 struct ClientInfo {
@@ -23,9 +34,18 @@ struct ClientInfo {
     std::shared_ptr<Socket> socket;
     std::string address;
     int port;
+    FrameDecoder decoder;   // Partially received frames (server thread only)
+    
+    // Outgoing frames; everything below is guarded by sendMutex
+    std::mutex sendMutex;
+    OutboundQueue outbound;
+    bool flushScheduled;    // Queued for the server thread to flush
+    bool writeArmed;        // Waiting for the socket to become writable
+    bool closing;           // Marked for disconnection as a slow consumer
     
     ClientInfo(int id, std::shared_ptr<Socket> socket, const std::string& address, int port)
-        : id(id), socket(socket), address(address), port(port) {}
+        : id(id), socket(socket), address(address), port(port)
+        , flushScheduled(false), writeArmed(false), closing(false) {}
 };
 
 class GameServer {
@@ -42,10 +62,15 @@ public:
     // Check if the server is running
     bool IsRunning() const;
     
-    // Send a message to a specific client
+    // Queue a message for a specific client; it is written by the server thread.
+    // Returns false if the client is unknown or over its high-water mark.
     bool SendToClient(int clientId, const std::string& message);
     
-    // Send a message to all connected clients
+    // Send a message to a list of clients (e.g. the players of one game).
+    // The message is framed once and the frame is shared by every recipient.
+    bool SendToClients(const std::vector<int>& clientIds, const std::string& message);
+    
+    // Send a message to all connected clients, framed once
     bool SendToAllClients(const std::string& message);
     
     // Disconnect a specific client
@@ -57,6 +82,10 @@ public:
     // Set callback for incoming messages
     void SetMessageCallback(ServerMessageCallback callback);
     
+    // Backpressure for slow clients (applies to connections accepted afterwards)
+    void SetOutboundHighWaterMark(size_t bytes);
+    void SetSlowConsumerPolicy(SlowConsumerPolicy policy);
+    
 private:
     // Server state
     std::atomic<bool> m_running;
@@ -66,31 +95,62 @@ private:
     // Socket for accepting connections
     std::shared_ptr<Socket> m_listenSocket;
     
-    // Connected clients
+    // Readiness notification for the listen socket and all clients
+    EventLoop m_eventLoop;
+    
+    // Connected clients, indexed by client ID and by socket handle
     std::unordered_map<int, std::shared_ptr<ClientInfo>> m_clients;
+    std::unordered_map<SocketHandle, std::shared_ptr<ClientInfo>> m_clientsByHandle;
     mutable std::mutex m_clientsMutex;  // mutable to allow locking in const methods
     int m_nextClientId;
     
     // Message callback
     ServerMessageCallback m_messageCallback;
     
+    // Backpressure settings
+    std::atomic<size_t> m_outboundHighWaterMark;
+    std::atomic<SlowConsumerPolicy> m_slowConsumerPolicy;
+    
+    // Clients with newly queued frames, flushed by the server thread
+    std::vector<std::shared_ptr<ClientInfo>> m_pendingFlushes;
+    std::vector<std::shared_ptr<ClientInfo>> m_flushBatch;  // Server thread only
+    std::mutex m_pendingMutex;
+    
     // Server thread
     std::thread m_serverThread;
     
     // Server loop
     void ServerLoop();
     
-    // Accept new connections
-    void AcceptConnections(std::vector<Socket*>& readySockets);
+    // Accept all pending connections
+    void AcceptConnections();
+    
+    // Receive all pending messages from a ready client
+    void ReceiveMessages(SocketHandle handle);
+    
+    // Queue a frame and schedule the client for flushing
+    bool QueueFrame(const std::shared_ptr<ClientInfo>& client, const SharedFrame& frame);
+    
+    // Queue one shared frame for several clients
+    bool QueueFrameForAll(const std::vector<std::shared_ptr<ClientInfo>>& recipients, const SharedFrame& frame);
     
-    // Receive messages from clients
-    void ReceiveMessages(std::vector<Socket*>& readySockets);
+    // Write queued frames for all scheduled clients
+    void FlushPendingClients();
+    
+    // Write queued frames for a client whose socket became writable
+    void FlushClient(SocketHandle handle);
+    
+    // Drain a client's queue and update its write interest; false if it must be dropped
+    bool FlushClientQueue(ClientInfo& client);
     
     // Add a new client
     int AddClient(std::shared_ptr<Socket> socket);
     
     // Remove a client
     void RemoveClient(int clientId);
+    
+    // Unregister and close a client (m_clientsMutex must be held)
+    void RemoveClientLocked(const std::shared_ptr<ClientInfo>& client);
 };
 
 } // namespace Network
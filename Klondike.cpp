@@ -1,4 +1,5 @@
 #include "games/solitaire/Klondike.h"
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 
@@ -6,9 +7,20 @@ namespace CardGameLib {
 namespace Games {
 namespace Solitaire {
 
-Klondike::Klondike()
+namespace {
+    // True if card continues a tableau run on top of below
+    bool ExtendsRun(const Core::Card& card, const Core::Card& below)
+    {
+        return card.IsFaceUp() && below.IsFaceUp() && card.GetColor() != below.GetColor() &&
+               static_cast<int>(card.GetRank()) == static_cast<int>(below.GetRank()) - 1;
+    }
+}
+
+Klondike::Klondike(bool winnableDealsOnly)
     : Core::Game("Klondike", Core::GameType::SOLITAIRE_KLONDIKE, 1)
+    , m_tableauInfo()
 {
+    SetWinnableDealsOnly(winnableDealsOnly);
 }
 
 void Klondike::Initialize()
@@ -22,8 +34,18 @@ bool Klondike::Start()
         return false;
     }
     
+    // A deal number set since the last Reset takes effect now
+    if (m_dealNumberSet) {
+        Reset();
+    }
+    
     SetState(Core::GameState::STARTING);
-    DealInitialLayout();
+    
+    // After Deal (or a loaded position) the cards are already out
+    if (!IsLayoutDealt()) {
+        DealInitialLayout();
+    }
+    
     SetState(Core::GameState::IN_PROGRESS);
     return true;
 }
@@ -37,8 +59,7 @@ bool Klondike::CanStart() const
 void Klondike::Reset()
 {
     // Create a new shuffled deck
-    m_stock = Core::Deck();
-    m_stock.Shuffle();
+    m_stock = Core::Deck(1, NextDealNumber());
     
     // Clear all other piles
     m_waste.clear();
@@ -51,183 +72,208 @@ void Klondike::Reset()
         pile.clear();
     }
     
+    RebuildTableauInfo();
+    m_positionHash = ComputePositionHash();
+    
     SetState(Core::GameState::WAITING_FOR_PLAYERS);
 }
 
-bool Klondike::IsValidMove(const std::string& moveData)
+void Klondike::Deal(uint64_t dealNumber)
 {
-    std::istringstream ss(moveData);
-    std::string moveTypeStr;
-    ss >> moveTypeStr;
-    
-    try {
-        KlondikeMoveType moveType = static_cast<KlondikeMoveType>(std::stoi(moveTypeStr));
-        
-        switch (moveType) {
-            case KlondikeMoveType::DRAW_FROM_STOCK:
-                return !m_stock.IsEmpty();
-                
-            case KlondikeMoveType::WASTE_TO_TABLEAU: {
-                int tableauIndex;
-                ss >> tableauIndex;
-                
-                if (tableauIndex < 0 || tableauIndex >= 7 || m_waste.empty()) {
-                    return false;
-                }
-                
-                const Core::Card& card = m_waste.back();
-                return IsValidTableauToTableauMove(card, m_tableau[tableauIndex]);
-            }
-                
-            case KlondikeMoveType::WASTE_TO_FOUNDATION: {
-                int foundationIndex;
-                ss >> foundationIndex;
-                
-                if (foundationIndex < 0 || foundationIndex >= 4 || m_waste.empty()) {
-                    return false;
-                }
-                
-                const Core::Card& card = m_waste.back();
-                return IsValidCardForFoundation(card, m_foundations[foundationIndex]);
+    SetDealNumber(dealNumber);
+    Reset();
+    DealInitialLayout();
+}
+
+bool Klondike::IsValidMove(const Core::Move& move)
+{
+    switch (static_cast<KlondikeMoveType>(move.type)) {
+        case KlondikeMoveType::DRAW_FROM_STOCK:
+            return !m_stock.IsEmpty();
+            
+        case KlondikeMoveType::WASTE_TO_TABLEAU: {
+            int tableauIndex = move.args[0];
+            
+            if (tableauIndex >= 7 || m_waste.empty()) {
+                return false;
             }
-                
-            case KlondikeMoveType::TABLEAU_TO_FOUNDATION: {
-                int tableauIndex, foundationIndex;
-                ss >> tableauIndex >> foundationIndex;
-                
-                if (tableauIndex < 0 || tableauIndex >= 7 || 
-                    foundationIndex < 0 || foundationIndex >= 4 ||
-                    m_tableau[tableauIndex].empty()) {
-                    return false;
-                }
-                
-                const Core::Card& card = m_tableau[tableauIndex].back();
-                return card.IsFaceUp() && IsValidCardForFoundation(card, m_foundations[foundationIndex]);
+            
+            const Core::Card& card = m_waste.back();
+            return IsValidTableauToTableauMove(card, m_tableau[tableauIndex]);
+        }
+            
+        case KlondikeMoveType::WASTE_TO_FOUNDATION: {
+            int foundationIndex = move.args[0];
+            
+            if (foundationIndex >= 4 || m_waste.empty()) {
+                return false;
             }
-                
-            case KlondikeMoveType::TABLEAU_TO_TABLEAU: {
-                int sourceIndex, targetIndex, cardCount;
-                ss >> sourceIndex >> targetIndex >> cardCount;
-                
-                if (sourceIndex < 0 || sourceIndex >= 7 || 
-                    targetIndex < 0 || targetIndex >= 7 || 
-                    sourceIndex == targetIndex ||
-                    m_tableau[sourceIndex].empty() ||
-                    cardCount <= 0 || cardCount > static_cast<int>(m_tableau[sourceIndex].size())) {
-                    return false;
-                }
-                
-                // Find the first face-up card in the source pile
-                size_t firstFaceUpIndex = 0;
-                for (size_t i = 0; i < m_tableau[sourceIndex].size(); ++i) {
-                    if (m_tableau[sourceIndex][i].IsFaceUp()) {
-                        firstFaceUpIndex = i;
-                        break;
-                    }
-                }
-                
-                // Check if we're trying to move face-down cards
-                if (m_tableau[sourceIndex].size() - cardCount < firstFaceUpIndex) {
-                    return false;
-                }
-                
-                // Get the card we're trying to move
-                size_t cardIndex = m_tableau[sourceIndex].size() - cardCount;
-                const Core::Card& card = m_tableau[sourceIndex][cardIndex];
-                
-                return IsValidTableauToTableauMove(card, m_tableau[targetIndex]);
+            
+            const Core::Card& card = m_waste.back();
+            return IsValidCardForFoundation(card, m_foundations[foundationIndex]);
+        }
+            
+        case KlondikeMoveType::TABLEAU_TO_FOUNDATION: {
+            int tableauIndex = move.args[0];
+            int foundationIndex = move.args[1];
+            
+            if (tableauIndex >= 7 || foundationIndex >= 4 || m_tableau[tableauIndex].empty()) {
+                return false;
             }
-                
-            case KlondikeMoveType::FOUNDATION_TO_TABLEAU: {
-                int foundationIndex, tableauIndex;
-                ss >> foundationIndex >> tableauIndex;
-                
-                if (foundationIndex < 0 || foundationIndex >= 4 || 
-                    tableauIndex < 0 || tableauIndex >= 7 ||
-                    m_foundations[foundationIndex].empty()) {
-                    return false;
-                }
-                
-                const Core::Card& card = m_foundations[foundationIndex].back();
-                return IsValidTableauToTableauMove(card, m_tableau[tableauIndex]);
+            
+            const Core::Card& card = m_tableau[tableauIndex].back();
+            return card.IsFaceUp() && IsValidCardForFoundation(card, m_foundations[foundationIndex]);
+        }
+            
+        case KlondikeMoveType::TABLEAU_TO_TABLEAU: {
+            int sourceIndex = move.args[0];
+            int targetIndex = move.args[1];
+            int cardCount = move.args[2];
+            
+            // Only cards of the run on top of the source pile can move
+            if (sourceIndex >= 7 || targetIndex >= 7 || 
+                sourceIndex == targetIndex ||
+                cardCount <= 0 || cardCount > m_tableauInfo[sourceIndex].runLength) {
+                return false;
             }
-                
-            case KlondikeMoveType::RECYCLE_WASTE:
-                return m_stock.IsEmpty() && !m_waste.empty();
-                
-            default:
+            
+            // Get the card we're trying to move
+            size_t cardIndex = m_tableau[sourceIndex].size() - cardCount;
+            const Core::Card& card = m_tableau[sourceIndex][cardIndex];
+            
+            return IsValidTableauToTableauMove(card, m_tableau[targetIndex]);
+        }
+            
+        case KlondikeMoveType::FOUNDATION_TO_TABLEAU: {
+            int foundationIndex = move.args[0];
+            int tableauIndex = move.args[1];
+            
+            if (foundationIndex >= 4 || tableauIndex >= 7 || m_foundations[foundationIndex].empty()) {
                 return false;
+            }
+            
+            const Core::Card& card = m_foundations[foundationIndex].back();
+            return IsValidTableauToTableauMove(card, m_tableau[tableauIndex]);
         }
-    } catch (const std::exception&) {
-        return false;
+            
+        case KlondikeMoveType::RECYCLE_WASTE:
+            return m_stock.IsEmpty() && !m_waste.empty();
+            
+        default:
+            return false;
     }
-    
-    return false;
 }
 
-bool Klondike::MakeMove(int playerId, const std::string& moveData)
+bool Klondike::MakeMove(int playerId, const Core::Move& move)
 {
     // Only the current player can make moves
     if (m_players.empty() || m_players[0]->GetId() != playerId) {
         return false;
     }
     
-    if (!IsValidMove(moveData)) {
+    if (!IsValidMove(move)) {
         return false;
     }
     
-    std::istringstream ss(moveData);
-    std::string moveTypeStr;
-    ss >> moveTypeStr;
+    // Journal the move's pile operations for undo
+    m_journal.BeginMove();
     
-    try {
-        KlondikeMoveType moveType = static_cast<KlondikeMoveType>(std::stoi(moveTypeStr));
-        
-        switch (moveType) {
-            case KlondikeMoveType::DRAW_FROM_STOCK:
-                return DrawFromStock();
-                
-            case KlondikeMoveType::WASTE_TO_TABLEAU: {
-                int tableauIndex;
-                ss >> tableauIndex;
-                return MoveWasteToTableau(tableauIndex);
+    switch (static_cast<KlondikeMoveType>(move.type)) {
+        case KlondikeMoveType::DRAW_FROM_STOCK:
+            return DrawFromStock();
+            
+        case KlondikeMoveType::WASTE_TO_TABLEAU:
+            return MoveWasteToTableau(move.args[0]);
+            
+        case KlondikeMoveType::WASTE_TO_FOUNDATION:
+            return MoveWasteToFoundation(move.args[0]);
+            
+        case KlondikeMoveType::TABLEAU_TO_FOUNDATION:
+            return MoveTableauToFoundation(move.args[0], move.args[1]);
+            
+        case KlondikeMoveType::TABLEAU_TO_TABLEAU:
+            return MoveTableauToTableau(move.args[0], move.args[1], move.args[2]);
+            
+        case KlondikeMoveType::FOUNDATION_TO_TABLEAU:
+            return MoveFoundationToTableau(move.args[0], move.args[1]);
+            
+        case KlondikeMoveType::RECYCLE_WASTE:
+            return RecycleWaste();
+            
+        default:
+            return false;
+    }
+}
+
+void Klondike::GenerateMoves(Core::MoveList& moves) const
+{
+    moves.Clear();
+    
+    if (!m_stock.IsEmpty()) {
+        moves.Add(Core::Move::Make(KlondikeMoveType::DRAW_FROM_STOCK));
+    } else if (!m_waste.empty()) {
+        moves.Add(Core::Move::Make(KlondikeMoveType::RECYCLE_WASTE));
+    }
+    
+    if (!m_waste.empty()) {
+        const Core::Card& card = m_waste.back();
+        for (int tableauIndex = 0; tableauIndex < 7; ++tableauIndex) {
+            if (IsValidTableauToTableauMove(card, m_tableau[tableauIndex])) {
+                moves.Add(Core::Move::Make(KlondikeMoveType::WASTE_TO_TABLEAU, tableauIndex));
             }
-                
-            case KlondikeMoveType::WASTE_TO_FOUNDATION: {
-                int foundationIndex;
-                ss >> foundationIndex;
-                return MoveWasteToFoundation(foundationIndex);
+        }
+        for (int foundationIndex = 0; foundationIndex < 4; ++foundationIndex) {
+            if (IsValidCardForFoundation(card, m_foundations[foundationIndex])) {
+                moves.Add(Core::Move::Make(KlondikeMoveType::WASTE_TO_FOUNDATION, foundationIndex));
             }
-                
-            case KlondikeMoveType::TABLEAU_TO_FOUNDATION: {
-                int tableauIndex, foundationIndex;
-                ss >> tableauIndex >> foundationIndex;
-                return MoveTableauToFoundation(tableauIndex, foundationIndex);
+        }
+    }
+    
+    for (int foundationIndex = 0; foundationIndex < 4; ++foundationIndex) {
+        if (m_foundations[foundationIndex].empty()) {
+            continue;
+        }
+        const Core::Card& card = m_foundations[foundationIndex].back();
+        for (int tableauIndex = 0; tableauIndex < 7; ++tableauIndex) {
+            if (IsValidTableauToTableauMove(card, m_tableau[tableauIndex])) {
+                moves.Add(Core::Move::Make(KlondikeMoveType::FOUNDATION_TO_TABLEAU, foundationIndex, tableauIndex));
             }
-                
-            case KlondikeMoveType::TABLEAU_TO_TABLEAU: {
-                int sourceIndex, targetIndex, cardCount;
-                ss >> sourceIndex >> targetIndex >> cardCount;
-                return MoveTableauToTableau(sourceIndex, targetIndex, cardCount);
+        }
+    }
+    
+    for (int sourceIndex = 0; sourceIndex < 7; ++sourceIndex) {
+        const std::vector<Core::Card>& source = m_tableau[sourceIndex];
+        if (source.empty() || !source.back().IsFaceUp()) {
+            continue;
+        }
+        
+        const Core::Card& top = source.back();
+        for (int foundationIndex = 0; foundationIndex < 4; ++foundationIndex) {
+            if (IsValidCardForFoundation(top, m_foundations[foundationIndex])) {
+                moves.Add(Core::Move::Make(KlondikeMoveType::TABLEAU_TO_FOUNDATION, sourceIndex, foundationIndex));
             }
-                
-            case KlondikeMoveType::FOUNDATION_TO_TABLEAU: {
-                int foundationIndex, tableauIndex;
-                ss >> foundationIndex >> tableauIndex;
-                return MoveFoundationToTableau(foundationIndex, tableauIndex);
+        }
+        
+        // The card that fits a target sits at a fixed distance from the top of the
+        // run, so only one count per target can work
+        int runLength = m_tableauInfo[sourceIndex].runLength;
+        int topRank = static_cast<int>(top.GetRank());
+        for (int targetIndex = 0; targetIndex < 7; ++targetIndex) {
+            if (targetIndex == sourceIndex) {
+                continue;
+            }
+            
+            const std::vector<Core::Card>& target = m_tableau[targetIndex];
+            int baseRank = target.empty() ? static_cast<int>(Core::Rank::KING)
+                                          : static_cast<int>(target.back().GetRank()) - 1;
+            int cardCount = baseRank - topRank + 1;
+            
+            if (cardCount >= 1 && cardCount <= runLength &&
+                IsValidTableauToTableauMove(source[source.size() - cardCount], target)) {
+                moves.Add(Core::Move::Make(KlondikeMoveType::TABLEAU_TO_TABLEAU, sourceIndex, targetIndex, cardCount));
             }
-                
-            case KlondikeMoveType::RECYCLE_WASTE:
-                return RecycleWaste();
-                
-            default:
-                return false;
         }
-    } catch (const std::exception&) {
-        return false;
     }
-    
-    return false;
 }
 
 std::string Klondike::SerializeGameState() const
@@ -353,6 +399,10 @@ bool Klondike::DeserializeGameState(const std::string& data)
         }
     }
     
+    m_journal.Clear();
+    RebuildTableauInfo();
+    m_positionHash = ComputePositionHash();
+    
     // Set game state
     SetState(Core::GameState::IN_PROGRESS);
     
@@ -364,17 +414,50 @@ bool Klondike::DeserializeGameState(const std::string& data)
     return true;
 }
 
+bool Klondike::WriteSnapshotBody(Core::SnapshotWriter& writer) const
+{
+    writer.WritePile(m_stock.GetCards());
+    writer.WritePile(m_waste);
+    
+    for (const auto& foundation : m_foundations) {
+        writer.WritePile(foundation);
+    }
+    
+    for (const auto& pile : m_tableau) {
+        writer.WritePile(pile);
+    }
+    
+    return true;
+}
+
+bool Klondike::ReadSnapshotBody(Core::SnapshotReader& reader)
+{
+    m_stock.Clear();
+    m_waste.clear();
+    
+    bool ok = reader.ReadPile(m_stock.GetCards()) && reader.ReadPile(m_waste);
+    
+    for (auto& foundation : m_foundations) {
+        foundation.clear();
+        ok = ok && reader.ReadPile(foundation);
+    }
+    
+    for (auto& pile : m_tableau) {
+        pile.clear();
+        ok = ok && reader.ReadPile(pile);
+    }
+    
+    RebuildTableauInfo();
+    return ok;
+}
+
 bool Klondike::DrawFromStock()
 {
     if (m_stock.IsEmpty()) {
         return false;
     }
     
-    Core::Card card = m_stock.Draw();
-    card.SetFaceUp(true);
-    m_waste.push_back(card);
-    
-    return true;
+    return ApplyPileOp(Core::MakePileOp(STOCK_PILE, WASTE_PILE, 1, Core::PILE_OP_FACE_UP));
 }
 
 bool Klondike::MoveWasteToTableau(int tableauIndex)
@@ -388,10 +471,7 @@ bool Klondike::MoveWasteToTableau(int tableauIndex)
         return false;
     }
     
-    m_tableau[tableauIndex].push_back(m_waste.back());
-    m_waste.pop_back();
-    
-    return true;
+    return ApplyPileOp(Core::MakePileOp(WASTE_PILE, FIRST_TABLEAU_PILE + tableauIndex, 1));
 }
 
 bool Klondike::MoveWasteToFoundation(int foundationIndex)
@@ -405,8 +485,7 @@ bool Klondike::MoveWasteToFoundation(int foundationIndex)
         return false;
     }
     
-    m_foundations[foundationIndex].push_back(m_waste.back());
-    m_waste.pop_back();
+    ApplyPileOp(Core::MakePileOp(WASTE_PILE, FIRST_FOUNDATION_PILE + foundationIndex, 1));
     
     // Check for win condition
     if (IsGameWon()) {
@@ -429,13 +508,10 @@ bool Klondike::MoveTableauToFoundation(int tableauIndex, int foundationIndex)
         return false;
     }
     
-    m_foundations[foundationIndex].push_back(m_tableau[tableauIndex].back());
-    m_tableau[tableauIndex].pop_back();
+    ApplyPileOp(Core::MakePileOp(FIRST_TABLEAU_PILE + tableauIndex, FIRST_FOUNDATION_PILE + foundationIndex, 1));
     
     // Flip the now-exposed card if any
-    if (!m_tableau[tableauIndex].empty() && !m_tableau[tableauIndex].back().IsFaceUp()) {
-        m_tableau[tableauIndex].back().SetFaceUp(true);
-    }
+    RevealTableauTop(tableauIndex);
     
     // Check for win condition
     if (IsGameWon()) {
@@ -450,22 +526,7 @@ bool Klondike::MoveTableauToTableau(int sourceIndex, int targetIndex, int cardCo
     if (sourceIndex < 0 || sourceIndex >= 7 || 
         targetIndex < 0 || targetIndex >= 7 || 
         sourceIndex == targetIndex ||
-        m_tableau[sourceIndex].empty() ||
-        cardCount <= 0 || cardCount > static_cast<int>(m_tableau[sourceIndex].size())) {
-        return false;
-    }
-    
-    // Find the first face-up card in the source pile
-    size_t firstFaceUpIndex = 0;
-    for (size_t i = 0; i < m_tableau[sourceIndex].size(); ++i) {
-        if (m_tableau[sourceIndex][i].IsFaceUp()) {
-            firstFaceUpIndex = i;
-            break;
-        }
-    }
-    
-    // Check if we're trying to move face-down cards
-    if (m_tableau[sourceIndex].size() - cardCount < firstFaceUpIndex) {
+        cardCount <= 0 || cardCount > m_tableauInfo[sourceIndex].runLength) {
         return false;
     }
     
@@ -478,21 +539,10 @@ bool Klondike::MoveTableauToTableau(int sourceIndex, int targetIndex, int cardCo
     }
     
     // Move the cards
-    std::vector<Core::Card> cardsToMove;
-    cardsToMove.insert(cardsToMove.begin(), 
-                      m_tableau[sourceIndex].begin() + cardIndex,
-                      m_tableau[sourceIndex].end());
-    
-    m_tableau[targetIndex].insert(m_tableau[targetIndex].end(),
-                                 cardsToMove.begin(), cardsToMove.end());
-    
-    m_tableau[sourceIndex].erase(m_tableau[sourceIndex].begin() + cardIndex,
-                               m_tableau[sourceIndex].end());
+    ApplyPileOp(Core::MakePileOp(FIRST_TABLEAU_PILE + sourceIndex, FIRST_TABLEAU_PILE + targetIndex, cardCount));
     
     // Flip the now-exposed card if any
-    if (!m_tableau[sourceIndex].empty() && !m_tableau[sourceIndex].back().IsFaceUp()) {
-        m_tableau[sourceIndex].back().SetFaceUp(true);
-    }
+    RevealTableauTop(sourceIndex);
     
     return true;
 }
@@ -510,10 +560,7 @@ bool Klondike::MoveFoundationToTableau(int foundationIndex, int tableauIndex)
         return false;
     }
     
-    m_tableau[tableauIndex].push_back(m_foundations[foundationIndex].back());
-    m_foundations[foundationIndex].pop_back();
-    
-    return true;
+    return ApplyPileOp(Core::MakePileOp(FIRST_FOUNDATION_PILE + foundationIndex, FIRST_TABLEAU_PILE + tableauIndex, 1));
 }
 
 bool Klondike::RecycleWaste()
@@ -523,17 +570,83 @@ bool Klondike::RecycleWaste()
     }
     
     // Move all waste cards back to stock in reverse order (maintaining their order)
-    for (auto it = m_waste.rbegin(); it != m_waste.rend(); ++it) {
-        Core::Card card = *it;
-        card.SetFaceUp(false);
-        m_stock.AddCard(card);
+    return ApplyPileOp(Core::MakePileOp(WASTE_PILE, STOCK_PILE, m_waste.size(),
+                                        Core::PILE_OP_REVERSE | Core::PILE_OP_FACE_DOWN));
+}
+
+bool Klondike::SupportsDeltas() const
+{
+    return true;
+}
+
+bool Klondike::ExecutePileOp(const Core::PileOp& op)
+{
+    std::vector<Core::Card>* source = GetPile(op.source);
+    std::vector<Core::Card>* target = GetPile(op.target);
+    
+    if (!source || !target) {
+        return false;
     }
     
-    m_waste.clear();
+    size_t sourceSize = source->size();
+    size_t targetSize = target->size();
+    
+    if (!TransferCards(*source, *target, op)) {
+        return false;
+    }
+    
+    // A flip keeps the cards in place, so its pile is updated once
+    if (op.source >= FIRST_TABLEAU_PILE) {
+        UpdateTableauInfo(op.source - FIRST_TABLEAU_PILE, sourceSize, sourceSize - op.count);
+    }
+    if (op.target >= FIRST_TABLEAU_PILE && op.target != op.source) {
+        UpdateTableauInfo(op.target - FIRST_TABLEAU_PILE, targetSize, targetSize);
+    }
     
     return true;
 }
 
+void Klondike::OnDeltaApplied()
+{
+    // Check for win condition
+    if (IsGameWon()) {
+        SetState(Core::GameState::GAME_OVER);
+    }
+}
+
+uint64_t Klondike::ComputePositionHash() const
+{
+    uint64_t hash = Core::ZobristPileHash(STOCK_PILE, m_stock.GetCards()) ^ Core::ZobristPileHash(WASTE_PILE, m_waste);
+    
+    for (size_t i = 0; i < m_foundations.size(); ++i) {
+        hash ^= Core::ZobristPileHash(FIRST_FOUNDATION_PILE + static_cast<int>(i), m_foundations[i]);
+    }
+    
+    for (size_t i = 0; i < m_tableau.size(); ++i) {
+        hash ^= Core::ZobristPileHash(FIRST_TABLEAU_PILE + static_cast<int>(i), m_tableau[i]);
+    }
+    
+    return hash;
+}
+
+std::vector<Core::Card>* Klondike::GetPile(int pileId)
+{
+    if (pileId == STOCK_PILE) {
+        return &m_stock.GetCards();
+    }
+    if (pileId == WASTE_PILE) {
+        return &m_waste;
+    }
+    if (pileId >= FIRST_FOUNDATION_PILE && pileId < FIRST_FOUNDATION_PILE + static_cast<int>(m_foundations.size())) {
+        return &m_foundations[pileId - FIRST_FOUNDATION_PILE];
+    }
+    if (pileId >= FIRST_TABLEAU_PILE && pileId < FIRST_TABLEAU_PILE + static_cast<int>(m_tableau.size())) {
+        return &m_tableau[pileId - FIRST_TABLEAU_PILE];
+    }
+    
+    return nullptr;
+}
+
 bool Klondike::IsGameWon() const
 {
     // Game is won when all foundations have 13 cards each (A through K of each suit)
@@ -566,6 +679,16 @@ const std::array<std::vector<Core::Card>, 7>& Klondike::GetTableau() const
     return m_tableau;
 }
 
+int Klondike::GetTableauFaceDownCount(int tableauIndex) const
+{
+    return m_tableauInfo[tableauIndex].faceDown;
+}
+
+int Klondike::GetTableauRunLength(int tableauIndex) const
+{
+    return m_tableauInfo[tableauIndex].runLength;
+}
+
 bool Klondike::IsValidTableauToTableauMove(const Core::Card& card, const std::vector<Core::Card>& targetPile) const
 {
     if (targetPile.empty()) {
@@ -595,8 +718,21 @@ bool Klondike::IsValidCardForFoundation(const Core::Card& card, const std::vecto
     }
 }
 
+void Klondike::RevealTableauTop(int tableauIndex)
+{
+    const std::vector<Core::Card>& pile = m_tableau[tableauIndex];
+    
+    if (!pile.empty() && !pile.back().IsFaceUp()) {
+        int pileId = FIRST_TABLEAU_PILE + tableauIndex;
+        ApplyPileOp(Core::MakePileOp(pileId, pileId, 1, Core::PILE_OP_FACE_UP));
+    }
+}
+
 void Klondike::DealInitialLayout()
 {
+    // A new deal starts a fresh undo history
+    m_journal.Clear();
+    
     // Deal cards to tableau
     for (int i = 0; i < 7; ++i) {
         for (int j = i; j < 7; ++j) {
@@ -610,6 +746,77 @@ void Klondike::DealInitialLayout()
             m_tableau[j].push_back(card);
         }
     }
+    
+    RebuildTableauInfo();
+    m_positionHash = ComputePositionHash();
+}
+
+bool Klondike::IsLayoutDealt() const
+{
+    if (!m_waste.empty()) {
+        return true;
+    }
+    
+    for (const auto& foundation : m_foundations) {
+        if (!foundation.empty()) {
+            return true;
+        }
+    }
+    
+    for (const auto& pile : m_tableau) {
+        if (!pile.empty()) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+void Klondike::UpdateTableauInfo(int tableauIndex, size_t oldSize, size_t keptCards)
+{
+    const std::vector<Core::Card>& pile = m_tableau[tableauIndex];
+    TableauInfo& info = m_tableauInfo[tableauIndex];
+    
+    size_t faceDown = std::min<size_t>(info.faceDown, keptCards);
+    size_t removed = oldSize - keptCards;
+    size_t run;
+    
+    if (info.runLength > removed) {
+        run = info.runLength - removed;
+    } else {
+        // The old run is gone; measure the one below it (usually ended by a
+        // face-down card right away)
+        run = 0;
+        while (run < keptCards - faceDown &&
+               (run == 0 ? pile[keptCards - 1].IsFaceUp()
+                         : ExtendsRun(pile[keptCards - run], pile[keptCards - run - 1]))) {
+            run++;
+        }
+    }
+    
+    for (size_t i = keptCards; i < pile.size(); ++i) {
+        if (!pile[i].IsFaceUp()) {
+            if (faceDown == i) {
+                faceDown++;
+            }
+            run = 0;
+        } else if (run > 0 && ExtendsRun(pile[i], pile[i - 1])) {
+            run++;
+        } else {
+            run = 1;
+        }
+    }
+    
+    info.faceDown = static_cast<uint8_t>(faceDown);
+    info.runLength = static_cast<uint8_t>(run);
+}
+
+void Klondike::RebuildTableauInfo()
+{
+    for (int i = 0; i < 7; ++i) {
+        m_tableauInfo[i] = TableauInfo();
+        UpdateTableauInfo(i, 0, 0);
+    }
 }
 
 } // namespace Solitaire
@@ -25,8 +25,8 @@ enum class KlondikeMoveType {
 // Klondike game implementation
 class Klondike : public Core::Game {
 public:
-    // Constructor
-    Klondike();
+    // Constructor. With winnableDealsOnly, random deals come from the default DealIndex.
+    explicit Klondike(bool winnableDealsOnly = false);
     
     // Game setup
     virtual void Initialize() override;
@@ -34,13 +34,28 @@ public:
     virtual bool CanStart() const override;
     virtual void Reset() override;
     
+    // Reset to a numbered deal and lay out the tableau without waiting for a player
+    // (solvers, previews). The game state is left at WAITING_FOR_PLAYERS; Start then
+    // plays this layout.
+    void Deal(uint64_t dealNumber);
+    
     // Game moves
-    virtual bool IsValidMove(const std::string& moveData) override;
-    virtual bool MakeMove(int playerId, const std::string& moveData) override;
+    using Core::Game::IsValidMove;
+    using Core::Game::MakeMove;
+    virtual bool IsValidMove(const Core::Move& move) override;
+    virtual bool MakeMove(int playerId, const Core::Move& move) override;
+    virtual void GenerateMoves(Core::MoveList& moves) const override;
     
     // Game state serialization
     virtual std::string SerializeGameState() const override;
     virtual bool DeserializeGameState(const std::string& data) override;
+    virtual bool SupportsDeltas() const override;
+    
+    // Pile ids used in game deltas
+    static constexpr int STOCK_PILE = 0;
+    static constexpr int WASTE_PILE = 1;
+    static constexpr int FIRST_FOUNDATION_PILE = 2;
+    static constexpr int FIRST_TABLEAU_PILE = 6;
     
     // Klondike-specific methods
     bool DrawFromStock();
@@ -60,6 +75,12 @@ public:
     const std::array<std::vector<Core::Card>, 4>& GetFoundations() const;
     const std::array<std::vector<Core::Card>, 7>& GetTableau() const;
     
+    // Face-down cards at the bottom of a tableau pile, and the length of the valid
+    // run (face up, descending, alternating colors) on its top. Both are kept up to
+    // date as cards move.
+    int GetTableauFaceDownCount(int tableauIndex) const;
+    int GetTableauRunLength(int tableauIndex) const;
+    
 private:
     // Game components
     Core::Deck m_stock;                    // Stock/draw pile
@@ -67,10 +88,34 @@ private:
     std::array<std::vector<Core::Card>, 4> m_foundations; // 4 foundation piles (A to K by suit)
     std::array<std::vector<Core::Card>, 7> m_tableau;     // 7 tableau piles
     
+    // Cached shape of each tableau pile, updated by ExecutePileOp
+    struct TableauInfo {
+        uint8_t faceDown;   // Index of the first face-up card
+        uint8_t runLength;  // Cards in the valid run on top (0 if the top card is face down)
+    };
+    std::array<TableauInfo, 7> m_tableauInfo;
+    
+    // Binary snapshot: stock, waste, foundations, tableau
+    virtual bool WriteSnapshotBody(Core::SnapshotWriter& writer) const override;
+    virtual bool ReadSnapshotBody(Core::SnapshotReader& reader) override;
+    
+    // Delta sync
+    virtual bool ExecutePileOp(const Core::PileOp& op) override;
+    virtual void OnDeltaApplied() override;
+    virtual uint64_t ComputePositionHash() const override;
+    std::vector<Core::Card>* GetPile(int pileId);
+    
     // Helper methods
     bool IsValidTableauToTableauMove(const Core::Card& card, const std::vector<Core::Card>& targetPile) const;
     bool IsValidCardForFoundation(const Core::Card& card, const std::vector<Core::Card>& foundation) const;
+    void RevealTableauTop(int tableauIndex);
     void DealInitialLayout();
+    bool IsLayoutDealt() const;
+    
+    // Update a pile's cached shape after an operation that left its bottom
+    // keptCards cards alone, in O(cards moved) unless the pile's run was taken
+    void UpdateTableauInfo(int tableauIndex, size_t oldSize, size_t keptCards);
+    void RebuildTableauInfo();
 };
 
 } // namespace Solitaire
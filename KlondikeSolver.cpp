@@ -0,0 +1,561 @@
+#include "games/solitaire/KlondikeSolver.h"
+#include "core/Rng.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+namespace CardGameLib {
+namespace Games {
+namespace Solitaire {
+
+namespace {
+    const int TABLEAU_PILES = 7;
+    const int SUITS = 4;
+    const int CARDS = 52;
+    const int MAX_TALON = 24;
+    const int MAX_DOWN = 6;
+    const int MAX_PILE = MAX_DOWN + 13;
+    const int MAX_MOVES = 128;
+    const size_t MAX_DEPTH = 1000;  // Winning lines are far shorter; bounds the recursion
+    
+    // Random keys for the position hash
+    struct ZobristKeys {
+        uint64_t card[CARDS][MAX_PILE];               // Face-up card at a depth in a pile
+        uint64_t down[TABLEAU_PILES][MAX_DOWN + 1];   // Face-down cards left in a dealt pile
+        uint64_t talon[CARDS];                        // Card still in the stock or waste
+        
+        ZobristKeys()
+        {
+            Core::Rng rng(0x4B4C4F4E44494B45ULL);
+            FillKeys(rng, &card[0][0], CARDS * MAX_PILE);
+            for (auto& keys : down) {
+                keys[0] = 0;
+                FillKeys(rng, keys + 1, MAX_DOWN);
+            }
+            FillKeys(rng, talon, CARDS);
+        }
+    };
+    
+    enum SolverMoveKind : uint8_t {
+        TABLEAU_TO_FOUNDATION,
+        TALON_TO_FOUNDATION,
+        TABLEAU_TO_TABLEAU,
+        TALON_TO_TABLEAU,
+        FOUNDATION_TO_TABLEAU
+    };
+    
+    // A move of the search. Talon moves name the talon index of the card.
+    struct SolverMove {
+        uint8_t kind;
+        uint8_t from;
+        uint8_t to;
+        uint8_t count;
+    };
+    
+    // Compact Klondike position. Only the tableau and talon are hashed: the
+    // foundations hold whatever is left, and the number of cards drawn only changes
+    // how many draws reach a talon card.
+    struct Position : SuitFoundations {
+        uint8_t tableau[TABLEAU_PILES][MAX_PILE];  // Bottom to top
+        uint8_t size[TABLEAU_PILES];
+        uint8_t down[TABLEAU_PILES];               // Face-down cards at the bottom
+        uint8_t origin[TABLEAU_PILES];             // Dealt pile the face-down cards came from
+        uint8_t talon[MAX_TALON];                  // Waste bottom to top, then stock top to bottom
+        uint8_t talonSize;
+        uint8_t wasteCount;
+        uint64_t pileHash[TABLEAU_PILES];
+        uint64_t talonHash;
+        
+        uint64_t GetHash() const
+        {
+            // Summing the pile hashes makes the hash independent of the pile order
+            uint64_t hash = talonHash;
+            for (uint64_t pile : pileHash) {
+                hash += pile;
+            }
+            return hash;
+        }
+        
+        bool HasFaceUp(int pile) const { return size[pile] > down[pile]; }
+        uint8_t Top(int pile) const { return tableau[pile][size[pile] - 1]; }
+        
+        // Every card face up and nothing left to draw: playing up to the
+        // foundations always finishes
+        bool IsCleared() const
+        {
+            if (talonSize != 0) {
+                return false;
+            }
+            for (uint8_t count : down) {
+                if (count != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        
+        void Push(int pile, uint8_t card)
+        {
+            pileHash[pile] ^= GetKeys<ZobristKeys>().card[card][size[pile]];
+            tableau[pile][size[pile]++] = card;
+        }
+        
+        void Pop(int pile, int count)
+        {
+            for (int i = size[pile] - count; i < size[pile]; ++i) {
+                pileHash[pile] ^= GetKeys<ZobristKeys>().card[tableau[pile][i]][i];
+            }
+            size[pile] = static_cast<uint8_t>(size[pile] - count);
+            
+            // Turn the newly exposed card
+            if (size[pile] > 0 && down[pile] == size[pile]) {
+                const ZobristKeys& keys = GetKeys<ZobristKeys>();
+                int d = down[pile];
+                pileHash[pile] ^= keys.down[origin[pile]][d] ^ keys.down[origin[pile]][d - 1] ^
+                                  keys.card[tableau[pile][d - 1]][d - 1];
+                down[pile]--;
+            }
+        }
+        
+        uint8_t TakeTalon(int index)
+        {
+            uint8_t card = talon[index];
+            talonHash ^= GetKeys<ZobristKeys>().talon[card];
+            std::memmove(talon + index, talon + index + 1, talonSize - index - 1);
+            talonSize--;
+            wasteCount = static_cast<uint8_t>(index);
+            return card;
+        }
+        
+        void Apply(const SolverMove& move)
+        {
+            switch (move.kind) {
+                case TABLEAU_TO_FOUNDATION: {
+                    uint8_t card = Top(move.from);
+                    Pop(move.from, 1);
+                    AddToFoundation(card);
+                    break;
+                }
+                case TALON_TO_FOUNDATION:
+                    AddToFoundation(TakeTalon(move.from));
+                    break;
+                case TABLEAU_TO_TABLEAU: {
+                    int first = size[move.from] - move.count;
+                    for (int i = 0; i < move.count; ++i) {
+                        Push(move.to, tableau[move.from][first + i]);
+                    }
+                    Pop(move.from, move.count);
+                    break;
+                }
+                case TALON_TO_TABLEAU:
+                    Push(move.to, TakeTalon(move.from));
+                    break;
+                case FOUNDATION_TO_TABLEAU: {
+                    int suit = move.from;
+                    foundation[suit]--;
+                    Push(move.to, static_cast<uint8_t>(suit * 13 + foundation[suit]));
+                    break;
+                }
+            }
+        }
+        
+        // Klondike move data for a move from this position, including any draws
+        void Describe(const SolverMove& move, std::vector<std::string>& out) const
+        {
+            if (move.kind == TALON_TO_FOUNDATION || move.kind == TALON_TO_TABLEAU) {
+                // Bring the card to the top of the waste
+                int drawCount;
+                if (move.from + 1 >= wasteCount) {
+                    drawCount = move.from + 1 - wasteCount;
+                } else {
+                    for (int i = wasteCount; i < talonSize; ++i) {
+                        out.push_back(MoveData(KlondikeMoveType::DRAW_FROM_STOCK));
+                    }
+                    out.push_back(MoveData(KlondikeMoveType::RECYCLE_WASTE));
+                    drawCount = move.from + 1;
+                }
+                for (int i = 0; i < drawCount; ++i) {
+                    out.push_back(MoveData(KlondikeMoveType::DRAW_FROM_STOCK));
+                }
+            }
+            
+            switch (move.kind) {
+                case TABLEAU_TO_FOUNDATION:
+                    out.push_back(MoveData(KlondikeMoveType::TABLEAU_TO_FOUNDATION, move.from,
+                                           GetFoundationSlot(Top(move.from))));
+                    break;
+                case TALON_TO_FOUNDATION:
+                    out.push_back(MoveData(KlondikeMoveType::WASTE_TO_FOUNDATION,
+                                           GetFoundationSlot(talon[move.from])));
+                    break;
+                case TABLEAU_TO_TABLEAU:
+                    out.push_back(MoveData(KlondikeMoveType::TABLEAU_TO_TABLEAU, move.from, move.to, move.count));
+                    break;
+                case TALON_TO_TABLEAU:
+                    out.push_back(MoveData(KlondikeMoveType::WASTE_TO_TABLEAU, move.to));
+                    break;
+                case FOUNDATION_TO_TABLEAU:
+                    out.push_back(MoveData(KlondikeMoveType::FOUNDATION_TO_TABLEAU, foundationSlot[move.from], move.to));
+                    break;
+            }
+        }
+    };
+    
+    Position MakePosition(const Klondike& game)
+    {
+        Position position;
+        std::memset(&position, 0, sizeof(position));
+        std::fill(position.foundationSlot, position.foundationSlot + SUITS, -1);
+        
+        const ZobristKeys& keys = GetKeys<ZobristKeys>();
+        
+        const auto& tableau = game.GetTableau();
+        for (int pile = 0; pile < TABLEAU_PILES; ++pile) {
+            position.origin[pile] = static_cast<uint8_t>(pile);
+            for (const Core::Card& card : tableau[pile]) {
+                if (position.size[pile] >= MAX_PILE) {
+                    break;
+                }
+                if (!card.IsFaceUp() && position.down[pile] == position.size[pile] && position.down[pile] < MAX_DOWN) {
+                    position.down[pile]++;
+                    position.tableau[pile][position.size[pile]++] = static_cast<uint8_t>(card.GetIndex());
+                } else {
+                    position.Push(pile, static_cast<uint8_t>(card.GetIndex()));
+                }
+            }
+            position.pileHash[pile] ^= keys.down[pile][position.down[pile]];
+        }
+        
+        // Waste bottom to top, then the stock from its top (the back of the deck)
+        for (const Core::Card& card : game.GetWaste()) {
+            position.talon[position.talonSize++] = static_cast<uint8_t>(card.GetIndex());
+        }
+        position.wasteCount = position.talonSize;
+        const auto& stock = game.GetStock().GetCards();
+        for (auto it = stock.rbegin(); it != stock.rend() && position.talonSize < MAX_TALON; ++it) {
+            position.talon[position.talonSize++] = static_cast<uint8_t>(it->GetIndex());
+        }
+        for (int i = 0; i < position.talonSize; ++i) {
+            position.talonHash ^= keys.talon[position.talon[i]];
+        }
+        
+        const auto& foundations = game.GetFoundations();
+        for (int slot = 0; slot < SUITS; ++slot) {
+            if (!foundations[slot].empty()) {
+                int suit = static_cast<int>(foundations[slot].back().GetSuit());
+                position.foundation[suit] = static_cast<uint8_t>(foundations[slot].size());
+                position.foundationSlot[suit] = static_cast<int8_t>(slot);
+            }
+        }
+        
+        return position;
+    }
+    
+    // Depth-first search over a position
+    class Search {
+    public:
+        Search(TranspositionTable& table, size_t nodeBudget)
+            : m_table(table)
+            , m_nodeBudget(nodeBudget)
+            , m_nodes(0)
+            , m_exhausted(false)
+        {
+        }
+        
+        SolveResult Run(const Position& root)
+        {
+            m_table.NewSearch();
+            m_line.clear();
+            
+            Position position = root;
+            if (Solve(position, 0)) {
+                return SolveResult::SOLVED;
+            }
+            return m_exhausted ? SolveResult::BUDGET_EXHAUSTED : SolveResult::UNSOLVABLE;
+        }
+        
+        const std::vector<SolverMove>& GetLine() const { return m_line; }
+        size_t GetNodes() const { return m_nodes; }
+        
+    private:
+        TranspositionTable& m_table;
+        size_t m_nodeBudget;
+        size_t m_nodes;
+        bool m_exhausted;
+        std::vector<SolverMove> m_line;
+        
+        // Move lists and child positions of each ply. They are kept off the stack,
+        // so a deep line costs only a small call frame per ply; a deque never moves
+        // the frames of the plies still being searched as it grows.
+        struct Frame {
+            SolverMove moves[MAX_MOVES];
+            Position child;
+        };
+        std::deque<Frame> m_frames;
+        
+        bool Solve(Position& position, size_t depth)
+        {
+            if (++m_nodes > m_nodeBudget || m_line.size() > MAX_DEPTH) {
+                m_exhausted = true;
+                return false;
+            }
+            
+            size_t lineSize = m_line.size();
+            AutoMove(position);
+            
+            if (position.IsCleared()) {
+                Finish(position);
+                return true;
+            }
+            
+            if (!m_table.Insert(position.GetHash())) {
+                m_line.resize(lineSize);
+                return false;
+            }
+            
+            if (depth == m_frames.size()) {
+                m_frames.emplace_back();
+            }
+            Frame& frame = m_frames[depth];
+            int moveCount = GenerateMoves(position, frame.moves);
+            
+            for (int i = 0; i < moveCount && !m_exhausted; ++i) {
+                frame.child = position;
+                frame.child.Apply(frame.moves[i]);
+                m_line.push_back(frame.moves[i]);
+                
+                if (Solve(frame.child, depth + 1)) {
+                    return true;
+                }
+                
+                m_line.pop_back();
+            }
+            
+            m_line.resize(lineSize);
+            return false;
+        }
+        
+        void Play(Position& position, const SolverMove& move)
+        {
+            position.Apply(move);
+            m_line.push_back(move);
+        }
+        
+        // Make every safe foundation move
+        void AutoMove(Position& position)
+        {
+            bool moved = true;
+            while (moved) {
+                moved = false;
+                
+                for (int pile = 0; pile < TABLEAU_PILES; ++pile) {
+                    if (position.HasFaceUp(pile) && position.IsSafeForFoundation(position.Top(pile))) {
+                        Play(position, SolverMove{ TABLEAU_TO_FOUNDATION, static_cast<uint8_t>(pile), 0, 1 });
+                        moved = true;
+                    }
+                }
+                
+                for (int i = 0; i < position.talonSize; ++i) {
+                    if (position.IsSafeForFoundation(position.talon[i])) {
+                        Play(position, SolverMove{ TALON_TO_FOUNDATION, static_cast<uint8_t>(i), 0, 1 });
+                        moved = true;
+                        break;
+                    }
+                }
+            }
+        }
+        
+        // Play the remaining face-up cards up in rank order
+        void Finish(Position& position)
+        {
+            while (!position.IsWon()) {
+                for (int pile = 0; pile < TABLEAU_PILES; ++pile) {
+                    if (position.size[pile] > 0 && position.FitsFoundation(position.Top(pile))) {
+                        Play(position, SolverMove{ TABLEAU_TO_FOUNDATION, static_cast<uint8_t>(pile), 0, 1 });
+                    }
+                }
+            }
+        }
+        
+        // Candidate moves, most promising first
+        int GenerateMoves(const Position& position, SolverMove* moves) const
+        {
+            int count = 0;
+            auto add = [&](uint8_t kind, int from, int to, int cards) {
+                if (count < MAX_MOVES) {
+                    moves[count++] = SolverMove{ kind, static_cast<uint8_t>(from), static_cast<uint8_t>(to),
+                                                 static_cast<uint8_t>(cards) };
+                }
+            };
+            
+            int emptyPile = -1;
+            for (int pile = 0; pile < TABLEAU_PILES; ++pile) {
+                if (position.size[pile] == 0) {
+                    emptyPile = pile;
+                    break;
+                }
+            }
+            
+            // Tableau to foundation
+            for (int pile = 0; pile < TABLEAU_PILES; ++pile) {
+                if (position.HasFaceUp(pile) && position.FitsFoundation(position.Top(pile))) {
+                    add(TABLEAU_TO_FOUNDATION, pile, 0, 1);
+                }
+            }
+            
+            // An empty pile is only worth making while a king is not yet at the bottom of one
+            bool kingWaiting = false;
+            for (int i = 0; i < position.talonSize && !kingWaiting; ++i) {
+                kingWaiting = IndexRank(position.talon[i]) == 13;
+            }
+            for (int pile = 0; pile < TABLEAU_PILES && !kingWaiting; ++pile) {
+                for (int index = 1; index < position.size[pile] && !kingWaiting; ++index) {
+                    kingWaiting = IndexRank(position.tableau[pile][index]) == 13;
+                }
+            }
+            
+            // Whole face-up runs that turn a card or empty a pile, those turning the
+            // most face-down cards first, then partial runs that free a foundation card
+            int sources[TABLEAU_PILES];
+            for (int pile = 0; pile < TABLEAU_PILES; ++pile) {
+                sources[pile] = pile;
+            }
+            std::sort(sources, sources + TABLEAU_PILES, [&](int a, int b) {
+                return position.down[a] > position.down[b];
+            });
+            
+            for (int partial = 0; partial < 2; ++partial) {
+                for (int source : sources) {
+                    if (!position.HasFaceUp(source)) {
+                        continue;
+                    }
+                    
+                    int first = partial ? position.down[source] + 1 : position.down[source];
+                    int last = partial ? position.size[source] - 1 : position.down[source];
+                    
+                    for (int index = first; index <= last; ++index) {
+                        uint8_t card = position.tableau[source][index];
+                        int cards = position.size[source] - index;
+                        
+                        if (partial ? !position.FitsFoundation(position.tableau[source][index - 1])
+                                    : (index == 0 && !kingWaiting)) {
+                            continue;
+                        }
+                        
+                        for (int target = 0; target < TABLEAU_PILES; ++target) {
+                            if (target != source && position.size[target] > 0 &&
+                                IndexBuildsOn(card, position.Top(target))) {
+                                add(TABLEAU_TO_TABLEAU, source, target, cards);
+                            }
+                        }
+                        
+                        // A king to an empty pile only helps if it leaves something behind
+                        if (emptyPile >= 0 && IndexRank(card) == 13 && index > 0) {
+                            add(TABLEAU_TO_TABLEAU, source, emptyPile, cards);
+                        }
+                    }
+                }
+            }
+            
+            // Talon cards
+            for (int i = position.talonSize - 1; i >= 0; --i) {
+                uint8_t card = position.talon[i];
+                
+                if (position.FitsFoundation(card)) {
+                    add(TALON_TO_FOUNDATION, i, 0, 1);
+                }
+                
+                for (int target = 0; target < TABLEAU_PILES; ++target) {
+                    if (position.size[target] > 0 && IndexBuildsOn(card, position.Top(target))) {
+                        add(TALON_TO_TABLEAU, i, target, 1);
+                    }
+                }
+                
+                if (emptyPile >= 0 && IndexRank(card) == 13) {
+                    add(TALON_TO_TABLEAU, i, emptyPile, 1);
+                }
+            }
+            
+            // Foundation cards back down (safe ones would only be moved straight back)
+            for (int suit = 0; suit < SUITS; ++suit) {
+                if (position.foundation[suit] == 0) {
+                    continue;
+                }
+                
+                uint8_t card = static_cast<uint8_t>(suit * 13 + position.foundation[suit] - 1);
+                Position without = position;
+                without.foundation[suit]--;
+                if (without.IsSafeForFoundation(card)) {
+                    continue;
+                }
+                
+                for (int target = 0; target < TABLEAU_PILES; ++target) {
+                    if (position.size[target] > 0 && IndexBuildsOn(card, position.Top(target))) {
+                        add(FOUNDATION_TO_TABLEAU, suit, target, 1);
+                    }
+                }
+            }
+            
+            return count;
+        }
+    };
+}
+
+KlondikeSolver::KlondikeSolver(size_t nodeBudget)
+    : m_table()
+    , m_nodeBudget(nodeBudget)
+    , m_nodesSearched(0)
+{
+}
+
+SolveResult KlondikeSolver::Solve(const Klondike& game)
+{
+    m_solution.clear();
+    
+    Position root = MakePosition(game);
+    Search search(m_table, m_nodeBudget);
+    SolveResult result = search.Run(root);
+    m_nodesSearched = search.GetNodes();
+    
+    if (result == SolveResult::SOLVED) {
+        // Replay the line to add the draws and foundation indices
+        Position position = root;
+        for (const SolverMove& move : search.GetLine()) {
+            position.Describe(move, m_solution);
+            position.Apply(move);
+        }
+    }
+    
+    return result;
+}
+
+SolveResult KlondikeSolver::SolveDeal(uint64_t dealNumber)
+{
+    Klondike game;
+    game.Deal(dealNumber);
+    return Solve(game);
+}
+
+const std::vector<std::string>& KlondikeSolver::GetSolution() const
+{
+    return m_solution;
+}
+
+size_t KlondikeSolver::GetNodesSearched() const
+{
+    return m_nodesSearched;
+}
+
+size_t KlondikeSolver::GetNodeBudget() const
+{
+    return m_nodeBudget;
+}
+
+void KlondikeSolver::SetNodeBudget(size_t nodeBudget)
+{
+    m_nodeBudget = nodeBudget;
+}
+
+} // namespace Solitaire
+} // namespace Games
+} // namespace CardGameLib
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "games/solitaire/Klondike.h"
+#include "games/solitaire/SolitaireSolver.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace CardGameLib {
+namespace Games {
+namespace Solitaire {
+
+// Solver for Klondike (draw one, unlimited passes through the stock).
+//
+// The search works on a compact copy of the position: each card is a byte (its
+// index 0-51), a tableau pile is its cards plus a count of face-down cards, and
+// the stock and waste are one ordered talon plus the number of cards drawn. Since
+// the stock can be cycled without limit, every talon card is playable and the
+// draws needed to reach it are only added when the line is written out. Positions
+// are identified by a Zobrist hash that ignores the order of the tableau piles, and
+// a depth-first search skips any position already in its transposition table.
+// Foundation moves that can never be needed back on the tableau are made
+// automatically, and tableau moves are limited to ones that turn a card, empty a
+// pile or free a card for the foundations.
+//
+// UNSOLVABLE is relative to that pruning, which gives up very few winnable deals.
+class KlondikeSolver {
+public:
+    static constexpr size_t DEFAULT_NODE_BUDGET = 200000;
+    
+    // Budget for checking many deals: most winnable deals solve within it, and the
+    // few that need more are left as BUDGET_EXHAUSTED at about 50 times the rate
+    static constexpr size_t BULK_NODE_BUDGET = 2000;
+    
+    explicit KlondikeSolver(size_t nodeBudget = DEFAULT_NODE_BUDGET);
+    
+    // Solve a position (the solver sees the face-down cards)
+    SolveResult Solve(const Klondike& game);
+    
+    // Solve a numbered deal from its opening layout
+    SolveResult SolveDeal(uint64_t dealNumber);
+    
+    // Winning line of the last solved position, as Klondike move data (MakeMove input).
+    // The first move is a hint for the position.
+    const std::vector<std::string>& GetSolution() const;
+    
+    // Positions searched by the last call
+    size_t GetNodesSearched() const;
+    
+    size_t GetNodeBudget() const;
+    void SetNodeBudget(size_t nodeBudget);
+    
+private:
+    TranspositionTable m_table;
+    size_t m_nodeBudget;
+    size_t m_nodesSearched;
+    std::vector<std::string> m_solution;
+};
+
+} // namespace Solitaire
+} // namespace Games
+} // namespace CardGameLib
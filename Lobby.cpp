@@ -2,53 +2,119 @@
 #include "games/solitaire/Klondike.h"
 #include "games/solitaire/FreeCell.h"
 #include "games/solitaire/Spider.h"
+#include "games/blackjack/Blackjack.h"
 #include <sstream>
 #include <iostream>
-#include <nlohmann/json.hpp>
-
-// Using nlohmann json for serialization
-using json = nlohmann::json;
+#include <algorithm>
 
 namespace CardGameLib {
 namespace Network {
 
+namespace {
+    // Full game state field: whether a binary snapshot follows, then the snapshot or,
+    // for games without one, the text state
+    void WriteGameState(MessageWriter& writer, const Core::Game& game)
+    {
+        uint8_t snapshot[Core::Game::MAX_SNAPSHOT_SIZE];
+        size_t size = game.WriteSnapshot(snapshot, sizeof(snapshot));
+        
+        writer.WriteBool(size > 0);
+        if (size > 0) {
+            writer.WriteString(std::string_view(reinterpret_cast<const char*>(snapshot), size));
+        } else {
+            writer.WriteString(game.SerializeGameState());
+        }
+    }
+    
+    // Move field: the type, then every operand including the unused ones
+    void WriteMove(MessageWriter& writer, const Core::Move& move)
+    {
+        writer.WriteUInt8(move.type);
+        for (uint8_t arg : move.args) {
+            writer.WriteUInt8(arg);
+        }
+    }
+    
+    Core::Move ReadMove(MessageReader& reader)
+    {
+        Core::Move move;
+        move.type = reader.ReadUInt8();
+        for (uint8_t& arg : move.args) {
+            arg = reader.ReadUInt8();
+        }
+        return move;
+    }
+}
+
 // GameInfo serialization
-std::string GameInfo::Serialize() const
+void GameInfo::Serialize(MessageWriter& writer) const
 {
-    json j;
-    j["id"] = id;
-    j["name"] = name;
-    j["type"] = static_cast<int>(type);
-    j["maxPlayers"] = maxPlayers;
-    j["currentPlayerCount"] = currentPlayerCount;
-    j["inProgress"] = inProgress;
-    
-    return j.dump();
+    writer.WriteVarInt(id);
+    writer.WriteString(name);
+    writer.WriteUInt8(static_cast<uint8_t>(type));
+    writer.WriteVarInt(maxPlayers);
+    writer.WriteVarInt(currentPlayerCount);
+    writer.WriteBool(inProgress);
 }
 
-GameInfo GameInfo::Deserialize(const std::string& data)
+GameInfo GameInfo::Deserialize(MessageReader& reader)
 {
     GameInfo info;
-    try {
-        json j = json::parse(data);
-        info.id = j["id"];
-        info.name = j["name"];
-        info.type = static_cast<Core::GameType>(j["type"].get<int>());
-        info.maxPlayers = j["maxPlayers"];
-        info.currentPlayerCount = j["currentPlayerCount"];
-        info.inProgress = j["inProgress"];
-    } catch (const std::exception& e) {
-        std::cerr << "Error parsing GameInfo: " << e.what() << std::endl;
-    }
+    info.id = reader.ReadInt();
+    info.name = reader.ReadString();
+    info.type = static_cast<Core::GameType>(reader.ReadUInt8());
+    info.maxPlayers = reader.ReadInt();
+    info.currentPlayerCount = reader.ReadInt();
+    info.inProgress = reader.ReadBool();
     
     return info;
 }
 
+// GameRoom player management
+std::shared_ptr<Core::Player> GameRoom::FindPlayer(int playerId) const
+{
+    for (const auto& player : players) {
+        if (player->GetId() == playerId) {
+            return player;
+        }
+    }
+    
+    return nullptr;
+}
+
+void GameRoom::AddPlayer(const std::shared_ptr<Core::Player>& player)
+{
+    players.push_back(player);
+    
+    // The server's own player (id 0) has no connection to send to
+    if (player->GetId() > 0) {
+        subscribers.push_back(player->GetId());
+    }
+}
+
+bool GameRoom::RemovePlayer(int playerId)
+{
+    auto it = std::find_if(players.begin(), players.end(),
+                           [playerId](const std::shared_ptr<Core::Player>& player) {
+                               return player->GetId() == playerId;
+                           });
+    if (it == players.end()) {
+        return false;
+    }
+    
+    players.erase(it);
+    subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), playerId), subscribers.end());
+    return true;
+}
+
 Lobby::Lobby(NetworkManager* networkManager)
     : m_networkManager(networkManager)
     , m_currentGameId(-1)
     , m_isHost(false)
     , m_nextGameId(1)
+    , m_roomWorkerCount(RoomExecutor::DefaultWorkerCount())
+    , m_winnableDealsOnly(false)
+    , m_awaitingGameState(false)
 {
 }
 
@@ -67,6 +133,16 @@ void Lobby::Initialize()
     }
 }
 
+void Lobby::SetRoomWorkerCount(size_t count)
+{
+    m_roomWorkerCount = count;
+}
+
+void Lobby::SetWinnableDealsOnly(bool winnableOnly)
+{
+    m_winnableDealsOnly = winnableOnly;
+}
+
 bool Lobby::StartServer(int port)
 {
     if (!m_networkManager) {
@@ -82,9 +158,13 @@ bool Lobby::StartServer(int port)
     {
         std::lock_guard<std::mutex> lock(m_gamesMutex);
         m_games.clear();
+        m_rooms.clear();
         m_nextGameId = 1;
     }
     
+    // Spread hosted games across the room workers
+    m_executor.Start(m_roomWorkerCount);
+    
     return true;
 }
 
@@ -109,6 +189,7 @@ bool Lobby::ConnectToServer(const std::string& host, int port)
         std::lock_guard<std::mutex> lock(m_playersMutex);
         m_playersInGame.clear();
         m_currentGame.reset();
+        m_awaitingGameState = false;
     }
     
     return true;
@@ -119,6 +200,9 @@ void Lobby::Disconnect()
     // Leave any current game
     LeaveGame();
     
+    // Finish outstanding room work while the connections are still open
+    m_executor.Stop();
+    
     // Disconnect from server
     if (m_networkManager) {
         m_networkManager->Disconnect();
@@ -132,19 +216,26 @@ int Lobby::CreateGame(const std::string& name, Core::GameType type, int maxPlaye
         return -1;
     }
     
+    // Each game gets its own instance, so any number can run side by side
+    std::shared_ptr<Core::Game> game = CreateGameInstance(type);
+    if (!game) {
+        return -1;
+    }
+    
     // Create the game info
     GameInfo gameInfo;
-    gameInfo.id = m_nextGameId++;
     gameInfo.name = name;
     gameInfo.type = type;
     gameInfo.maxPlayers = maxPlayers;
     gameInfo.currentPlayerCount = 0;
     gameInfo.inProgress = false;
     
-    // Add to games list
+    // Add to games list and room registry
     {
         std::lock_guard<std::mutex> lock(m_gamesMutex);
+        gameInfo.id = m_nextGameId++;
         m_games[gameInfo.id] = gameInfo;
+        m_rooms[gameInfo.id] = std::make_shared<GameRoom>(gameInfo.id, std::move(game));
     }
     
     // Notify all clients about the new game
@@ -164,60 +255,76 @@ bool Lobby::JoinGame(int gameId, const std::string& playerName)
     
     if (m_networkManager->GetMode() == NetworkMode::CLIENT) {
         // Send join request to server
-        json j;
-        j["command"] = "join_game";
-        j["game_id"] = gameId;
-        j["player_name"] = playerName;
+        MessageWriter writer(LobbyOpcode::JOIN_GAME);
+        writer.WriteVarInt(gameId);
+        writer.WriteString(playerName);
         
-        return m_networkManager->SendToServer(j.dump());
+        return m_networkManager->SendToServer(writer.GetBuffer());
     }
     else if (m_networkManager->GetMode() == NetworkMode::SERVER) {
         // Server joining a local game
-        std::lock_guard<std::mutex> lock(m_gamesMutex);
-        
-        auto it = m_games.find(gameId);
-        if (it == m_games.end()) {
-            return false;
-        }
-        
-        GameInfo& gameInfo = it->second;
+        std::shared_ptr<GameRoom> room;
+        Core::GameType type;
         
-        // Check if game is full or in progress
-        if (gameInfo.currentPlayerCount >= gameInfo.maxPlayers || gameInfo.inProgress) {
-            return false;
+        {
+            std::lock_guard<std::mutex> lock(m_gamesMutex);
+            
+            auto it = m_games.find(gameId);
+            auto roomIt = m_rooms.find(gameId);
+            if (it == m_games.end() || roomIt == m_rooms.end()) {
+                return false;
+            }
+            
+            GameInfo& gameInfo = it->second;
+            
+            // Check if game is full or in progress
+            if (gameInfo.currentPlayerCount >= gameInfo.maxPlayers || gameInfo.inProgress) {
+                return false;
+            }
+            
+            // The local player can only be in one game at a time
+            if (m_currentGameId >= 0) {
+                return false;
+            }
+            
+            // Reserve the seat; the room adds the player on its worker
+            gameInfo.currentPlayerCount++;
+            room = roomIt->second;
+            type = gameInfo.type;
         }
         
         // Set player ID
         m_localPlayer->SetId(0); // Server player always has ID 0
         
-        // Create game instance if needed
-        if (!m_currentGame) {
-            m_currentGame = CreateGameInstance(gameInfo.type);
-            if (!m_currentGame) {
-                return false;
-            }
-        }
-        
-        // Add player to game
-        m_currentGame->AddPlayer(m_localPlayer);
+        // Set as current game
+        m_currentGameId = gameId;
+        m_isHost = true; // Server is always host
         
-        // Update player list
+        // The host reads its own copy of the game; the room's instance belongs to
+        // the room's worker
         {
             std::lock_guard<std::mutex> playersLock(m_playersMutex);
+            m_currentGame = CreateGameInstance(type);
+            if (m_currentGame) {
+                m_currentGame->AddPlayer(m_localPlayer);
+            }
             m_playersInGame.clear();
-            m_playersInGame.push_back(m_localPlayer);
+            m_hostGameState = PublishedGameState();
         }
         
-        // Update game info
-        gameInfo.currentPlayerCount++;
-        
-        // Set as current game
-        m_currentGameId = gameId;
-        m_isHost = true; // Server is always host
+        // Add a copy of the player to the room, so the worker and this thread never
+        // share one
+        auto player = std::make_shared<Core::Player>(*m_localPlayer);
+        m_executor.Post(gameId, [this, room, player]() {
+            room->game->AddPlayer(player);
+            room->AddPlayer(player);
+            
+            // Notify the room
+            SendPlayerList(*room);
+        });
         
         // Notify clients
         SendGameList();
-        SendPlayerList(gameId);
         
         // Trigger callback
         if (m_lobbyUpdateCallback) {
@@ -238,35 +345,19 @@ void Lobby::LeaveGame()
     
     if (m_networkManager->GetMode() == NetworkMode::CLIENT) {
         // Send leave request to server
-        json j;
-        j["command"] = "leave_game";
-        j["game_id"] = m_currentGameId;
+        MessageWriter writer(LobbyOpcode::LEAVE_GAME);
+        writer.WriteVarInt(m_currentGameId);
         
-        m_networkManager->SendToServer(j.dump());
+        m_networkManager->SendToServer(writer.GetBuffer());
     }
     else if (m_networkManager->GetMode() == NetworkMode::SERVER) {
         // Server leaving a local game
-        std::lock_guard<std::mutex> lock(m_gamesMutex);
-        
-        auto it = m_games.find(m_currentGameId);
-        if (it != m_games.end()) {
-            GameInfo& gameInfo = it->second;
-            
-            // Update game info
-            gameInfo.currentPlayerCount--;
-            
-            // If last player, remove the game
-            if (gameInfo.currentPlayerCount <= 0) {
-                m_games.erase(it);
+        PostToRoom(m_currentGameId, [this](GameRoom& room) {
+            if (RemovePlayerFromRoom(room, 0)) {
+                // Notify clients about game list update
+                SendGameList();
             }
-            else {
-                // Notify clients about player leaving
-                SendPlayerList(m_currentGameId);
-            }
-            
-            // Notify clients about game list update
-            SendGameList();
-        }
+        });
     }
     
     // Reset local state
@@ -278,6 +369,8 @@ void Lobby::LeaveGame()
         std::lock_guard<std::mutex> lock(m_playersMutex);
         m_playersInGame.clear();
         m_currentGame.reset();
+        m_awaitingGameState = false;
+        m_hostGameState = PublishedGameState();
     }
     
     // Trigger callback
@@ -292,39 +385,24 @@ bool Lobby::StartGame()
         return false;
     }
     
+    if (m_networkManager->GetMode() == NetworkMode::SERVER) {
+        // The room's worker starts the game, notifies everyone and triggers the callback
+        return PostToRoom(m_currentGameId, [this](GameRoom& room) {
+            StartRoom(room, false);
+        });
+    }
+    
     // Start the game
     if (!m_currentGame->Start()) {
         return false;
     }
     
-    if (m_networkManager->GetMode() == NetworkMode::SERVER) {
-        // Update game info
-        std::lock_guard<std::mutex> lock(m_gamesMutex);
-        
-        auto it = m_games.find(m_currentGameId);
-        if (it != m_games.end()) {
-            GameInfo& gameInfo = it->second;
-            gameInfo.inProgress = true;
-            
-            // Notify clients about game starting
-            json j;
-            j["command"] = "start_game";
-            j["game_id"] = m_currentGameId;
-            j["game_state"] = m_currentGame->SerializeGameState();
-            
-            m_networkManager->SendToAllClients(j.dump());
-            
-            // Notify clients about game list update
-            SendGameList();
-        }
-    }
-    else if (m_networkManager->GetMode() == NetworkMode::CLIENT) {
+    if (m_networkManager->GetMode() == NetworkMode::CLIENT) {
         // Send start request to server
-        json j;
-        j["command"] = "start_game";
-        j["game_id"] = m_currentGameId;
+        MessageWriter writer(LobbyOpcode::START_GAME);
+        writer.WriteVarInt(m_currentGameId);
         
-        m_networkManager->SendToServer(j.dump());
+        m_networkManager->SendToServer(writer.GetBuffer());
     }
     
     // Trigger game start callback
@@ -341,20 +419,31 @@ void Lobby::SetReady(bool ready)
         return;
     }
     
-    m_localPlayer->SetReady(ready);
-    
     if (m_networkManager->GetMode() == NetworkMode::CLIENT) {
+        m_localPlayer->SetReady(ready);
+        
         // Send ready status to server
-        json j;
-        j["command"] = "set_ready";
-        j["game_id"] = m_currentGameId;
-        j["ready"] = ready;
+        MessageWriter writer(LobbyOpcode::SET_READY);
+        writer.WriteVarInt(m_currentGameId);
+        writer.WriteBool(ready);
         
-        m_networkManager->SendToServer(j.dump());
+        m_networkManager->SendToServer(writer.GetBuffer());
     }
     else if (m_networkManager->GetMode() == NetworkMode::SERVER) {
-        // Notify clients about player ready status
-        SendPlayerList(m_currentGameId);
+        // Update the room's copy of the player on its worker and notify clients
+        m_localPlayer->SetReady(ready);
+        
+        int playerId = m_localPlayer->GetId();
+        PostToRoom(m_currentGameId, [this, playerId, ready](GameRoom& room) {
+            std::shared_ptr<Core::Player> player = room.FindPlayer(playerId);
+            if (player) {
+                player->SetReady(ready);
+                SendPlayerList(room);
+            }
+        });
+    }
+    else {
+        m_localPlayer->SetReady(ready);
     }
 }
 
@@ -364,6 +453,47 @@ std::shared_ptr<Core::Game> Lobby::GetCurrentGame() const
     return m_currentGame;
 }
 
+bool Lobby::SubmitMove(const Core::Move& move)
+{
+    if (!m_networkManager || !m_localPlayer || m_currentGameId < 0) {
+        return false;
+    }
+    
+    int gameId = m_currentGameId;
+    
+    if (m_networkManager->GetMode() == NetworkMode::CLIENT) {
+        // Send the move to the server, which makes it as this connection's player
+        MessageWriter writer(LobbyOpcode::GAME_MOVE, 16);
+        writer.WriteVarInt(gameId);
+        WriteMove(writer, move);
+        
+        return m_networkManager->SendToServer(writer.GetBuffer());
+    }
+    else if (m_networkManager->GetMode() == NetworkMode::SERVER) {
+        // The room's worker applies the host's move like any other
+        int playerId = m_localPlayer->GetId();
+        return PostToRoom(gameId, [this, playerId, move](GameRoom& room) {
+            if (room.FindPlayer(playerId)) {
+                ApplyRoomMove(room, playerId, move);
+            }
+        });
+    }
+    
+    return false;
+}
+
+bool Lobby::SubmitMove(const std::string& moveData)
+{
+    std::shared_ptr<Core::Game> game = GetCurrentGame();
+    
+    Core::Move move;
+    if (!game || !game->ParseMove(moveData, move)) {
+        return false;
+    }
+    
+    return SubmitMove(move);
+}
+
 std::vector<GameInfo> Lobby::GetAvailableGames() const
 {
     std::vector<GameInfo> games;
@@ -399,6 +529,54 @@ void Lobby::Update()
     if (m_networkManager) {
         m_networkManager->Update();
     }
+    
+    // Take the room states published by room workers
+    PublishedGameState hostState;
+    std::vector<PublishedGameState> startedGames;
+    std::shared_ptr<Core::Game> hostGame;
+    {
+        std::lock_guard<std::mutex> lock(m_playersMutex);
+        hostState = std::move(m_hostGameState);
+        m_hostGameState = PublishedGameState();
+        startedGames.swap(m_startedGames);
+        hostGame = m_currentGame;
+    }
+    
+    // The host's room catches up on the host's copy
+    if (hostState.pending && hostGame && hostState.gameId == m_currentGameId && LoadGameState(*hostGame, hostState)) {
+        if (hostState.started && m_gameStartCallback) {
+            m_gameStartCallback(hostState.gameId, hostGame);
+        }
+    }
+    
+    // Other rooms start on a copy of their game
+    for (const PublishedGameState& state : startedGames) {
+        std::shared_ptr<Core::Game> game = CreateGameInstance(state.type);
+        if (!game) {
+            continue;
+        }
+        
+        for (const Core::Player& player : state.players) {
+            game->AddPlayer(std::make_shared<Core::Player>(player));
+        }
+        
+        if (LoadGameState(*game, state) && m_gameStartCallback) {
+            m_gameStartCallback(state.gameId, game);
+        }
+    }
+}
+
+bool Lobby::LoadGameState(Core::Game& game, const PublishedGameState& state)
+{
+    bool loaded = state.snapshot
+        ? game.ReadSnapshot(reinterpret_cast<const uint8_t*>(state.data.data()), state.data.size())
+        : game.DeserializeGameState(state.data);
+    
+    if (loaded) {
+        game.ResetSequence(state.sequence);
+    }
+    
+    return loaded;
 }
 
 void Lobby::SetLobbyUpdateCallback(LobbyUpdateCallback callback)
@@ -413,467 +591,784 @@ void Lobby::SetGameStartCallback(GameStartCallback callback)
 
 void Lobby::HandleNetworkMessage(const std::string& message, int clientId)
 {
-    try {
-        json j = json::parse(message);
-        std::string command = j["command"];
-        
-        if (command == "get_games") {
-            // Client requesting game list
-            if (m_networkManager->GetMode() == NetworkMode::SERVER) {
-                SendGameList(clientId);
-            }
-        }
-        else if (command == "game_list") {
-            // Server sending game list
-            if (m_networkManager->GetMode() == NetworkMode::CLIENT) {
-                std::lock_guard<std::mutex> lock(m_gamesMutex);
-                m_games.clear();
-                
-                json games = j["games"];
-                for (const auto& gameJson : games) {
-                    GameInfo gameInfo = GameInfo::Deserialize(gameJson.dump());
-                    m_games[gameInfo.id] = gameInfo;
-                }
-                
-                // Trigger callback
-                if (m_lobbyUpdateCallback) {
-                    m_lobbyUpdateCallback();
-                }
-            }
-        }
-        else if (command == "join_game") {
-            // Client requesting to join a game
-            if (m_networkManager->GetMode() == NetworkMode::SERVER) {
-                int gameId = j["game_id"];
-                std::string playerName = j["player_name"];
-                
-                std::lock_guard<std::mutex> lock(m_gamesMutex);
-                
-                auto it = m_games.find(gameId);
-                if (it != m_games.end()) {
-                    GameInfo& gameInfo = it->second;
-                    
-                    // Check if game is full or in progress
-                    if (gameInfo.currentPlayerCount < gameInfo.maxPlayers && !gameInfo.inProgress) {
-                        // Create game instance if needed
-                        if (!m_currentGame || m_currentGameId != gameId) {
-                            m_currentGame = CreateGameInstance(gameInfo.type);
-                            m_currentGameId = gameId;
-                        }
-                        
-                        if (m_currentGame) {
-                            // Create player
-                            auto player = std::make_shared<Core::Player>(playerName);
-                            player->SetId(clientId);
-                            player->SetConnected(true);
-                            
-                            // Add player to game
-                            m_currentGame->AddPlayer(player);
-                            
-                            // Update player list
-                            {
-                                std::lock_guard<std::mutex> playersLock(m_playersMutex);
-                                m_playersInGame.push_back(player);
-                            }
-                            
-                            // Update game info
-                            gameInfo.currentPlayerCount++;
-                            
-                            // Send join success response
-                            json response;
-                            response["command"] = "join_game_response";
-                            response["success"] = true;
-                            response["game_id"] = gameId;
-                            response["player_id"] = clientId;
-                            
-                            m_networkManager->SendToClient(clientId, response.dump());
-                            
-                            // Notify all clients about updated game and player list
-                            SendGameList();
-                            SendPlayerList(gameId);
-                        }
-                    }
-                    else {
-                        // Send join failure response
-                        json response;
-                        response["command"] = "join_game_response";
-                        response["success"] = false;
-                        response["game_id"] = gameId;
-                        response["error"] = gameInfo.inProgress ? "Game in progress" : "Game is full";
-                        
-                        m_networkManager->SendToClient(clientId, response.dump());
-                    }
-                }
-                else {
-                    // Send join failure response - game not found
-                    json response;
-                    response["command"] = "join_game_response";
-                    response["success"] = false;
-                    response["game_id"] = gameId;
-                    response["error"] = "Game not found";
-                    
-                    m_networkManager->SendToClient(clientId, response.dump());
-                }
-            }
-        }
-        else if (command == "join_game_response") {
-            // Server response to join request
-            if (m_networkManager->GetMode() == NetworkMode::CLIENT) {
-                bool success = j["success"];
-                int gameId = j["game_id"];
-                
-                if (success) {
-                    int playerId = j["player_id"];
-                    
-                    // Set player ID
-                    if (m_localPlayer) {
-                        m_localPlayer->SetId(playerId);
-                        m_localPlayer->SetConnected(true);
-                    }
-                    
-                    // Set current game
-                    m_currentGameId = gameId;
-                    m_isHost = false;
-                    
-                    // Request player list
-                    json requestPlayers;
-                    requestPlayers["command"] = "get_players";
-                    requestPlayers["game_id"] = gameId;
-                    
-                    m_networkManager->SendToServer(requestPlayers.dump());
-                }
-                else {
-                    std::string error = j["error"];
-                    std::cerr << "Failed to join game: " << error << std::endl;
-                    
-                    // Reset local player
-                    m_localPlayer.reset();
-                }
-                
-                // Trigger callback
-                if (m_lobbyUpdateCallback) {
-                    m_lobbyUpdateCallback();
-                }
-            }
-        }
-        else if (command == "leave_game") {
-            // Client leaving a game
-            if (m_networkManager->GetMode() == NetworkMode::SERVER) {
-                int gameId = j["game_id"];
-                
-                std::lock_guard<std::mutex> lock(m_gamesMutex);
-                
-                auto it = m_games.find(gameId);
-                if (it != m_games.end()) {
-                    GameInfo& gameInfo = it->second;
-                    
-                    // Remove player from game
-                    if (m_currentGame && m_currentGameId == gameId) {
-                        m_currentGame->RemovePlayer(clientId);
-                        
-                        // Update player list
-                        {
-                            std::lock_guard<std::mutex> playersLock(m_playersMutex);
-                            m_playersInGame.erase(
-                                std::remove_if(m_playersInGame.begin(), m_playersInGame.end(),
-                                             [clientId](const std::shared_ptr<Core::Player>& player) {
-                                                 return player->GetId() == clientId;
-                                             }),
-                                m_playersInGame.end());
-                        }
-                        
-                        // Update game info
-                        gameInfo.currentPlayerCount--;
-                        
-                        // If no players left, remove the game
-                        if (gameInfo.currentPlayerCount <= 0) {
-                            m_games.erase(it);
-                            m_currentGame.reset();
-                            m_currentGameId = -1;
-                        }
-                        else {
-                            // Notify clients about player leaving
-                            SendPlayerList(gameId);
-                        }
-                        
-                        // Notify clients about game list update
-                        SendGameList();
-                    }
-                }
-            }
-        }
-        else if (command == "get_players") {
-            // Client requesting player list
-            if (m_networkManager->GetMode() == NetworkMode::SERVER) {
-                int gameId = j["game_id"];
-                SendPlayerList(gameId, clientId);
-            }
-        }
-        else if (command == "player_list") {
-            // Server sending player list
-            if (m_networkManager->GetMode() == NetworkMode::CLIENT) {
-                int gameId = j["game_id"];
-                
-                if (gameId == m_currentGameId) {
-                    // Parse player list
-                    std::lock_guard<std::mutex> lock(m_playersMutex);
-                    m_playersInGame.clear();
-                    
-                    json players = j["players"];
-                    for (const auto& playerJson : players) {
-                        std::string name = playerJson["name"];
-                        int id = playerJson["id"];
-                        bool ready = playerJson["ready"];
-                        bool isHost = playerJson["host"];
-                        
-                        auto player = std::make_shared<Core::Player>(name);
-                        player->SetId(id);
-                        player->SetConnected(true);
-                        player->SetReady(ready);
-                        
-                        m_playersInGame.push_back(player);
-                        
-                        // Check if local player is host
-                        if (id == m_localPlayer->GetId() && isHost) {
-                            m_isHost = true;
-                        }
-                    }
-                    
-                    // Create game instance if needed
-                    if (!m_currentGame) {
-                        std::lock_guard<std::mutex> gamesLock(m_gamesMutex);
-                        auto it = m_games.find(gameId);
-                        if (it != m_games.end()) {
-                            m_currentGame = CreateGameInstance(it->second.type);
-                            
-                            // Add all players to the game
-                            for (const auto& player : m_playersInGame) {
-                                m_currentGame->AddPlayer(player);
-                            }
-                        }
-                    }
-                    
-                    // Trigger callback
-                    if (m_lobbyUpdateCallback) {
-                        m_lobbyUpdateCallback();
-                    }
-                }
-            }
-        }
-        else if (command == "set_ready") {
-            // Client setting ready status
-            if (m_networkManager->GetMode() == NetworkMode::SERVER) {
-                int gameId = j["game_id"];
-                bool ready = j["ready"];
-                
-                if (m_currentGameId == gameId && m_currentGame) {
-                    auto player = m_currentGame->GetPlayer(clientId);
-                    if (player) {
-                        player->SetReady(ready);
-                        
-                        // Notify all clients
-                        SendPlayerList(gameId);
-                    }
-                }
-            }
-        }
-        else if (command == "start_game") {
-            // Game start request or notification
-            if (m_networkManager->GetMode() == NetworkMode::SERVER) {
-                // Client requesting to start a game
-                int gameId = j["game_id"];
-                
-                if (m_currentGameId == gameId && m_currentGame) {
-                    // Check if all players are ready
-                    bool allReady = true;
-                    for (const auto& player : m_currentGame->GetPlayers()) {
-                        if (!player->IsReady() && player->GetId() != 0) { // Skip the host
-                            allReady = false;
-                            break;
-                        }
-                    }
-                    
-                    if (allReady) {
-                        // Start the game
-                        if (m_currentGame->Start()) {
-                            // Update game info
-                            std::lock_guard<std::mutex> lock(m_gamesMutex);
-                            
-                            auto it = m_games.find(gameId);
-                            if (it != m_games.end()) {
-                                GameInfo& gameInfo = it->second;
-                                gameInfo.inProgress = true;
-                                
-                                // Notify clients about game starting
-                                json response;
-                                response["command"] = "start_game";
-                                response["game_id"] = gameId;
-                                response["game_state"] = m_currentGame->SerializeGameState();
-                                
-                                m_networkManager->SendToAllClients(response.dump());
-                                
-                                // Notify clients about game list update
-                                SendGameList();
-                                
-                                // Trigger game start callback
-                                if (m_gameStartCallback) {
-                                    m_gameStartCallback(gameId, m_currentGame);
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            else if (m_networkManager->GetMode() == NetworkMode::CLIENT) {
-                // Server notifying game has started
-                int gameId = j["game_id"];
-                std::string gameState = j["game_state"];
-                
-                if (m_currentGameId == gameId && m_currentGame) {
-                    // Deserialize game state
-                    m_currentGame->DeserializeGameState(gameState);
-                    
-                    // Trigger game start callback
-                    if (m_gameStartCallback) {
-                        m_gameStartCallback(gameId, m_currentGame);
-                    }
-                }
-            }
-        }
-        else if (command == "game_move") {
-            // Game move
-            int gameId = j["game_id"];
-            int playerId = j["player_id"];
-            std::string moveData = j["move_data"];
-            
-            if (m_currentGameId == gameId && m_currentGame) {
-                if (m_networkManager->GetMode() == NetworkMode::SERVER) {
-                    // Client sent a move to the server
-                    if (m_currentGame->IsValidMove(moveData)) {
-                        // Process the move
-                        if (m_currentGame->MakeMove(playerId, moveData)) {
-                            // Broadcast move to all clients including the sender
-                            json moveNotification;
-                            moveNotification["command"] = "game_move";
-                            moveNotification["game_id"] = gameId;
-                            moveNotification["player_id"] = playerId;
-                            moveNotification["move_data"] = moveData;
-                            moveNotification["game_state"] = m_currentGame->SerializeGameState();
-                            
-                            m_networkManager->SendToAllClients(moveNotification.dump());
-                        }
-                    }
-                }
-                else if (m_networkManager->GetMode() == NetworkMode::CLIENT) {
-                    // Server broadcasting a move
-                    std::string gameState = j["game_state"];
-                    
-                    // Update local game state
-                    m_currentGame->DeserializeGameState(gameState);
-                }
-            }
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "Error processing network message: " << e.what() << std::endl;
-    }
-}
-
-void Lobby::SendGameList(int clientId)
-{
-    if (m_networkManager->GetMode() != NetworkMode::SERVER) {
+    // Handlers by opcode: requests the server accepts, and updates clients accept
+    struct HandlerEntry {
+        MessageHandler server;
+        MessageHandler client;
+    };
+    
+    static const HandlerEntry handlers[] = {
+        { &Lobby::HandleGetGames,         nullptr                          },  // GET_GAMES
+        { nullptr,                        &Lobby::HandleGameList           },  // GAME_LIST
+        { &Lobby::HandleJoinGame,         nullptr                          },  // JOIN_GAME
+        { nullptr,                        &Lobby::HandleJoinGameResponse   },  // JOIN_GAME_RESPONSE
+        { &Lobby::HandleLeaveGame,        nullptr                          },  // LEAVE_GAME
+        { &Lobby::HandleGetPlayers,       nullptr                          },  // GET_PLAYERS
+        { nullptr,                        &Lobby::HandlePlayerList         },  // PLAYER_LIST
+        { &Lobby::HandleSetReady,         nullptr                          },  // SET_READY
+        { &Lobby::HandleStartGameRequest, &Lobby::HandleGameStarted        },  // START_GAME
+        { &Lobby::HandleGameMoveRequest,  &Lobby::HandleGameMove           },  // GAME_MOVE
+        { nullptr,                        &Lobby::HandleGameState          },  // GAME_STATE
+        { &Lobby::HandleGetGameState,     nullptr                          }   // GET_GAME_STATE
+    };
+    
+    static_assert(sizeof(handlers) / sizeof(handlers[0]) == static_cast<size_t>(LobbyOpcode::COUNT),
+                  "Every lobby opcode needs a handler entry");
+    
+    MessageReader reader(message);
+    LobbyOpcode opcode;
+    
+    if (!reader.ReadHeader(opcode) || opcode >= LobbyOpcode::COUNT) {
+        std::cerr << "Error processing network message: unsupported version or opcode" << std::endl;
         return;
     }
     
-    // Prepare the game list
-    json j;
-    j["command"] = "game_list";
+    const HandlerEntry& entry = handlers[static_cast<size_t>(opcode)];
     
-    json games = json::array();
+    MessageHandler handler = nullptr;
+    if (m_networkManager->GetMode() == NetworkMode::SERVER) {
+        handler = entry.server;
+    }
+    else if (m_networkManager->GetMode() == NetworkMode::CLIENT) {
+        handler = entry.client;
+    }
     
-    {
-        std::lock_guard<std::mutex> lock(m_gamesMutex);
-        for (const auto& pair : m_games) {
-            games.push_back(json::parse(pair.second.Serialize()));
-        }
+    if (!handler) {
+        return;
     }
     
-    j["games"] = games;
+    (this->*handler)(reader, clientId);
     
-    // Send to specific client or all clients
-    if (clientId >= 0) {
-        m_networkManager->SendToClient(clientId, j.dump());
-    } else {
-        m_networkManager->SendToAllClients(j.dump());
+    if (reader.HasError()) {
+        std::cerr << "Error processing network message: malformed message with opcode "
+                  << static_cast<int>(opcode) << std::endl;
     }
 }
 
-void Lobby::SendPlayerList(int gameId, int clientId)
+void Lobby::HandleGetGames(MessageReader&, int clientId)
 {
-    if (m_networkManager->GetMode() != NetworkMode::SERVER || m_currentGameId != gameId) {
-        return;
-    }
-    
-    // Prepare the player list
-    json j;
-    j["command"] = "player_list";
-    j["game_id"] = gameId;
+    // Client requesting game list
+    SendGameList(clientId);
+}
+
+void Lobby::HandleGameList(MessageReader& reader, int)
+{
+    // Server sending game list
+    uint64_t count = reader.ReadVarUInt();
+    
+    std::vector<GameInfo> games;
+    for (uint64_t i = 0; i < count && !reader.HasError(); ++i) {
+        games.push_back(GameInfo::Deserialize(reader));
+    }
+    
+    if (reader.HasError()) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_gamesMutex);
+        m_games.clear();
+        
+        for (const GameInfo& gameInfo : games) {
+            m_games[gameInfo.id] = gameInfo;
+        }
+    }
+    
+    // Trigger callback
+    if (m_lobbyUpdateCallback) {
+        m_lobbyUpdateCallback();
+    }
+}
+
+void Lobby::HandleJoinGame(MessageReader& reader, int clientId)
+{
+    // Client requesting to join a game
+    int gameId = reader.ReadInt();
+    std::string playerName = reader.ReadString();
+    
+    if (reader.HasError()) {
+        return;
+    }
+    
+    std::shared_ptr<GameRoom> room;
+    std::string error;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_gamesMutex);
+        
+        auto it = m_games.find(gameId);
+        auto roomIt = m_rooms.find(gameId);
+        if (it == m_games.end() || roomIt == m_rooms.end()) {
+            error = "Game not found";
+        }
+        else if (it->second.currentPlayerCount >= it->second.maxPlayers || it->second.inProgress) {
+            error = it->second.inProgress ? "Game in progress" : "Game is full";
+        }
+        else {
+            // Reserve the seat; the room adds the player on its worker
+            it->second.currentPlayerCount++;
+            room = roomIt->second;
+        }
+    }
+    
+    if (!room) {
+        // Send join failure response
+        MessageWriter response(LobbyOpcode::JOIN_GAME_RESPONSE);
+        response.WriteVarInt(gameId);
+        response.WriteBool(false);
+        response.WriteString(error);
+        
+        m_networkManager->SendToClient(clientId, response.GetBuffer());
+        return;
+    }
+    
+    m_executor.Post(gameId, [this, room, clientId, playerName]() {
+        MessageWriter response(LobbyOpcode::JOIN_GAME_RESPONSE);
+        response.WriteVarInt(room->id);
+        
+        if (room->FindPlayer(clientId)) {
+            // Give the reserved seat back
+            {
+                std::lock_guard<std::mutex> lock(m_gamesMutex);
+                auto it = m_games.find(room->id);
+                if (it != m_games.end()) {
+                    it->second.currentPlayerCount--;
+                }
+            }
+            
+            response.WriteBool(false);
+            response.WriteString("Already in game");
+            
+            m_networkManager->SendToClient(clientId, response.GetBuffer());
+            return;
+        }
+        
+        // Create player
+        auto player = std::make_shared<Core::Player>(playerName);
+        player->SetId(clientId);
+        player->SetConnected(true);
+        
+        // Add player to the room and its game
+        room->game->AddPlayer(player);
+        room->AddPlayer(player);
+        
+        // Send join success response
+        response.WriteBool(true);
+        response.WriteVarInt(clientId);
+        
+        m_networkManager->SendToClient(clientId, response.GetBuffer());
+        
+        // Notify the room about the updated player list
+        SendPlayerList(*room);
+    });
+    
+    // Notify all clients about the updated game list
+    SendGameList();
+}
+
+void Lobby::HandleJoinGameResponse(MessageReader& reader, int)
+{
+    // Server response to join request
+    int gameId = reader.ReadInt();
+    bool success = reader.ReadBool();
+    
+    if (success) {
+        int playerId = reader.ReadInt();
+        
+        if (reader.HasError()) {
+            return;
+        }
+        
+        // Set player ID
+        if (m_localPlayer) {
+            m_localPlayer->SetId(playerId);
+            m_localPlayer->SetConnected(true);
+        }
+        
+        // Set current game
+        m_currentGameId = gameId;
+        m_isHost = false;
+        
+        // Request player list
+        MessageWriter requestPlayers(LobbyOpcode::GET_PLAYERS);
+        requestPlayers.WriteVarInt(gameId);
+        
+        m_networkManager->SendToServer(requestPlayers.GetBuffer());
+    }
+    else {
+        std::string error = reader.ReadString();
+        
+        if (reader.HasError()) {
+            return;
+        }
+        
+        std::cerr << "Failed to join game: " << error << std::endl;
+        
+        // Reset local player
+        m_localPlayer.reset();
+    }
+    
+    // Trigger callback
+    if (m_lobbyUpdateCallback) {
+        m_lobbyUpdateCallback();
+    }
+}
+
+void Lobby::HandleLeaveGame(MessageReader& reader, int clientId)
+{
+    // Client leaving a game
+    int gameId = reader.ReadInt();
+    
+    if (reader.HasError()) {
+        return;
+    }
+    
+    PostToRoom(gameId, [this, clientId](GameRoom& room) {
+        if (RemovePlayerFromRoom(room, clientId)) {
+            // Notify clients about game list update
+            SendGameList();
+        }
+    });
+}
+
+void Lobby::HandleGetPlayers(MessageReader& reader, int clientId)
+{
+    // Client requesting player list
+    int gameId = reader.ReadInt();
+    
+    if (reader.HasError()) {
+        return;
+    }
     
-    json players = json::array();
+    PostToRoom(gameId, [this, clientId](GameRoom& room) {
+        SendPlayerList(room, clientId);
+    });
+}
+
+void Lobby::HandlePlayerList(MessageReader& reader, int)
+{
+    // Server sending player list
+    int gameId = reader.ReadInt();
+    
+    if (reader.HasError() || gameId != m_currentGameId) {
+        return;
+    }
+    
+    // Parse player list
+    std::vector<std::shared_ptr<Core::Player>> players;
+    bool isHost = false;
+    
+    uint64_t count = reader.ReadVarUInt();
+    for (uint64_t i = 0; i < count && !reader.HasError(); ++i) {
+        int id = reader.ReadInt();
+        std::string name = reader.ReadString();
+        bool ready = reader.ReadBool();
+        bool host = reader.ReadBool();
+        
+        auto player = std::make_shared<Core::Player>(name);
+        player->SetId(id);
+        player->SetConnected(true);
+        player->SetReady(ready);
+        
+        players.push_back(player);
+        
+        // Check if local player is host
+        if (m_localPlayer && id == m_localPlayer->GetId() && host) {
+            isHost = true;
+        }
+    }
+    
+    if (reader.HasError()) {
+        return;
+    }
     
     {
         std::lock_guard<std::mutex> lock(m_playersMutex);
-        for (const auto& player : m_playersInGame) {
-            json playerJson;
-            playerJson["id"] = player->GetId();
-            playerJson["name"] = player->GetName();
-            playerJson["ready"] = player->IsReady();
-            playerJson["host"] = (player->GetId() == 0); // Server player is always host
+        m_playersInGame = std::move(players);
+        
+        if (isHost) {
+            m_isHost = true;
+        }
+        
+        // Create game instance if needed
+        if (!m_currentGame) {
+            std::lock_guard<std::mutex> gamesLock(m_gamesMutex);
+            auto it = m_games.find(gameId);
+            if (it != m_games.end()) {
+                m_currentGame = CreateGameInstance(it->second.type);
+                
+                // Add all players to the game
+                if (m_currentGame) {
+                    for (const auto& player : m_playersInGame) {
+                        m_currentGame->AddPlayer(player);
+                    }
+                }
+            }
+        }
+    }
+    
+    // Trigger callback
+    if (m_lobbyUpdateCallback) {
+        m_lobbyUpdateCallback();
+    }
+}
+
+void Lobby::HandleSetReady(MessageReader& reader, int clientId)
+{
+    // Client setting ready status
+    int gameId = reader.ReadInt();
+    bool ready = reader.ReadBool();
+    
+    if (reader.HasError()) {
+        return;
+    }
+    
+    PostToRoom(gameId, [this, clientId, ready](GameRoom& room) {
+        auto player = room.FindPlayer(clientId);
+        if (player) {
+            player->SetReady(ready);
             
-            players.push_back(playerJson);
+            // Notify the room
+            SendPlayerList(room);
+        }
+    });
+}
+
+void Lobby::HandleStartGameRequest(MessageReader& reader, int clientId)
+{
+    // Client requesting to start a game; only players of the game may start it
+    int gameId = reader.ReadInt();
+    
+    if (reader.HasError()) {
+        return;
+    }
+    
+    PostToRoom(gameId, [this, clientId](GameRoom& room) {
+        if (room.FindPlayer(clientId)) {
+            StartRoom(room, true);
         }
+    });
+}
+
+void Lobby::HandleGameStarted(MessageReader& reader, int)
+{
+    // Server notifying game has started
+    int gameId = reader.ReadInt();
+    uint32_t sequence = static_cast<uint32_t>(reader.ReadVarUInt());
+    bool snapshot = reader.ReadBool();
+    std::string gameState = reader.ReadString();
+    
+    if (reader.HasError()) {
+        return;
     }
     
-    j["players"] = players;
+    if (m_currentGameId == gameId && m_currentGame) {
+        // Deserialize game state
+        ApplyGameState(gameId, sequence, snapshot, gameState);
+        
+        // Trigger game start callback
+        if (m_gameStartCallback) {
+            m_gameStartCallback(gameId, m_currentGame);
+        }
+    }
+}
+
+void Lobby::HandleGameMoveRequest(MessageReader& reader, int clientId)
+{
+    // Client sent a move to the server; apply it on its room's worker. A client
+    // always moves as its own player, whose id is the connection's.
+    int gameId = reader.ReadInt();
+    Core::Move move = ReadMove(reader);
+    
+    if (reader.HasError()) {
+        return;
+    }
+    
+    PostToRoom(gameId, [this, clientId, move](GameRoom& room) {
+        if (room.FindPlayer(clientId)) {
+            ApplyRoomMove(room, clientId, move);
+        }
+    });
+}
+
+void Lobby::HandleGetGameState(MessageReader& reader, int clientId)
+{
+    // Client lost track of the game and needs a full state
+    int gameId = reader.ReadInt();
+    
+    if (reader.HasError()) {
+        return;
+    }
+    
+    PostToRoom(gameId, [this, clientId](GameRoom& room) {
+        if (room.FindPlayer(clientId)) {
+            SendGameState(room, clientId);
+        }
+    });
+}
+
+void Lobby::HandleGameMove(MessageReader& reader, int)
+{
+    // Server broadcasting a move
+    int gameId = reader.ReadInt();
+    reader.ReadInt();     // Player id
+    bool hasDelta = reader.ReadBool();
+    
+    if (!hasDelta) {
+        uint32_t sequence = static_cast<uint32_t>(reader.ReadVarUInt());
+        bool snapshot = reader.ReadBool();
+        std::string gameState = reader.ReadString();
+        
+        if (!reader.HasError() && m_currentGameId == gameId && m_currentGame) {
+            ApplyGameState(gameId, sequence, snapshot, gameState);
+        }
+        return;
+    }
+    
+    std::string deltaData = reader.ReadString();
+    
+    if (reader.HasError() || m_currentGameId != gameId || !m_currentGame || m_awaitingGameState) {
+        return;
+    }
+    
+    Core::GameDelta delta;
+    bool decoded = delta.Deserialize(deltaData);
+    
+    // Ignore deltas we have already seen
+    if (decoded && delta.sequence <= m_currentGame->GetSequence()) {
+        return;
+    }
+    
+    // A gap or a delta that doesn't fit our state: resynchronize
+    if (!decoded || !m_currentGame->ApplyDelta(delta)) {
+        RequestGameState(gameId);
+    }
+}
+
+void Lobby::HandleGameState(MessageReader& reader, int)
+{
+    // Server sending the full game state
+    int gameId = reader.ReadInt();
+    uint32_t sequence = static_cast<uint32_t>(reader.ReadVarUInt());
+    bool snapshot = reader.ReadBool();
+    std::string gameState = reader.ReadString();
+    
+    if (reader.HasError()) {
+        return;
+    }
+    
+    if (m_currentGameId == gameId && m_currentGame) {
+        ApplyGameState(gameId, sequence, snapshot, gameState);
+    }
+}
+
+void Lobby::SendGameList(int clientId)
+{
+    if (m_networkManager->GetMode() != NetworkMode::SERVER) {
+        return;
+    }
+    
+    // Prepare the game list
+    MessageWriter writer(LobbyOpcode::GAME_LIST, 256);
+    
+    {
+        std::lock_guard<std::mutex> lock(m_gamesMutex);
+        
+        writer.WriteVarUInt(m_games.size());
+        for (const auto& pair : m_games) {
+            pair.second.Serialize(writer);
+        }
+    }
     
     // Send to specific client or all clients
     if (clientId >= 0) {
-        m_networkManager->SendToClient(clientId, j.dump());
+        m_networkManager->SendToClient(clientId, writer.GetBuffer());
+    } else {
+        m_networkManager->SendToAllClients(writer.GetBuffer());
+    }
+}
+
+void Lobby::SendPlayerList(const GameRoom& room, int clientId)
+{
+    if (m_networkManager->GetMode() != NetworkMode::SERVER) {
+        return;
+    }
+    
+    // Prepare the player list
+    MessageWriter writer(LobbyOpcode::PLAYER_LIST, 64);
+    writer.WriteVarInt(room.id);
+    writer.WriteVarUInt(room.players.size());
+    
+    for (const auto& player : room.players) {
+        writer.WriteVarInt(player->GetId());
+        writer.WriteString(player->GetName());
+        writer.WriteBool(player->IsReady());
+        writer.WriteBool(player->GetId() == 0); // Server player is always host
+    }
+    
+    // Mirror the list for the server's own player, as copies the worker won't change
+    if (room.id == m_currentGameId) {
+        std::vector<std::shared_ptr<Core::Player>> players;
+        for (const auto& player : room.players) {
+            players.push_back(std::make_shared<Core::Player>(*player));
+        }
+        
+        std::lock_guard<std::mutex> lock(m_playersMutex);
+        m_playersInGame = std::move(players);
+    }
+    
+    // Send to specific client or every client in the room
+    if (clientId >= 0) {
+        m_networkManager->SendToClient(clientId, writer.GetBuffer());
     } else {
-        m_networkManager->SendToAllClients(j.dump());
+        m_networkManager->SendToClients(room.subscribers, writer.GetBuffer());
     }
 }
 
-void Lobby::SendGameState(int gameId, int clientId)
+void Lobby::SendGameState(const GameRoom& room, int clientId)
 {
-    if (m_networkManager->GetMode() != NetworkMode::SERVER || m_currentGameId != gameId || !m_currentGame) {
+    if (m_networkManager->GetMode() != NetworkMode::SERVER) {
         return;
     }
     
     // Prepare the game state
-    json j;
-    j["command"] = "game_state";
-    j["game_id"] = gameId;
-    j["game_state"] = m_currentGame->SerializeGameState();
+    MessageWriter writer(LobbyOpcode::GAME_STATE, Core::Game::MAX_SNAPSHOT_SIZE + 16);
+    writer.WriteVarInt(room.id);
+    writer.WriteVarUInt(room.game->GetSequence());
+    WriteGameState(writer, *room.game);
     
-    // Send to specific client or all clients
+    // Send to specific client or every client in the room
     if (clientId >= 0) {
-        m_networkManager->SendToClient(clientId, j.dump());
+        m_networkManager->SendToClient(clientId, writer.GetBuffer());
     } else {
-        m_networkManager->SendToAllClients(j.dump());
+        m_networkManager->SendToClients(room.subscribers, writer.GetBuffer());
     }
 }
 
+void Lobby::ApplyGameState(int gameId, uint32_t sequence, bool snapshot, const std::string& gameState)
+{
+    bool loaded = snapshot
+        ? m_currentGame->ReadSnapshot(reinterpret_cast<const uint8_t*>(gameState.data()), gameState.size())
+        : m_currentGame->DeserializeGameState(gameState);
+    
+    if (!loaded) {
+        RequestGameState(gameId);
+        return;
+    }
+    
+    // Deltas continue from the state's sequence number
+    m_currentGame->ResetSequence(sequence);
+    m_awaitingGameState = false;
+}
+
+void Lobby::RequestGameState(int gameId)
+{
+    if (m_awaitingGameState) {
+        return;
+    }
+    
+    m_awaitingGameState = true;
+    
+    MessageWriter writer(LobbyOpcode::GET_GAME_STATE);
+    writer.WriteVarInt(gameId);
+    
+    m_networkManager->SendToServer(writer.GetBuffer());
+}
+
+void Lobby::ApplyRoomMove(GameRoom& room, int playerId, const Core::Move& move)
+{
+    Core::Game& game = *room.game;
+    
+    if (!game.IsValidMove(move) || !game.MakeMove(playerId, move)) {
+        return;
+    }
+    
+    Core::GameDelta delta = game.TakeDelta();
+    
+    // Broadcast the move to every player in the game including the sender. Games
+    // that track pile changes send just those; the rest send their full state.
+    MessageWriter moveNotification(LobbyOpcode::GAME_MOVE, 160);
+    moveNotification.WriteVarInt(room.id);
+    moveNotification.WriteVarInt(playerId);
+    
+    if (game.SupportsDeltas() && !delta.overflow) {
+        moveNotification.WriteBool(true);
+        moveNotification.WriteString(delta.Serialize());
+    } else {
+        moveNotification.WriteBool(false);
+        moveNotification.WriteVarUInt(delta.sequence);
+        WriteGameState(moveNotification, game);
+    }
+    
+    m_networkManager->SendToClients(room.subscribers, moveNotification.GetBuffer());
+    
+    if (room.id == m_currentGameId) {
+        PublishGameState(room, false);
+    }
+}
+
+void Lobby::PublishGameState(const GameRoom& room, bool started)
+{
+    bool hostRoom = room.id == m_currentGameId;
+    
+    PublishedGameState state;
+    state.pending = true;
+    state.started = started;
+    state.gameId = room.id;
+    state.type = room.game->GetType();
+    state.sequence = room.game->GetSequence();
+    
+    uint8_t snapshot[Core::Game::MAX_SNAPSHOT_SIZE];
+    size_t size = room.game->WriteSnapshot(snapshot, sizeof(snapshot));
+    state.snapshot = size > 0;
+    state.data = size > 0 ? std::string(reinterpret_cast<const char*>(snapshot), size)
+                          : room.game->SerializeGameState();
+    
+    if (!hostRoom) {
+        for (const auto& player : room.players) {
+            state.players.push_back(*player);
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(m_playersMutex);
+    
+    if (hostRoom) {
+        // A newer state replaces one Update hasn't loaded yet, keeping a pending start
+        state.started = state.started || m_hostGameState.started;
+        m_hostGameState = std::move(state);
+    } else {
+        m_startedGames.push_back(std::move(state));
+    }
+}
+
+bool Lobby::PostToRoom(int gameId, std::function<void(GameRoom&)> task)
+{
+    std::shared_ptr<GameRoom> room;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_gamesMutex);
+        
+        auto it = m_rooms.find(gameId);
+        if (it == m_rooms.end()) {
+            return false;
+        }
+        
+        room = it->second;
+    }
+    
+    // The task keeps the room alive even if it is removed from the registry meanwhile
+    m_executor.Post(gameId, [room, task = std::move(task)]() {
+        task(*room);
+    });
+    
+    return true;
+}
+
+bool Lobby::RemovePlayerFromRoom(GameRoom& room, int playerId)
+{
+    if (!room.RemovePlayer(playerId)) {
+        return false;
+    }
+    
+    room.game->RemovePlayer(playerId);
+    
+    bool empty = false;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_gamesMutex);
+        
+        // Update game info
+        auto it = m_games.find(room.id);
+        if (it != m_games.end()) {
+            it->second.currentPlayerCount--;
+            
+            // If no players left (or about to join), remove the game
+            if (it->second.currentPlayerCount <= 0) {
+                m_games.erase(it);
+                m_rooms.erase(room.id);
+                empty = true;
+            }
+        }
+    }
+    
+    if (!empty) {
+        // Notify the room about the player leaving
+        SendPlayerList(room);
+    }
+    
+    return true;
+}
+
+bool Lobby::StartRoom(GameRoom& room, bool requireReady)
+{
+    if (requireReady) {
+        // Check if all players are ready
+        for (const auto& player : room.players) {
+            if (!player->IsReady() && player->GetId() != 0) { // Skip the host
+                return false;
+            }
+        }
+    }
+    
+    // Mark the game in progress first so no new seats are handed out meanwhile
+    {
+        std::lock_guard<std::mutex> lock(m_gamesMutex);
+        
+        auto it = m_games.find(room.id);
+        if (it == m_games.end() || it->second.inProgress) {
+            return false;
+        }
+        
+        it->second.inProgress = true;
+    }
+    
+    // Start the game
+    if (!room.game->Start()) {
+        std::lock_guard<std::mutex> lock(m_gamesMutex);
+        
+        auto it = m_games.find(room.id);
+        if (it != m_games.end()) {
+            it->second.inProgress = false;
+        }
+        
+        return false;
+    }
+    
+    // Moves are numbered from the dealt layout
+    room.game->ResetSequence(0);
+    
+    // Notify the room about the game starting
+    MessageWriter writer(LobbyOpcode::START_GAME, Core::Game::MAX_SNAPSHOT_SIZE + 16);
+    writer.WriteVarInt(room.id);
+    writer.WriteVarUInt(room.game->GetSequence());
+    WriteGameState(writer, *room.game);
+    
+    m_networkManager->SendToClients(room.subscribers, writer.GetBuffer());
+    
+    // Notify clients about game list update
+    SendGameList();
+    
+    // The game start callback runs in Update, on a copy of the game
+    PublishGameState(room, true);
+    
+    return true;
+}
+
 std::shared_ptr<Core::Game> Lobby::CreateGameInstance(Core::GameType type)
 {
     switch (type) {
         case Core::GameType::SOLITAIRE_KLONDIKE:
-            return std::make_shared<Games::Solitaire::Klondike>();
+            return std::make_shared<Games::Solitaire::Klondike>(m_winnableDealsOnly);
             
         case Core::GameType::SOLITAIRE_FREECELL:
-            return std::make_shared<Games::Solitaire::FreeCell>();
+            return std::make_shared<Games::Solitaire::FreeCell>(m_winnableDealsOnly);
             
         case Core::GameType::SOLITAIRE_SPIDER:
-            return std::make_shared<Games::Solitaire::Spider>();
+            return std::make_shared<Games::Solitaire::Spider>(Games::Solitaire::SpiderDifficulty::ONE_SUIT,
+                                                               m_winnableDealsOnly);
+            
+        case Core::GameType::BLACKJACK:
+            return std::make_shared<Games::Blackjack::BlackjackGame>();
             
         default:
             return nullptr;
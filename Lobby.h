@@ -6,10 +6,13 @@
 #include <functional>
 #include <unordered_map>
 #include <mutex>
+#include <atomic>
 
 #include "core/Player.h"
 #include "core/Game.h"
 #include "network/NetworkManager.h"
+#include "network/RoomExecutor.h"
+#include "network/LobbyProtocol.h"
 
 namespace CardGameLib {
 namespace Network {
@@ -28,11 +31,27 @@ struct GameInfo {
     GameInfo(int id, const std::string& name, Core::GameType type, int maxPlayers, int currentPlayerCount, bool inProgress)
         : id(id), name(name), type(type), maxPlayers(maxPlayers), currentPlayerCount(currentPlayerCount), inProgress(inProgress) {}
     
-    // Serialize to string
-    std::string Serialize() const;
+    // Serialize into a lobby message
+    void Serialize(MessageWriter& writer) const;
     
-    // Deserialize from string
-    static GameInfo Deserialize(const std::string& data);
+    // Deserialize from a lobby message (check the reader for errors)
+    static GameInfo Deserialize(MessageReader& reader);
+};
+
+// A game hosted by the server: its instance, players and the clients receiving its updates.
+// A room's state is only touched by tasks on the executor worker its id maps to.
+struct GameRoom {
+    int id;
+    std::shared_ptr<Core::Game> game;
+    std::vector<std::shared_ptr<Core::Player>> players;
+    std::vector<int> subscribers;  // Client ids, passed as-is to SendToClients
+    
+    GameRoom(int id, std::shared_ptr<Core::Game> game) : id(id), game(std::move(game)) {}
+    
+    // Player list management (players are keyed by id)
+    std::shared_ptr<Core::Player> FindPlayer(int playerId) const;
+    void AddPlayer(const std::shared_ptr<Core::Player>& player);
+    bool RemovePlayer(int playerId);
 };
 
 // Define callback types
@@ -47,6 +66,14 @@ public:
     // Initialize lobby
     void Initialize();
     
+    // Number of worker threads running hosted games; takes effect on the next
+    // StartServer. With 0, games run on the thread calling Update.
+    void SetRoomWorkerCount(size_t count);
+    
+    // Create solitaire games that only deal numbers the default Core::DealIndex lists
+    // as winnable (load it with DealIndex::LoadDefault first)
+    void SetWinnableDealsOnly(bool winnableOnly);
+    
     // Start a game server
     bool StartServer(int port);
     
@@ -71,13 +98,21 @@ public:
     // Set ready status
     void SetReady(bool ready);
     
-    // Get current game
+    // Get current game. On a server this is the host's own copy of its room's game,
+    // loaded by Update on the caller's thread; the room's instance stays with its worker.
     std::shared_ptr<Core::Game> GetCurrentGame() const;
     
+    // Make a move as the local player. The room applies it and broadcasts the result,
+    // and the current game catches up in Update (server) or from the broadcast (client).
+    bool SubmitMove(const Core::Move& move);
+    
+    // Make a move given as string move data, parsed by the current game
+    bool SubmitMove(const std::string& moveData);
+    
     // Get list of available games
     std::vector<GameInfo> GetAvailableGames() const;
     
-    // Get list of players in current game
+    // Get list of players in current game (on a server, copies of the room's players)
     std::vector<std::shared_ptr<Core::Player>> GetPlayersInGame() const;
     
     // Get local player
@@ -89,7 +124,9 @@ public:
     // Process network messages
     void Update();
     
-    // Set callbacks
+    // Set callbacks. A server's game start callback runs in Update with a copy of the
+    // started game (the host's current game for its own room); the room's instance
+    // stays with its worker.
     void SetLobbyUpdateCallback(LobbyUpdateCallback callback);
     void SetGameStartCallback(GameStartCallback callback);
     
@@ -99,17 +136,43 @@ private:
     
     // Local player info
     std::shared_ptr<Core::Player> m_localPlayer;
-    int m_currentGameId;
+    std::atomic<int> m_currentGameId;
     bool m_isHost;
     
-    // Game info (server only)
+    // Game info (server; mirrored from the game list on clients)
     std::unordered_map<int, GameInfo> m_games;
     int m_nextGameId;
     
-    // Current game (if joined)
+    // Hosted games by id (server only, guarded by m_gamesMutex)
+    std::unordered_map<int, std::shared_ptr<GameRoom>> m_rooms;
+    
+    // Runs room tasks, sharded by game id (server only)
+    RoomExecutor m_executor;
+    size_t m_roomWorkerCount;
+    bool m_winnableDealsOnly;
+    
+    // Current game (if joined). On the server, a copy owned by the host's thread.
     std::shared_ptr<Core::Game> m_currentGame;
+    bool m_awaitingGameState;  // Client: a delta didn't apply, ignore deltas until a full state arrives
     std::vector<std::shared_ptr<Core::Player>> m_playersInGame;
     
+    // Server: room state published by a room's worker for the thread calling Update
+    // (guarded by m_playersMutex). The host's room keeps only its latest state, which
+    // Update loads into m_currentGame; other rooms queue their starts, which Update
+    // loads into new instances for the game start callback.
+    struct PublishedGameState {
+        bool pending = false;
+        bool started = false;  // Published by the game starting; Update runs the start callback
+        int gameId = -1;
+        Core::GameType type = Core::GameType::SOLITAIRE_KLONDIKE;
+        uint32_t sequence = 0;
+        bool snapshot = false;
+        std::string data;
+        std::vector<Core::Player> players;  // Other rooms only
+    };
+    PublishedGameState m_hostGameState;
+    std::vector<PublishedGameState> m_startedGames;
+    
     // Synchronization
     mutable std::mutex m_gamesMutex;
     mutable std::mutex m_playersMutex;
@@ -118,13 +181,52 @@ private:
     LobbyUpdateCallback m_lobbyUpdateCallback;
     GameStartCallback m_gameStartCallback;
     
-    // Message handling
+    // Message handling: decode the header and dispatch on the opcode
     void HandleNetworkMessage(const std::string& message, int clientId);
     
-    // Message sending helpers
+    // Handlers for each opcode, called with the reader positioned after the header
+    using MessageHandler = void (Lobby::*)(MessageReader& reader, int clientId);
+    
+    // Server side
+    void HandleGetGames(MessageReader& reader, int clientId);
+    void HandleJoinGame(MessageReader& reader, int clientId);
+    void HandleLeaveGame(MessageReader& reader, int clientId);
+    void HandleGetPlayers(MessageReader& reader, int clientId);
+    void HandleSetReady(MessageReader& reader, int clientId);
+    void HandleStartGameRequest(MessageReader& reader, int clientId);
+    void HandleGameMoveRequest(MessageReader& reader, int clientId);
+    void HandleGetGameState(MessageReader& reader, int clientId);
+    
+    // Client side
+    void HandleGameList(MessageReader& reader, int clientId);
+    void HandleJoinGameResponse(MessageReader& reader, int clientId);
+    void HandlePlayerList(MessageReader& reader, int clientId);
+    void HandleGameStarted(MessageReader& reader, int clientId);
+    void HandleGameMove(MessageReader& reader, int clientId);
+    void HandleGameState(MessageReader& reader, int clientId);
+    
+    // Message sending helpers. The room variants run on the room's worker.
     void SendGameList(int clientId = -1);
-    void SendPlayerList(int gameId, int clientId = -1);
-    void SendGameState(int gameId, int clientId = -1);
+    void SendPlayerList(const GameRoom& room, int clientId = -1);
+    void SendGameState(const GameRoom& room, int clientId = -1);
+    
+    // Client: apply a full game state, or ask the server for one after a missed delta
+    void ApplyGameState(int gameId, uint32_t sequence, bool snapshot, const std::string& gameState);
+    void RequestGameState(int gameId);
+    
+    // Room tasks: apply a player's move and broadcast it, and hand a room's state to
+    // the thread calling Update
+    void ApplyRoomMove(GameRoom& room, int playerId, const Core::Move& move);
+    void PublishGameState(const GameRoom& room, bool started);
+    static bool LoadGameState(Core::Game& game, const PublishedGameState& state);
+    
+    // Queue a task on the worker owning a room. Returns false if the room doesn't exist.
+    bool PostToRoom(int gameId, std::function<void(GameRoom&)> task);
+    
+    // Room tasks. Remove a player, destroying the room when it empties
+    // (false if the player wasn't in it), or start the room's game.
+    bool RemovePlayerFromRoom(GameRoom& room, int playerId);
+    bool StartRoom(GameRoom& room, bool requireReady);
     
     // Create a new game instance based on type
     std::shared_ptr<Core::Game> CreateGameInstance(Core::GameType type);
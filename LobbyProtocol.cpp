@@ -0,0 +1,165 @@
+#include "network/LobbyProtocol.h"
+#include <limits>
+
+namespace CardGameLib {
+namespace Network {
+
+namespace {
+    // A 64-bit varint never needs more than 10 bytes
+    const size_t MAX_VARINT_BYTES = 10;
+}
+
+MessageWriter::MessageWriter(LobbyOpcode opcode, size_t reserve)
+{
+    m_buffer.reserve(2 + reserve);
+    m_buffer.push_back(static_cast<char>(LOBBY_PROTOCOL_VERSION));
+    m_buffer.push_back(static_cast<char>(opcode));
+}
+
+void MessageWriter::WriteBool(bool value)
+{
+    m_buffer.push_back(value ? 1 : 0);
+}
+
+void MessageWriter::WriteUInt8(uint8_t value)
+{
+    m_buffer.push_back(static_cast<char>(value));
+}
+
+void MessageWriter::WriteVarUInt(uint64_t value)
+{
+    while (value >= 0x80) {
+        m_buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    m_buffer.push_back(static_cast<char>(value));
+}
+
+void MessageWriter::WriteVarInt(int64_t value)
+{
+    // Zigzag so small negative values stay short
+    uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    WriteVarUInt(zigzag);
+}
+
+void MessageWriter::WriteString(std::string_view value)
+{
+    WriteVarUInt(value.size());
+    m_buffer.append(value.data(), value.size());
+}
+
+const std::string& MessageWriter::GetBuffer() const
+{
+    return m_buffer;
+}
+
+MessageReader::MessageReader(std::string_view message)
+    : m_data(message)
+    , m_position(0)
+    , m_error(false)
+{
+}
+
+bool MessageReader::ReadHeader(LobbyOpcode& opcode)
+{
+    uint8_t version = ReadUInt8();
+    uint8_t value = ReadUInt8();
+    
+    if (m_error || version != LOBBY_PROTOCOL_VERSION) {
+        m_error = true;
+        return false;
+    }
+    
+    opcode = static_cast<LobbyOpcode>(value);
+    return true;
+}
+
+bool MessageReader::ReadBool()
+{
+    uint8_t value = ReadUInt8();
+    
+    if (value > 1) {
+        m_error = true;
+        return false;
+    }
+    
+    return value != 0;
+}
+
+uint8_t MessageReader::ReadUInt8()
+{
+    if (m_error || m_position >= m_data.size()) {
+        m_error = true;
+        return 0;
+    }
+    
+    return static_cast<uint8_t>(m_data[m_position++]);
+}
+
+uint64_t MessageReader::ReadVarUInt()
+{
+    uint64_t value = 0;
+    
+    for (size_t i = 0; i < MAX_VARINT_BYTES; ++i) {
+        if (m_error || m_position >= m_data.size()) {
+            m_error = true;
+            return 0;
+        }
+        
+        uint8_t byte = static_cast<uint8_t>(m_data[m_position++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+        
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    
+    // Too many continuation bytes
+    m_error = true;
+    return 0;
+}
+
+int64_t MessageReader::ReadVarInt()
+{
+    uint64_t zigzag = ReadVarUInt();
+    return static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+}
+
+int MessageReader::ReadInt()
+{
+    int64_t value = ReadVarInt();
+    
+    if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+        m_error = true;
+        return 0;
+    }
+    
+    return static_cast<int>(value);
+}
+
+std::string MessageReader::ReadString()
+{
+    uint64_t length = ReadVarUInt();
+    
+    if (m_error || length > m_data.size() - m_position) {
+        m_error = true;
+        return std::string();
+    }
+    
+    std::string value(m_data.data() + m_position, static_cast<size_t>(length));
+    m_position += static_cast<size_t>(length);
+    return value;
+}
+
+bool MessageReader::HasError() const
+{
+    return m_error;
+}
+
+bool MessageReader::AtEnd() const
+{
+    return m_position >= m_data.size();
+}
+
+} // namespace Network
+} // namespace CardGameLib
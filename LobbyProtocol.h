@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+namespace CardGameLib {
+namespace Network {
+
+// Binary lobby protocol.
+//
+// Every message starts with a fixed two-byte header: the protocol version and the
+// opcode. The fields that follow are, in order:
+//   integers  - LEB128 varints; signed values are zigzag encoded first
+//   booleans  - one byte, 0 or 1
+//   strings   - varint byte length, then the bytes (game states and move data too)
+//   gameState - snapshot flag, then a string with the binary snapshot (Core::Game::WriteSnapshot)
+//               or, for games without one, the text state
+//   move      - four bytes: the move type, then three operands (Core::Move, 0xFF for none)
+//
+//   GET_GAMES            (none)
+//   GAME_LIST            count, then per game: id, name, type, maxPlayers, currentPlayerCount, inProgress
+//   JOIN_GAME            gameId, playerName
+//   JOIN_GAME_RESPONSE   gameId, success, then playerId on success or error otherwise
+//   LEAVE_GAME           gameId
+//   GET_PLAYERS          gameId
+//   PLAYER_LIST          gameId, count, then per player: id, name, ready, host
+//   SET_READY            gameId, ready
+//   START_GAME           gameId (+ sequence, gameState from the server)
+//   GAME_MOVE            gameId, move from a client (made as its own player); from the
+//                        server gameId, playerId, hasDelta, then delta or sequence, gameState
+//   GAME_STATE           gameId, sequence, gameState
+//   GET_GAME_STATE       gameId
+//
+// Moves are numbered by a per-game sequence. A delta (Core::GameDelta) carries the
+// pile operations of one move; a client that can't apply one in order asks for the
+// full state with GET_GAME_STATE.
+static constexpr uint8_t LOBBY_PROTOCOL_VERSION = 5;
+
+enum class LobbyOpcode : uint8_t {
+    GET_GAMES,
+    GAME_LIST,
+    JOIN_GAME,
+    JOIN_GAME_RESPONSE,
+    LEAVE_GAME,
+    GET_PLAYERS,
+    PLAYER_LIST,
+    SET_READY,
+    START_GAME,
+    GAME_MOVE,
+    GAME_STATE,
+    GET_GAME_STATE,
+    COUNT
+};
+
+// Builds one message. The header is written on construction.
+class MessageWriter {
+public:
+    explicit MessageWriter(LobbyOpcode opcode, size_t reserve = 32);
+    
+    // Field encoders
+    void WriteBool(bool value);
+    void WriteUInt8(uint8_t value);
+    void WriteVarUInt(uint64_t value);
+    void WriteVarInt(int64_t value);
+    void WriteString(std::string_view value);
+    
+    // Encoded message
+    const std::string& GetBuffer() const;
+    
+private:
+    std::string m_buffer;
+};
+
+// Reads the fields of one message in order. Any read past the end or malformed
+// field sets a sticky error, after which all reads fail and return zero values.
+class MessageReader {
+public:
+    explicit MessageReader(std::string_view message);
+    
+    // Validate the version and read the opcode (opcodes are not range checked)
+    bool ReadHeader(LobbyOpcode& opcode);
+    
+    // Field decoders
+    bool ReadBool();
+    uint8_t ReadUInt8();
+    uint64_t ReadVarUInt();
+    int64_t ReadVarInt();
+    int ReadInt();
+    std::string ReadString();
+    
+    // Error state and remaining input
+    bool HasError() const;
+    bool AtEnd() const;
+    
+private:
+    std::string_view m_data;
+    size_t m_position;
+    bool m_error;
+};
+
+} // namespace Network
+} // namespace CardGameLib
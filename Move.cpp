@@ -0,0 +1,62 @@
+#include "core/Move.h"
+
+namespace CardGameLib {
+namespace Core {
+
+bool Move::Parse(const std::string& moveData, Move& move)
+{
+    uint8_t fields[1 + MAX_ARGS] = { NO_ARG, NO_ARG, NO_ARG, NO_ARG };
+    size_t fieldCount = 0;
+    size_t i = 0;
+    
+    while (true) {
+        while (i < moveData.size() && moveData[i] == ' ') {
+            ++i;
+        }
+        if (i == moveData.size()) {
+            break;
+        }
+        if (fieldCount == 1 + MAX_ARGS || moveData[i] < '0' || moveData[i] > '9') {
+            return false;
+        }
+        
+        int value = 0;
+        while (i < moveData.size() && moveData[i] >= '0' && moveData[i] <= '9') {
+            value = value * 10 + (moveData[i++] - '0');
+            if (value >= NO_ARG) {
+                return false;
+            }
+        }
+        if (i < moveData.size() && moveData[i] != ' ') {
+            return false;
+        }
+        
+        fields[fieldCount++] = static_cast<uint8_t>(value);
+    }
+    
+    if (fieldCount == 0) {
+        return false;
+    }
+    
+    move.type = fields[0];
+    for (size_t arg = 0; arg < MAX_ARGS; ++arg) {
+        move.args[arg] = fields[1 + arg];
+    }
+    return true;
+}
+
+std::string Move::ToString() const
+{
+    std::string data = std::to_string(type);
+    for (uint8_t arg : args) {
+        if (arg == NO_ARG) {
+            break;
+        }
+        data += ' ';
+        data += std::to_string(arg);
+    }
+    return data;
+}
+
+} // namespace Core
+} // namespace CardGameLib
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+namespace CardGameLib {
+namespace Core {
+
+// A move in binary form: the game's move type (its move type enum value) and up to
+// three small operands, such as pile indices and a card count. Games validate and
+// apply Moves without parsing or allocating; the string move data ("type arg arg")
+// is only an adapter for text protocols and tools.
+struct Move {
+    static constexpr size_t MAX_ARGS = 3;
+    static constexpr uint8_t NO_ARG = 0xFF;  // An operand the move leaves out
+    
+    uint8_t type;
+    uint8_t args[MAX_ARGS];
+    
+    // Build a move from a game's move type and operands
+    template <typename MoveType>
+    static constexpr Move Make(MoveType type, int a = NO_ARG, int b = NO_ARG, int c = NO_ARG)
+    {
+        return Move{ static_cast<uint8_t>(type), { static_cast<uint8_t>(a), static_cast<uint8_t>(b),
+                                                   static_cast<uint8_t>(c) } };
+    }
+    
+    // Parse string move data: the type then up to three operands, each 0-254.
+    // Fails on anything else.
+    static bool Parse(const std::string& moveData, Move& move);
+    
+    // String move data for the move (the operands it has)
+    std::string ToString() const;
+};
+
+static_assert(sizeof(Move) == 4, "Move must pack into four bytes");
+static_assert(std::is_trivially_copyable<Move>::value, "Move must be trivially copyable");
+
+// Fixed-capacity list of moves, filled by Game::GenerateMoves. It lives on the
+// stack and never allocates; CAPACITY is above the most legal moves any solitaire
+// position can have (Spider's bound is under 350).
+class MoveList {
+public:
+    static constexpr size_t CAPACITY = 512;
+    
+    MoveList() : m_size(0) {}
+    
+    void Clear() { m_size = 0; }
+    
+    // Append a move; ignored once the list is full
+    void Add(const Move& move)
+    {
+        if (m_size < CAPACITY) {
+            m_moves[m_size++] = move;
+        }
+    }
+    
+    size_t Size() const { return m_size; }
+    bool IsEmpty() const { return m_size == 0; }
+    
+    const Move& operator[](size_t index) const { return m_moves[index]; }
+    const Move* begin() const { return m_moves; }
+    const Move* end() const { return m_moves + m_size; }
+    
+private:
+    Move m_moves[CAPACITY];
+    size_t m_size;
+};
+
+} // namespace Core
+} // namespace CardGameLib
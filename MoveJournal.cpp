@@ -0,0 +1,115 @@
+#include "core/MoveJournal.h"
+
+namespace CardGameLib {
+namespace Core {
+
+MoveJournal::MoveJournal()
+    : m_current(0)
+    , m_recording(false)
+{
+}
+
+void MoveJournal::Clear()
+{
+    m_ops.clear();
+    m_moveStarts.clear();
+    m_current = 0;
+    m_recording = false;
+}
+
+void MoveJournal::BeginMove()
+{
+    // A new move replaces the undone ones
+    if (m_current < m_moveStarts.size()) {
+        m_ops.resize(m_moveStarts[m_current]);
+        m_moveStarts.resize(m_current);
+    }
+    
+    // Reuse the last move if it recorded nothing
+    if (m_moveStarts.empty() || m_moveStarts.back() != m_ops.size()) {
+        m_moveStarts.push_back(static_cast<uint32_t>(m_ops.size()));
+    }
+    
+    m_current = m_moveStarts.size();
+    m_recording = true;
+}
+
+void MoveJournal::Record(const PileOp& op)
+{
+    if (m_recording) {
+        m_ops.push_back(op);
+    }
+}
+
+bool MoveJournal::CanUndo() const
+{
+    return GetUndoableCount() > 0;
+}
+
+bool MoveJournal::CanRedo() const
+{
+    return m_current < m_moveStarts.size();
+}
+
+bool MoveJournal::Undo(const PileOp*& ops, size_t& count)
+{
+    if (!CanUndo()) {
+        return false;
+    }
+    
+    // Drop a move that recorded nothing
+    if (GetUndoableCount() < m_current) {
+        m_moveStarts.pop_back();
+        --m_current;
+    }
+    
+    --m_current;
+    ops = m_ops.data() + m_moveStarts[m_current];
+    count = GetMoveEnd(m_current) - m_moveStarts[m_current];
+    m_recording = false;
+    return true;
+}
+
+bool MoveJournal::Redo(const PileOp*& ops, size_t& count)
+{
+    if (!CanRedo()) {
+        return false;
+    }
+    
+    ops = m_ops.data() + m_moveStarts[m_current];
+    count = GetMoveEnd(m_current) - m_moveStarts[m_current];
+    ++m_current;
+    m_recording = false;
+    return true;
+}
+
+PileOp MoveJournal::Invert(const PileOp& op)
+{
+    // Swap the piles and the face flags; a reversed transfer undoes itself
+    uint8_t flags = op.flags & PILE_OP_REVERSE;
+    if (op.flags & PILE_OP_FACE_UP) {
+        flags |= PILE_OP_FACE_DOWN;
+    }
+    if (op.flags & PILE_OP_FACE_DOWN) {
+        flags |= PILE_OP_FACE_UP;
+    }
+    
+    return PileOp{ op.target, op.source, op.count, flags };
+}
+
+size_t MoveJournal::GetUndoableCount() const
+{
+    // Only the newest move can be empty, since BeginMove reuses an empty move
+    if (m_current > 0 && m_current == m_moveStarts.size() && m_moveStarts.back() == m_ops.size()) {
+        return m_current - 1;
+    }
+    return m_current;
+}
+
+size_t MoveJournal::GetMoveEnd(size_t move) const
+{
+    return move + 1 < m_moveStarts.size() ? m_moveStarts[move + 1] : m_ops.size();
+}
+
+} // namespace Core
+} // namespace CardGameLib
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "core/GameDelta.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace CardGameLib {
+namespace Core {
+
+// Undo/redo history of a pile-based game. Each move is the run of pile operations
+// it made, and all moves sit back to back in one operation arena, so undoing or
+// redoing a move costs only its own operations. Face flags are kept on an
+// operation only when it actually turned its cards, which makes every operation
+// exactly invertible.
+class MoveJournal {
+public:
+    MoveJournal();
+    
+    // Forget all moves
+    void Clear();
+    
+    // Start recording a new move, dropping the moves that could be redone
+    void BeginMove();
+    
+    // Record an operation of the move being made (ignored when none is)
+    void Record(const PileOp& op);
+    
+    bool CanUndo() const;
+    bool CanRedo() const;
+    
+    // Step back over the last move. ops and count receive its operations in the
+    // order they were made; undo them last to first with Invert. The pointer stays
+    // valid until the next BeginMove or Record.
+    bool Undo(const PileOp*& ops, size_t& count);
+    
+    // Step forward over the next undone move, whose operations are replayed as is
+    bool Redo(const PileOp*& ops, size_t& count);
+    
+    // The operation that reverses op
+    static PileOp Invert(const PileOp& op);
+    
+private:
+    std::vector<PileOp> m_ops;            // Operations of all moves, oldest first
+    std::vector<uint32_t> m_moveStarts;   // Index of each move's first operation
+    size_t m_current;                     // Moves currently applied; the rest can be redone
+    bool m_recording;                     // A move is being made
+    
+    size_t GetUndoableCount() const;
+    size_t GetMoveEnd(size_t move) const;
+};
+
+} // namespace Core
+} // namespace CardGameLib
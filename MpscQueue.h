@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace CardGameLib {
+namespace Network {
+
+// Unbounded lock-free multi-producer single-consumer queue (Vyukov's node-based design).
+//
+// Producers link a new node in with a single atomic exchange on the head and never
+// wait for each other or for the consumer. The consumer pops from the tail without
+// any atomic read-modify-write. A push that has swapped the head but not yet linked
+// its node is briefly invisible to Pop; the producer finishes the link right after.
+//
+// T must be default constructible (the queue keeps one spare node).
+template<typename T>
+class MpscQueue {
+public:
+    MpscQueue()
+        : m_head(new Node())
+        , m_tail(m_head.load(std::memory_order_relaxed))
+    {
+    }
+    
+    ~MpscQueue()
+    {
+        T value;
+        while (Pop(value)) {
+        }
+        delete m_tail;
+    }
+    
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    
+    // Append a value (any thread)
+    void Push(T value)
+    {
+        Node* node = new Node(std::move(value));
+        Node* previous = m_head.exchange(node, std::memory_order_seq_cst);
+        previous->next.store(node, std::memory_order_seq_cst);
+    }
+    
+    // Remove the oldest value (consumer thread only)
+    bool Pop(T& value)
+    {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        
+        if (!next) {
+            return false;
+        }
+        
+        value = std::move(next->value);
+        next->value = T();
+        m_tail = next;
+        delete tail;
+        return true;
+    }
+    
+    // True if Pop would currently fail (consumer thread only)
+    bool IsEmpty() const
+    {
+        return m_tail->next.load(std::memory_order_seq_cst) == nullptr;
+    }
+    
+private:
+    struct Node {
+        std::atomic<Node*> next;
+        T value;
+        
+        Node() : next(nullptr), value() {}
+        explicit Node(T&& value) : next(nullptr), value(std::move(value)) {}
+    };
+    
+    // Producers swap the head; the consumer owns the tail (the spare node)
+    alignas(64) std::atomic<Node*> m_head;
+    alignas(64) Node* m_tail;
+};
+
+} // namespace Network
+} // namespace CardGameLib
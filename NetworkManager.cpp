@@ -44,7 +44,7 @@ bool NetworkManager::StartServer(int port)
     m_server = std::make_unique<GameServer>();
     
     // Set up server callback
-    m_server->SetMessageCallback([this](const std::string& message, int clientId) {
+    m_server->SetMessageCallback([this](std::string_view message, int clientId) {
         OnServerMessage(message, clientId);
     });
     
@@ -83,7 +83,7 @@ bool NetworkManager::Connect(const std::string& host, int port)
     m_client = std::make_unique<GameClient>();
     
     // Set up client callback
-    m_client->SetMessageCallback([this](const std::string& message) {
+    m_client->SetMessageCallback([this](std::string_view message) {
         OnClientMessage(message);
     });
     
@@ -129,6 +129,15 @@ bool NetworkManager::SendToClient(int clientId, const std::string& message)
     return m_server->SendToClient(clientId, message);
 }
 
+bool NetworkManager::SendToClients(const std::vector<int>& clientIds, const std::string& message)
+{
+    if (m_mode != NetworkMode::SERVER || !m_server) {
+        return false;
+    }
+    
+    return m_server->SendToClients(clientIds, message);
+}
+
 bool NetworkManager::SendToAllClients(const std::string& message)
 {
     if (m_mode != NetworkMode::SERVER || !m_server) {
@@ -187,19 +196,19 @@ std::vector<int> NetworkManager::GetConnectedClientIds() const
     return {};
 }
 
-void NetworkManager::OnServerMessage(const std::string& message, int clientId)
+void NetworkManager::OnServerMessage(std::string_view message, int clientId)
 {
-    // Queue the message for processing in the main thread
+    // Queue the message for processing in the main thread (the only copy made)
     std::lock_guard<std::mutex> lock(m_messageMutex);
-    m_messageQueue.push(std::make_pair(message, clientId));
+    m_messageQueue.emplace(std::string(message), clientId);
 }
 
-void NetworkManager::OnClientMessage(const std::string& message)
+void NetworkManager::OnClientMessage(std::string_view message)
 {
     // Queue the message for processing in the main thread
     // clientId -1 indicates it's from the server
     std::lock_guard<std::mutex> lock(m_messageMutex);
-    m_messageQueue.push(std::make_pair(message, -1));
+    m_messageQueue.emplace(std::string(message), -1);
 }
 
 } // namespace Network
@@ -7,6 +7,7 @@
 #include <thread>
 #include <mutex>
 #include <queue>
+#include <string_view>
 
 #include "network/Socket.h"
 #include "network/GameServer.h"
@@ -46,6 +47,7 @@ public:
     // Send messages
     bool SendToServer(const std::string& message);
     bool SendToClient(int clientId, const std::string& message);
+    bool SendToClients(const std::vector<int>& clientIds, const std::string& message);
     bool SendToAllClients(const std::string& message);
     
     // Message handling
@@ -72,8 +74,8 @@ private:
     std::mutex m_messageMutex;
     
     // Internal callback handlers
-    void OnServerMessage(const std::string& message, int clientId);
-    void OnClientMessage(const std::string& message);
+    void OnServerMessage(std::string_view message, int clientId);
+    void OnClientMessage(std::string_view message);
 };
 
 } // namespace Network
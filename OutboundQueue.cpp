@@ -0,0 +1,132 @@
+#include "network/OutboundQueue.h"
+
+namespace CardGameLib {
+namespace Network {
+
+OutboundFrame::OutboundFrame(std::string&& message)
+    : payload(std::move(message))
+{
+    FrameDecoder::EncodeHeader(static_cast<uint32_t>(payload.size()), header);
+}
+
+SharedFrame OutboundFrame::Create(std::string message)
+{
+    return std::make_shared<const OutboundFrame>(std::move(message));
+}
+
+OutboundQueue::OutboundQueue(size_t highWaterMark)
+    : m_headOffset(0)
+    , m_pendingBytes(0)
+    , m_highWaterMark(highWaterMark)
+{
+}
+
+bool OutboundQueue::Push(const SharedFrame& frame)
+{
+    if (!frame) {
+        return false;
+    }
+    
+    size_t frameSize = frame->Size();
+    
+    if (!m_frames.empty() && m_pendingBytes + frameSize > m_highWaterMark) {
+        return false;
+    }
+    
+    m_frames.push_back(frame);
+    m_pendingBytes += frameSize;
+    return true;
+}
+
+FlushResult OutboundQueue::Flush(Socket& socket)
+{
+    while (!m_frames.empty()) {
+        // Gather headers and payloads of as many frames as fit in one call
+        SendBuffer buffers[Socket::MAX_SEND_BUFFERS];
+        int bufferCount = 0;
+        size_t batchBytes = 0;
+        size_t offset = m_headOffset;
+        
+        for (auto it = m_frames.begin(); it != m_frames.end() && bufferCount + 2 <= Socket::MAX_SEND_BUFFERS; ++it) {
+            const OutboundFrame& frame = **it;
+            
+            if (offset < FrameDecoder::HEADER_SIZE) {
+                buffers[bufferCount++] = { frame.header + offset, FrameDecoder::HEADER_SIZE - offset };
+                batchBytes += FrameDecoder::HEADER_SIZE - offset;
+                offset = 0;
+            } else {
+                offset -= FrameDecoder::HEADER_SIZE;
+            }
+            
+            if (offset < frame.payload.size()) {
+                buffers[bufferCount++] = { frame.payload.data() + offset, frame.payload.size() - offset };
+                batchBytes += frame.payload.size() - offset;
+            }
+            
+            offset = 0;
+        }
+        
+        int bytesSent = socket.SendVectored(buffers, bufferCount);
+        
+        if (bytesSent < 0) {
+            return Socket::WouldBlock() ? FlushResult::PENDING : FlushResult::FAILED;
+        }
+        
+        Consume(static_cast<size_t>(bytesSent));
+        
+        // A short write means the socket's send buffer is full
+        if (static_cast<size_t>(bytesSent) < batchBytes) {
+            return FlushResult::PENDING;
+        }
+    }
+    
+    return FlushResult::DRAINED;
+}
+
+bool OutboundQueue::IsEmpty() const
+{
+    return m_frames.empty();
+}
+
+size_t OutboundQueue::PendingBytes() const
+{
+    return m_pendingBytes;
+}
+
+void OutboundQueue::Clear()
+{
+    m_frames.clear();
+    m_headOffset = 0;
+    m_pendingBytes = 0;
+}
+
+void OutboundQueue::SetHighWaterMark(size_t bytes)
+{
+    m_highWaterMark = bytes;
+}
+
+size_t OutboundQueue::GetHighWaterMark() const
+{
+    return m_highWaterMark;
+}
+
+void OutboundQueue::Consume(size_t bytes)
+{
+    m_pendingBytes -= bytes;
+    
+    while (bytes > 0 && !m_frames.empty()) {
+        size_t remaining = m_frames.front()->Size() - m_headOffset;
+        
+        if (bytes < remaining) {
+            m_headOffset += bytes;
+            return;
+        }
+        
+        bytes -= remaining;
+        m_frames.pop_front();
+        m_headOffset = 0;
+    }
+}
+
+} // namespace Network
+} // namespace CardGameLib
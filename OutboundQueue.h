@@ -0,0 +1,77 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <memory>
+#include <cstddef>
+
+#include "network/Socket.h"
+#include "network/FrameDecoder.h"
+
+namespace CardGameLib {
+namespace Network {
+
+struct OutboundFrame;
+
+// Frames are immutable once built, so a broadcast shares one frame
+// between the queues of all its recipients
+using SharedFrame = std::shared_ptr<const OutboundFrame>;
+
+// An outgoing frame; the length prefix is kept beside the payload
+// so the two can be sent with one vectored write instead of being joined
+struct OutboundFrame {
+    char header[FrameDecoder::HEADER_SIZE];
+    std::string payload;
+    
+    explicit OutboundFrame(std::string&& message);
+    
+    // Frame a message with a single allocation (the payload is moved, not copied)
+    static SharedFrame Create(std::string message);
+    
+    size_t Size() const { return FrameDecoder::HEADER_SIZE + payload.size(); }
+};
+
+// Result of draining an outbound queue into a socket
+enum class FlushResult {
+    DRAINED,  // Everything was written
+    PENDING,  // The socket would block; wait for writability
+    FAILED    // The connection is broken
+};
+
+// Per-connection queue of frames waiting to be written.
+// Not thread-safe; the owner serializes access.
+class OutboundQueue {
+public:
+    // Default limit on unsent bytes per connection
+    static constexpr size_t DEFAULT_HIGH_WATER_MARK = 1024 * 1024;
+    
+    explicit OutboundQueue(size_t highWaterMark = DEFAULT_HIGH_WATER_MARK);
+    
+    // Queue a frame. Fails without queuing if the unsent bytes would exceed
+    // the high-water mark (a single frame is always accepted into an empty queue).
+    bool Push(const SharedFrame& frame);
+    
+    // Write as many queued frames as the socket accepts, many frames per call
+    FlushResult Flush(Socket& socket);
+    
+    // Queue state
+    bool IsEmpty() const;
+    size_t PendingBytes() const;
+    void Clear();
+    
+    // Backpressure limit
+    void SetHighWaterMark(size_t bytes);
+    size_t GetHighWaterMark() const;
+    
+private:
+    std::deque<SharedFrame> m_frames;
+    size_t m_headOffset;      // Bytes of the front frame already written
+    size_t m_pendingBytes;    // Unsent bytes across all frames
+    size_t m_highWaterMark;
+    
+    // Drop written bytes from the front of the queue
+    void Consume(size_t bytes);
+};
+
+} // namespace Network
+} // namespace CardGameLib
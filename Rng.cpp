@@ -0,0 +1,51 @@
+#include "core/Rng.h"
+#include <atomic>
+#include <chrono>
+#include <random>
+
+namespace CardGameLib {
+namespace Core {
+
+namespace {
+    const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+    
+    // splitmix64: spreads any seed, including zero, over the full xoshiro state
+    uint64_t SplitMix64(uint64_t& state)
+    {
+        uint64_t z = (state += GOLDEN_GAMMA);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    
+    uint64_t InitialSeedCounter()
+    {
+        std::random_device device;
+        uint64_t entropy = (static_cast<uint64_t>(device()) << 32) | device();
+        return entropy ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+}
+
+Rng::Rng(uint64_t seed)
+{
+    Seed(seed);
+}
+
+void Rng::Seed(uint64_t seed)
+{
+    for (auto& word : m_state) {
+        word = SplitMix64(seed);
+    }
+}
+
+uint64_t Rng::RandomSeed()
+{
+    // Entropy is read once per process; the counter keeps later seeds distinct
+    static std::atomic<uint64_t> counter(InitialSeedCounter());
+    
+    uint64_t state = counter.fetch_add(GOLDEN_GAMMA, std::memory_order_relaxed);
+    return SplitMix64(state);
+}
+
+} // namespace Core
+} // namespace CardGameLib
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+namespace CardGameLib {
+namespace Core {
+
+// Small, fast pseudo-random generator (xoshiro256**) seeded through splitmix64.
+//
+// The whole state is 32 bytes, so generators are cheap to create, copy and reseed,
+// and the same seed gives the same sequence on every platform. Meets the standard
+// UniformRandomBitGenerator requirements. Not suitable for cryptographic use.
+class Rng {
+public:
+    using result_type = uint64_t;
+    
+    explicit Rng(uint64_t seed);
+    
+    // Restart the sequence from a seed
+    void Seed(uint64_t seed);
+    
+    // Next 64 random bits
+    uint64_t Next()
+    {
+        const uint64_t result = RotateLeft(m_state[1] * 5, 7) * 9;
+        const uint64_t t = m_state[1] << 17;
+        
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = RotateLeft(m_state[3], 45);
+        
+        return result;
+    }
+    
+    // Uniform value in [0, bound) without modulo bias (bound must be non-zero)
+    uint32_t NextBelow(uint32_t bound)
+    {
+        // Lemire's multiply-shift, rejecting the few values that would skew the result
+        uint64_t product = (Next() >> 32) * bound;
+        uint32_t low = static_cast<uint32_t>(product);
+        
+        if (low < bound) {
+            const uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                product = (Next() >> 32) * bound;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        
+        return static_cast<uint32_t>(product >> 32);
+    }
+    
+    // UniformRandomBitGenerator interface
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+    result_type operator()() { return Next(); }
+    
+    // A seed that differs between calls and between runs, for unnumbered deals
+    static uint64_t RandomSeed();
+    
+private:
+    static uint64_t RotateLeft(uint64_t value, int shift)
+    {
+        return (value << shift) | (value >> (64 - shift));
+    }
+    
+    uint64_t m_state[4];
+};
+
+} // namespace Core
+} // namespace CardGameLib
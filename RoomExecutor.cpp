@@ -0,0 +1,138 @@
+#include "network/RoomExecutor.h"
+
+namespace CardGameLib {
+namespace Network {
+
+RoomExecutor::RoomExecutor()
+    : m_running(false)
+{
+}
+
+RoomExecutor::~RoomExecutor()
+{
+    Stop();
+}
+
+bool RoomExecutor::Start(size_t workerCount)
+{
+    if (m_running) {
+        return false;
+    }
+    
+    m_running = true;
+    
+    m_workers.clear();
+    m_workers.reserve(workerCount);
+    
+    for (size_t i = 0; i < workerCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    
+    for (auto& worker : m_workers) {
+        Worker* target = worker.get();
+        worker->thread = std::thread([this, target]() {
+            WorkerLoop(*target);
+        });
+    }
+    
+    return true;
+}
+
+void RoomExecutor::Stop()
+{
+    if (!m_running) {
+        return;
+    }
+    
+    m_running = false;
+    
+    for (auto& worker : m_workers) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->wakeup.notify_one();
+        }
+        
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    
+    m_workers.clear();
+}
+
+bool RoomExecutor::IsRunning() const
+{
+    return m_running;
+}
+
+size_t RoomExecutor::GetWorkerCount() const
+{
+    return m_workers.size();
+}
+
+void RoomExecutor::Post(int roomId, Task task)
+{
+    if (m_workers.empty()) {
+        // No workers: run on the caller, which keeps everything single-threaded
+        task();
+        return;
+    }
+    
+    Worker& worker = GetWorker(roomId);
+    worker.inbox.Push(std::move(task));
+    
+    // The push and this load are sequentially consistent, as are the worker's store
+    // to sleeping and its emptiness check, so at least one side sees the other
+    if (worker.sleeping.load()) {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.wakeup.notify_one();
+    }
+}
+
+size_t RoomExecutor::DefaultWorkerCount()
+{
+    unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+RoomExecutor::Worker& RoomExecutor::GetWorker(int roomId)
+{
+    // Fibonacci hashing spreads sequential room ids evenly across workers. The high
+    // bits of the product are the well-mixed ones, so scale the product to the worker
+    // count (which need not be a power of two) instead of taking it modulo.
+    uint32_t hash = static_cast<uint32_t>(roomId) * 2654435769u;
+    return *m_workers[static_cast<size_t>((static_cast<uint64_t>(hash) * m_workers.size()) >> 32)];
+}
+
+void RoomExecutor::WorkerLoop(Worker& worker)
+{
+    Task task;
+    
+    while (true) {
+        while (worker.inbox.Pop(task)) {
+            task();
+            task = nullptr;
+        }
+        
+        if (!m_running) {
+            break;
+        }
+        
+        // Park until a producer pushes or the executor stops
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        worker.sleeping.store(true);
+        worker.wakeup.wait(lock, [this, &worker]() {
+            return !worker.inbox.IsEmpty() || !m_running;
+        });
+        worker.sleeping.store(false);
+    }
+    
+    // Run anything posted before Stop
+    while (worker.inbox.Pop(task)) {
+        task();
+        task = nullptr;
+    }
+}
+
+} // namespace Network
+} // namespace CardGameLib
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "network/MpscQueue.h"
+
+namespace CardGameLib {
+namespace Network {
+
+// Runs game-room work on a fixed pool of worker threads.
+//
+// Every room id maps to one worker, so tasks for the same room run one at a time in
+// the order they were posted, while rooms on different workers run in parallel without
+// sharing any lock. Each worker drains its own lock-free inbox and sleeps on a
+// condition variable only when the inbox is empty.
+class RoomExecutor {
+public:
+    using Task = std::function<void()>;
+    
+    RoomExecutor();
+    ~RoomExecutor();
+    
+    // Start the workers. With zero workers, Post runs each task immediately on the
+    // calling thread instead.
+    bool Start(size_t workerCount);
+    
+    // Run every task already posted, then join the workers
+    void Stop();
+    
+    bool IsRunning() const;
+    size_t GetWorkerCount() const;
+    
+    // Queue a task for a room (thread-safe, but not concurrently with Start/Stop)
+    void Post(int roomId, Task task);
+    
+    // One worker per hardware thread
+    static size_t DefaultWorkerCount();
+    
+private:
+    struct Worker {
+        MpscQueue<Task> inbox;
+        std::atomic<bool> sleeping;
+        std::mutex mutex;
+        std::condition_variable wakeup;
+        std::thread thread;
+        
+        Worker() : sleeping(false) {}
+    };
+    
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<bool> m_running;
+    
+    Worker& GetWorker(int roomId);
+    void WorkerLoop(Worker& worker);
+};
+
+} // namespace Network
+} // namespace CardGameLib
@@ -0,0 +1,180 @@
+#include "Shoe.h"
+#include "BlackjackHand.h"
+#include <algorithm>
+
+namespace CardGameLib {
+namespace Games {
+namespace Blackjack {
+
+int ShoeComposition::GetIndex(Core::Card card)
+{
+    return BlackjackHand::GetCardPoints(card.GetRank()) - 1;
+}
+
+void ShoeComposition::Add(Core::Card card)
+{
+    counts[GetIndex(card)]++;
+}
+
+int ShoeComposition::GetTotal() const
+{
+    int total = 0;
+    for (uint16_t count : counts) {
+        total += count;
+    }
+    return total;
+}
+
+uint64_t ShoeComposition::GetHash() const
+{
+    // FNV-1a over the counts
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint16_t count : counts) {
+        hash = (hash ^ (count & 0xFF)) * 1099511628211ULL;
+        hash = (hash ^ (count >> 8)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool ShoeComposition::operator==(const ShoeComposition& other) const
+{
+    return std::equal(counts, counts + VALUES, other.counts);
+}
+
+Shoe::Shoe(int numberOfDecks, float penetration)
+    : Shoe(numberOfDecks, penetration, Core::Rng::RandomSeed())
+{
+}
+
+Shoe::Shoe(int numberOfDecks, float penetration, uint64_t dealNumber)
+    : m_cards(std::max(numberOfDecks, 1))
+    , m_rng(dealNumber)
+    , m_numberOfDecks(std::max(numberOfDecks, 1))
+    , m_penetration(DEFAULT_PENETRATION)
+    , m_position(0)
+    , m_roundStart(0)
+    , m_cutPosition(0)
+{
+    SetPenetration(penetration);
+    Shuffle();
+}
+
+Core::Card Shoe::Draw()
+{
+    if (IsEmpty()) {
+        ReshuffleDiscards();
+    }
+    
+    return m_cards.GetCards()[m_position++];
+}
+
+void Shoe::Shuffle()
+{
+    // Dealt cards never left the deck, so this is a plain in-place shuffle
+    m_cards.Shuffle(m_rng);
+    m_position = 0;
+    m_roundStart = 0;
+}
+
+bool Shoe::ShuffleIfNeeded()
+{
+    if (!IsCutCardReached()) {
+        m_roundStart = m_position;
+        return false;
+    }
+    
+    Shuffle();
+    return true;
+}
+
+void Shoe::Seed(uint64_t dealNumber)
+{
+    m_rng.Seed(dealNumber);
+}
+
+bool Shoe::IsEmpty() const
+{
+    return m_position >= m_cards.Size();
+}
+
+bool Shoe::IsCutCardReached() const
+{
+    return m_position >= m_cutPosition;
+}
+
+size_t Shoe::GetCardsRemaining() const
+{
+    return m_cards.Size() - m_position;
+}
+
+size_t Shoe::GetCardsDealt() const
+{
+    return m_position;
+}
+
+size_t Shoe::Size() const
+{
+    return m_cards.Size();
+}
+
+ShoeComposition Shoe::GetComposition() const
+{
+    ShoeComposition composition;
+    const auto& cards = m_cards.GetCards();
+    
+    for (size_t i = m_position; i < cards.size(); ++i) {
+        composition.Add(cards[i]);
+    }
+    
+    return composition;
+}
+
+int Shoe::GetNumberOfDecks() const
+{
+    return m_numberOfDecks;
+}
+
+float Shoe::GetPenetration() const
+{
+    return m_penetration;
+}
+
+void Shoe::SetPenetration(float penetration)
+{
+    // Outside (0, 1] falls back to the default
+    m_penetration = (penetration > 0.0f && penetration <= 1.0f) ? penetration : DEFAULT_PENETRATION;
+    UpdateCutPosition();
+}
+
+void Shoe::UpdateCutPosition()
+{
+    size_t cut = static_cast<size_t>(static_cast<float>(m_cards.Size()) * m_penetration);
+    m_cutPosition = std::max<size_t>(cut, 1);
+}
+
+void Shoe::ReshuffleDiscards()
+{
+    // With no discards every card is in play, so all of them go back
+    if (m_roundStart == 0) {
+        Shuffle();
+        return;
+    }
+    
+    // Move the round's cards to the front, still dealt, and shuffle the discards
+    // behind them (Fisher-Yates, as Core::Deck does)
+    std::vector<Core::Card>& cards = m_cards.GetCards();
+    std::rotate(cards.begin(), cards.begin() + m_roundStart, cards.begin() + m_position);
+    
+    size_t inPlay = m_position - m_roundStart;
+    for (size_t i = cards.size(); i > inPlay + 1; --i) {
+        size_t j = inPlay + m_rng.NextBelow(static_cast<uint32_t>(i - inPlay));
+        std::swap(cards[i - 1], cards[j]);
+    }
+    
+    m_position = inPlay;
+    m_roundStart = 0;
+}
+
+} // namespace Blackjack
+} // namespace Games
+} // namespace CardGameLib
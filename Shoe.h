@@ -0,0 +1,94 @@
+#pragma once
+
+#include "../../core/Deck.h"
+#include "../../core/Rng.h"
+
+#include <cstdint>
+#include <cstddef>
+
+namespace CardGameLib {
+namespace Games {
+namespace Blackjack {
+
+// Count of cards by blackjack value: index 0 holds aces, 1-8 twos to nines and
+// 9 tens and face cards
+struct ShoeComposition {
+    static constexpr int VALUES = 10;
+    
+    uint16_t counts[VALUES] = {};
+    
+    // Index of a card's value in counts
+    static int GetIndex(Core::Card card);
+    
+    void Add(Core::Card card);
+    int GetTotal() const;
+    
+    // Hash of the counts (equal compositions hash equal)
+    uint64_t GetHash() const;
+    
+    bool operator==(const ShoeComposition& other) const;
+};
+
+// Multi-deck dealing shoe with a cut card.
+//
+// The shoe keeps every card in one Core::Deck and deals by advancing a position,
+// so cards never leave its storage. A reshuffle gathers and shuffles the cards in
+// place, which means dealing and reshuffling never allocate. The cut card sits at
+// the penetration fraction of the shoe. Once it has been dealt, the shoe should be
+// reshuffled before the next round. If the shoe runs out during a round anyway, only
+// the discards of earlier rounds are reshuffled; the cards of the round in progress
+// stay dealt.
+class Shoe {
+public:
+    static constexpr int DEFAULT_DECKS = 6;
+    static constexpr float DEFAULT_PENETRATION = 0.75f;
+    
+    // Create a shuffled shoe, seeded randomly or from a deal number
+    explicit Shoe(int numberOfDecks = DEFAULT_DECKS, float penetration = DEFAULT_PENETRATION);
+    Shoe(int numberOfDecks, float penetration, uint64_t dealNumber);
+    
+    // Deal the next card, reshuffling the discards first if the shoe is empty
+    Core::Card Draw();
+    
+    // Return every card to the shoe and shuffle in place
+    void Shuffle();
+    
+    // Reshuffle if the cut card has been dealt. Call between rounds: it also marks the
+    // start of a round, and the cards dealt before it become discards. Returns true if
+    // it reshuffled.
+    bool ShuffleIfNeeded();
+    
+    // Reseed for a numbered deal; takes effect at the next shuffle
+    void Seed(uint64_t dealNumber);
+    
+    // Shoe state
+    bool IsEmpty() const;
+    bool IsCutCardReached() const;
+    size_t GetCardsRemaining() const;
+    size_t GetCardsDealt() const;
+    size_t Size() const;
+    
+    // Cards not yet dealt, by value
+    ShoeComposition GetComposition() const;
+    
+    // Configuration. Penetration is the fraction dealt before the cut card (0-1].
+    int GetNumberOfDecks() const;
+    float GetPenetration() const;
+    void SetPenetration(float penetration);
+    
+private:
+    Core::Deck m_cards;     // All cards of the shoe, in dealing order
+    Core::Rng m_rng;
+    int m_numberOfDecks;
+    float m_penetration;
+    size_t m_position;      // Index of the next card to deal
+    size_t m_roundStart;    // Index of the current round's first card; those before are discards
+    size_t m_cutPosition;   // Dealing this index means the cut card is out
+    
+    void UpdateCutPosition();
+    void ReshuffleDiscards();
+};
+
+} // namespace Blackjack
+} // namespace Games
+} // namespace CardGameLib
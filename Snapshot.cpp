@@ -0,0 +1,134 @@
+#include "core/Snapshot.h"
+
+namespace CardGameLib {
+namespace Core {
+
+uint8_t EncodeCard(const Card& card)
+{
+    return card.GetCode();
+}
+
+bool DecodeCard(uint8_t code, Card& card)
+{
+    int rank = code & Card::RANK_MASK;
+    
+    if (rank < static_cast<int>(Rank::ACE) || rank > static_cast<int>(Rank::KING) ||
+        (code & ~(Card::RANK_MASK | Card::SUIT_MASK | Card::FACE_UP_BIT)) != 0) {
+        return false;
+    }
+    
+    card = Card::FromCode(code);
+    return true;
+}
+
+SnapshotWriter::SnapshotWriter(uint8_t* buffer, size_t capacity)
+    : m_buffer(buffer)
+    , m_capacity(capacity)
+    , m_size(0)
+    , m_error(false)
+{
+}
+
+void SnapshotWriter::WriteUInt8(uint8_t value)
+{
+    if (m_error || m_size >= m_capacity) {
+        m_error = true;
+        return;
+    }
+    
+    m_buffer[m_size++] = value;
+}
+
+void SnapshotWriter::WriteCard(const Card& card)
+{
+    WriteUInt8(EncodeCard(card));
+}
+
+void SnapshotWriter::WritePile(const std::vector<Card>& pile)
+{
+    // Piles never exceed two decks, so the length fits a byte
+    if (pile.size() > 0xFF || m_error || m_capacity - m_size < 1 + pile.size()) {
+        m_error = true;
+        return;
+    }
+    
+    m_buffer[m_size++] = static_cast<uint8_t>(pile.size());
+    for (const auto& card : pile) {
+        m_buffer[m_size++] = EncodeCard(card);
+    }
+}
+
+size_t SnapshotWriter::GetSize() const
+{
+    return m_size;
+}
+
+bool SnapshotWriter::HasError() const
+{
+    return m_error;
+}
+
+SnapshotReader::SnapshotReader(const uint8_t* data, size_t size)
+    : m_data(data)
+    , m_size(size)
+    , m_position(0)
+    , m_error(false)
+{
+}
+
+uint8_t SnapshotReader::ReadUInt8()
+{
+    if (m_error || m_position >= m_size) {
+        m_error = true;
+        return 0;
+    }
+    
+    return m_data[m_position++];
+}
+
+bool SnapshotReader::ReadCard(Card& card)
+{
+    uint8_t code = ReadUInt8();
+    
+    if (m_error || !DecodeCard(code, card)) {
+        m_error = true;
+        return false;
+    }
+    
+    return true;
+}
+
+bool SnapshotReader::ReadPile(std::vector<Card>& pile)
+{
+    size_t count = ReadUInt8();
+    
+    if (m_error || count > m_size - m_position) {
+        m_error = true;
+        return false;
+    }
+    
+    pile.reserve(pile.size() + count);
+    
+    Card card(Suit::HEARTS, Rank::ACE);
+    for (size_t i = 0; i < count; ++i) {
+        if (!ReadCard(card)) {
+            return false;
+        }
+        pile.push_back(card);
+    }
+    
+    return true;
+}
+
+bool SnapshotReader::HasError() const
+{
+    return m_error;
+}
+
+bool SnapshotReader::AtEnd() const
+{
+    return m_position >= m_size;
+}
+
+} // namespace Core
+} // namespace CardGameLib
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "core/Card.h"
+
+namespace CardGameLib {
+namespace Core {
+
+// Binary game snapshots.
+//
+// Every card takes one byte, its packed Card code. A pile is its length byte followed by its cards. Each
+// game writes its piles in a fixed order after a short header written by Core::Game.
+
+// Encode and decode a single card. DecodeCard fails on an invalid byte.
+uint8_t EncodeCard(const Card& card);
+bool DecodeCard(uint8_t code, Card& card);
+
+// Writes into a caller-supplied buffer and never allocates. Writing past the end
+// sets a sticky error.
+class SnapshotWriter {
+public:
+    SnapshotWriter(uint8_t* buffer, size_t capacity);
+    
+    // Field encoders
+    void WriteUInt8(uint8_t value);
+    void WriteCard(const Card& card);
+    void WritePile(const std::vector<Card>& pile);
+    
+    // Bytes written so far and error state
+    size_t GetSize() const;
+    bool HasError() const;
+    
+private:
+    uint8_t* m_buffer;
+    size_t m_capacity;
+    size_t m_size;
+    bool m_error;
+};
+
+// Reads the fields of a snapshot in order. Reads past the end or invalid cards set a
+// sticky error, after which all reads fail.
+class SnapshotReader {
+public:
+    SnapshotReader(const uint8_t* data, size_t size);
+    
+    // Field decoders. ReadPile appends to the pile.
+    uint8_t ReadUInt8();
+    bool ReadCard(Card& card);
+    bool ReadPile(std::vector<Card>& pile);
+    
+    // Error state and remaining input
+    bool HasError() const;
+    bool AtEnd() const;
+    
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_position;
+    bool m_error;
+};
+
+} // namespace Core
+} // namespace CardGameLib
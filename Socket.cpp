@@ -1,5 +1,6 @@
 #include "network/Socket.h"
 #include <cstring>
+#include <cerrno>
 #include <iostream>
 
 namespace CardGameLib {
@@ -137,6 +138,51 @@ int Socket::Send(const std::string& data)
     return Send(data.c_str(), static_cast<int>(data.size()));
 }
 
+int Socket::SendVectored(const SendBuffer* buffers, int count)
+{
+    if (!IsValid() || !buffers || count <= 0) {
+        return -1;
+    }
+    
+    if (count > MAX_SEND_BUFFERS) {
+        count = MAX_SEND_BUFFERS;
+    }
+    
+#ifdef PLATFORM_WINDOWS
+    WSABUF vectors[MAX_SEND_BUFFERS];
+    for (int i = 0; i < count; ++i) {
+        vectors[i].buf = const_cast<char*>(buffers[i].data);
+        vectors[i].len = static_cast<ULONG>(buffers[i].size);
+    }
+    
+    DWORD bytesSent = 0;
+    if (WSASend(m_handle, vectors, static_cast<DWORD>(count), &bytesSent, 0, nullptr, nullptr) == SOCKET_ERROR) {
+        return -1;
+    }
+    
+    return static_cast<int>(bytesSent);
+#else
+    iovec vectors[MAX_SEND_BUFFERS];
+    for (int i = 0; i < count; ++i) {
+        vectors[i].iov_base = const_cast<char*>(buffers[i].data);
+        vectors[i].iov_len = buffers[i].size;
+    }
+    
+    // Equivalent to writev(), but a closed peer returns EPIPE instead of raising SIGPIPE
+    msghdr message = {};
+    message.msg_iov = vectors;
+    message.msg_iovlen = static_cast<size_t>(count);
+    
+#ifdef MSG_NOSIGNAL
+    int flags = MSG_NOSIGNAL;
+#else
+    int flags = 0;
+#endif
+    
+    return static_cast<int>(sendmsg(m_handle, &message, flags));
+#endif
+}
+
 int Socket::Receive(void* buffer, int size)
 {
     if (!IsValid() || !buffer || size <= 0) {
@@ -217,6 +263,15 @@ bool Socket::IsValid() const
     return m_handle != INVALID_SOCKET_HANDLE;
 }
 
+bool Socket::WouldBlock()
+{
+#ifdef PLATFORM_WINDOWS
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
 SocketHandle Socket::GetHandle() const
 {
     return m_handle;
@@ -11,6 +11,7 @@
     #define INVALID_SOCKET_HANDLE INVALID_SOCKET
 #else
     #include <sys/socket.h>
+    #include <sys/uio.h>
     #include <netinet/in.h>
     #include <arpa/inet.h>
     #include <unistd.h>
@@ -23,6 +24,12 @@
 namespace CardGameLib {
 namespace Network {
 
+// One piece of a vectored (scatter/gather) send
+struct SendBuffer {
+    const char* data;
+    size_t size;
+};
+
 class Socket {
 public:
     Socket();
@@ -51,6 +58,12 @@ public:
     int Send(const void* data, int size);
     int Send(const std::string& data);
     
+    // Send several buffers with a single system call; returns total bytes sent
+    int SendVectored(const SendBuffer* buffers, int count);
+    
+    // Maximum number of buffers per SendVectored call
+    static constexpr int MAX_SEND_BUFFERS = 64;
+    
     // Receive data
     int Receive(void* buffer, int size);
     std::string ReceiveString(int maxLength = 4096);
@@ -65,6 +78,9 @@ public:
     // Socket state
     bool IsValid() const;
     
+    // True if the last failed Send/Receive/Accept would have blocked
+    static bool WouldBlock();
+    
     // Get socket info
     SocketHandle GetHandle() const;
     std::string GetLocalAddress() const;
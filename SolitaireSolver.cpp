@@ -0,0 +1,61 @@
+#include "games/solitaire/SolitaireSolver.h"
+
+namespace CardGameLib {
+namespace Games {
+namespace Solitaire {
+
+TranspositionTable::TranspositionTable(int capacityBits)
+    : m_slots(new std::atomic<uint64_t>[size_t(1) << capacityBits])
+    , m_mask((size_t(1) << capacityBits) - 1)
+    , m_generation(1)
+{
+    Clear();
+}
+
+void TranspositionTable::NewSearch()
+{
+    if (++m_generation > GENERATION_MASK) {
+        Clear();
+        m_generation = 1;
+    }
+}
+
+bool TranspositionTable::Insert(uint64_t hash)
+{
+    const uint64_t entry = (hash & ~GENERATION_MASK) | m_generation;
+    size_t index = static_cast<size_t>(hash >> 8) & m_mask;
+    
+    for (int probe = 0; probe < MAX_PROBES; ++probe) {
+        std::atomic<uint64_t>& slot = m_slots[(index + probe) & m_mask];
+        uint64_t current = slot.load(std::memory_order_relaxed);
+        
+        while ((current & GENERATION_MASK) != m_generation) {
+            // Empty or left over from an older search: claim it
+            if (slot.compare_exchange_weak(current, entry, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        
+        if (current == entry) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+size_t TranspositionTable::GetCapacity() const
+{
+    return m_mask + 1;
+}
+
+void TranspositionTable::Clear()
+{
+    for (size_t i = 0; i <= m_mask; ++i) {
+        m_slots[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace Solitaire
+} // namespace Games
+} // namespace CardGameLib
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "core/Rng.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace CardGameLib {
+namespace Games {
+namespace Solitaire {
+
+// Outcome of a solver search
+enum class SolveResult {
+    SOLVED,           // A winning line was found
+    UNSOLVABLE,       // The whole search space was explored without a win
+    BUDGET_EXHAUSTED  // The node or time budget ran out first
+};
+
+// Solvers store a card as one byte, its Core::Card::GetIndex (suit * 13 + rank - 1,
+// so the two red suits come first)
+inline int IndexRank(uint8_t card) { return card % 13 + 1; }
+inline int IndexSuit(uint8_t card) { return card / 13; }
+inline bool IndexIsRed(uint8_t card) { return card < 26; }
+
+// True if a card can be built on a tableau card (one rank lower, opposite colour)
+inline bool IndexBuildsOn(uint8_t card, uint8_t target)
+{
+    return IndexRank(card) + 1 == IndexRank(target) && IndexIsRed(card) != IndexIsRed(target);
+}
+
+// Foundations as the Klondike and FreeCell solvers track them: the cards on each
+// suit's foundation, and the game's foundation pile holding each suit (-1 until
+// its ace goes up)
+struct SuitFoundations {
+    static constexpr int SUITS = 4;
+    
+    uint8_t foundation[SUITS];
+    int8_t foundationSlot[SUITS];
+    
+    bool FitsFoundation(uint8_t card) const { return foundation[IndexSuit(card)] == IndexRank(card) - 1; }
+    
+    // A card nothing will ever need to be built on: both opposite-colour
+    // foundations already hold its tableau successors
+    bool IsSafeForFoundation(uint8_t card) const
+    {
+        int rank = IndexRank(card);
+        if (!FitsFoundation(card)) {
+            return false;
+        }
+        if (rank <= 2) {
+            return true;
+        }
+        int first = IndexIsRed(card) ? 2 : 0;
+        return foundation[first] >= rank - 1 && foundation[first + 1] >= rank - 1;
+    }
+    
+    bool IsWon() const
+    {
+        return foundation[0] == 13 && foundation[1] == 13 && foundation[2] == 13 && foundation[3] == 13;
+    }
+    
+    // Foundation pile a card goes to: its suit's pile, or the first unclaimed one
+    int GetFoundationSlot(uint8_t card) const
+    {
+        int suit = IndexSuit(card);
+        if (foundationSlot[suit] >= 0) {
+            return foundationSlot[suit];
+        }
+        for (int slot = 0; slot < SUITS; ++slot) {
+            if (std::find(foundationSlot, foundationSlot + SUITS, slot) == foundationSlot + SUITS) {
+                return slot;
+            }
+        }
+        return 0;
+    }
+    
+    void AddToFoundation(uint8_t card)
+    {
+        foundationSlot[IndexSuit(card)] = static_cast<int8_t>(GetFoundationSlot(card));
+        foundation[IndexSuit(card)]++;
+    }
+};
+
+// Fill a run of position hash keys from a generator
+inline void FillKeys(Core::Rng& rng, uint64_t* keys, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        keys[i] = rng.Next();
+    }
+}
+
+// A solver's table of position hash keys, built on first use
+template <typename Keys>
+const Keys& GetKeys()
+{
+    static const Keys keys;
+    return keys;
+}
+
+// Move data for a game move: the move type, then each argument that is not negative
+template <typename MoveType>
+std::string MoveData(MoveType type, int a = -1, int b = -1, int c = -1)
+{
+    std::string data = std::to_string(static_cast<int>(type));
+    for (int arg : { a, b, c }) {
+        if (arg >= 0) {
+            data += ' ';
+            data += std::to_string(arg);
+        }
+    }
+    return data;
+}
+
+// Set of position hashes visited by a solver search.
+//
+// Open addressing with linear probing over 64-bit atomic slots, so several threads
+// may insert into one table without locks. Each slot stores the hash with its low
+// byte replaced by a generation number; starting a new search bumps the generation,
+// which empties the table without touching memory (it is only cleared when the
+// generation wraps). A hash that finds no free slot within a few probes is reported
+// as new, so a full table costs repeated work rather than correctness.
+class TranspositionTable {
+public:
+    static constexpr int DEFAULT_CAPACITY_BITS = 19;
+    
+    explicit TranspositionTable(int capacityBits = DEFAULT_CAPACITY_BITS);
+    
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+    
+    // Forget every position (not safe while other threads insert)
+    void NewSearch();
+    
+    // Record a position. Returns false if it was already recorded in this search.
+    bool Insert(uint64_t hash);
+    
+    size_t GetCapacity() const;
+    
+private:
+    static constexpr int MAX_PROBES = 8;
+    static constexpr uint64_t GENERATION_MASK = 0xFF;
+    
+    std::unique_ptr<std::atomic<uint64_t>[]> m_slots;
+    size_t m_mask;
+    uint64_t m_generation;
+    
+    void Clear();
+};
+
+} // namespace Solitaire
+} // namespace Games
+} // namespace CardGameLib
@@ -6,11 +6,12 @@ namespace CardGameLib {
 namespace Games {
 namespace Solitaire {
 
-Spider::Spider(SpiderDifficulty difficulty)
+Spider::Spider(SpiderDifficulty difficulty, bool winnableDealsOnly)
     : Core::Game("Spider", Core::GameType::SOLITAIRE_SPIDER, 1)
     , m_completedSuits(0)
     , m_difficulty(difficulty)
 {
+    SetWinnableDealsOnly(winnableDealsOnly);
 }
 
 void Spider::Initialize()
@@ -24,8 +25,18 @@ bool Spider::Start()
         return false;
     }
     
+    // A deal number set since the last Reset takes effect now
+    if (m_dealNumberSet) {
+        Reset();
+    }
+    
     SetState(Core::GameState::STARTING);
-    DealInitialLayout();
+    
+    // After Deal (or a loaded position) the cards are already out
+    if (!IsLayoutDealt()) {
+        DealInitialLayout();
+    }
+    
     SetState(Core::GameState::IN_PROGRESS);
     return true;
 }
@@ -46,122 +57,163 @@ void Spider::Reset()
         pile.clear();
     }
     
-    // Reset completed suits counter
+    // Reset completed suits
+    m_foundation.clear();
     m_completedSuits = 0;
     
+    m_positionHash = ComputePositionHash();
+    
     SetState(Core::GameState::WAITING_FOR_PLAYERS);
 }
 
-bool Spider::IsValidMove(const std::string& moveData)
+void Spider::Deal(uint64_t dealNumber)
 {
-    std::istringstream ss(moveData);
-    std::string moveTypeStr;
-    ss >> moveTypeStr;
-    
-    try {
-        SpiderMoveType moveType = static_cast<SpiderMoveType>(std::stoi(moveTypeStr));
-        
-        switch (moveType) {
-            case SpiderMoveType::DEAL_CARDS:
-                // Can deal cards if there are cards in the stock and no empty tableau piles
-                return !m_stock.IsEmpty() && 
-                       std::none_of(m_tableau.begin(), m_tableau.end(),
-                                   [](const std::vector<Core::Card>& pile) { return pile.empty(); });
-                
-            case SpiderMoveType::TABLEAU_TO_TABLEAU: {
-                int sourceIndex, targetIndex, cardCount;
-                ss >> sourceIndex >> targetIndex >> cardCount;
-                
-                if (sourceIndex < 0 || sourceIndex >= 10 || 
-                    targetIndex < 0 || targetIndex >= 10 || 
-                    sourceIndex == targetIndex || 
-                    m_tableau[sourceIndex].empty() ||
-                    cardCount <= 0 || 
-                    cardCount > static_cast<int>(m_tableau[sourceIndex].size())) {
-                    return false;
-                }
-                
-                // Check if the specified cards form a valid sequence
-                size_t startIndex = m_tableau[sourceIndex].size() - cardCount;
-                if (!IsDescendingSequence(m_tableau[sourceIndex], startIndex, cardCount)) {
-                    return false;
-                }
-                
-                // Get the card we're trying to move
-                const Core::Card& card = m_tableau[sourceIndex][startIndex];
-                
-                // If target is empty, any card can be placed
-                if (m_tableau[targetIndex].empty()) {
-                    return true;
-                }
-                
-                // For non-empty targets, the top card of the target pile must be one rank higher
-                const Core::Card& targetCard = m_tableau[targetIndex].back();
-                return static_cast<int>(card.GetRank()) == static_cast<int>(targetCard.GetRank()) - 1;
-            }
-                
-            case SpiderMoveType::COLLECT_COMPLETED_SUIT:
-                // This move is automatically checked and performed by the game
+    SetDealNumber(dealNumber);
+    Reset();
+    DealInitialLayout();
+}
+
+bool Spider::IsValidMove(const Core::Move& move)
+{
+    switch (static_cast<SpiderMoveType>(move.type)) {
+        case SpiderMoveType::DEAL_CARDS:
+            // Can deal cards if there are cards in the stock and no empty tableau piles
+            return !m_stock.IsEmpty() && 
+                   std::none_of(m_tableau.begin(), m_tableau.end(),
+                               [](const std::vector<Core::Card>& pile) { return pile.empty(); });
+            
+        case SpiderMoveType::TABLEAU_TO_TABLEAU: {
+            int sourceIndex = move.args[0];
+            int targetIndex = move.args[1];
+            int cardCount = move.args[2];
+            
+            if (sourceIndex >= 10 || targetIndex >= 10 || 
+                sourceIndex == targetIndex || 
+                m_tableau[sourceIndex].empty() ||
+                cardCount <= 0 || 
+                cardCount > static_cast<int>(m_tableau[sourceIndex].size())) {
                 return false;
-                
-            default:
+            }
+            
+            // Check if the specified cards form a valid sequence
+            size_t startIndex = m_tableau[sourceIndex].size() - cardCount;
+            if (!IsDescendingSequence(m_tableau[sourceIndex], startIndex, cardCount)) {
                 return false;
+            }
+            
+            // Get the card we're trying to move
+            const Core::Card& card = m_tableau[sourceIndex][startIndex];
+            
+            // If target is empty, any card can be placed
+            if (m_tableau[targetIndex].empty()) {
+                return true;
+            }
+            
+            // For non-empty targets, the top card of the target pile must be one rank higher
+            const Core::Card& targetCard = m_tableau[targetIndex].back();
+            return static_cast<int>(card.GetRank()) == static_cast<int>(targetCard.GetRank()) - 1;
         }
-    } catch (const std::exception&) {
-        return false;
+            
+        case SpiderMoveType::COLLECT_COMPLETED_SUIT:
+            // This move is automatically checked and performed by the game
+            return false;
+            
+        default:
+            return false;
     }
-    
-    return false;
 }
 
-bool Spider::MakeMove(int playerId, const std::string& moveData)
+bool Spider::MakeMove(int playerId, const Core::Move& move)
 {
     // Only the current player can make moves
     if (m_players.empty() || m_players[0]->GetId() != playerId) {
         return false;
     }
     
-    if (!IsValidMove(moveData)) {
+    if (!IsValidMove(move)) {
         return false;
     }
     
-    std::istringstream ss(moveData);
-    std::string moveTypeStr;
-    ss >> moveTypeStr;
+    // Journal the move's pile operations for undo
+    m_journal.BeginMove();
+    
+    switch (static_cast<SpiderMoveType>(move.type)) {
+        case SpiderMoveType::DEAL_CARDS:
+            return DealCards();
+            
+        case SpiderMoveType::TABLEAU_TO_TABLEAU: {
+            bool moveResult = MoveTableauToTableau(move.args[0], move.args[1], move.args[2]);
+            
+            // After a successful move, check for completed suits
+            if (moveResult) {
+                CheckAndRemoveCompletedSuits();
+            }
+            
+            return moveResult;
+        }
+            
+        case SpiderMoveType::COLLECT_COMPLETED_SUIT:
+            // This should be handled automatically
+            return false;
+            
+        default:
+            return false;
+    }
+}
+
+void Spider::GenerateMoves(Core::MoveList& moves) const
+{
+    moves.Clear();
+    
+    bool hasEmptyPile = false;
     
-    try {
-        SpiderMoveType moveType = static_cast<SpiderMoveType>(std::stoi(moveTypeStr));
+    for (int sourceIndex = 0; sourceIndex < 10; ++sourceIndex) {
+        const std::vector<Core::Card>& source = m_tableau[sourceIndex];
+        if (source.empty()) {
+            hasEmptyPile = true;
+            continue;
+        }
+        if (!source.back().IsFaceUp()) {
+            continue;
+        }
         
-        switch (moveType) {
-            case SpiderMoveType::DEAL_CARDS:
-                return DealCards();
-                
-            case SpiderMoveType::TABLEAU_TO_TABLEAU: {
-                int sourceIndex, targetIndex, cardCount;
-                ss >> sourceIndex >> targetIndex >> cardCount;
-                
-                bool moveResult = MoveTableauToTableau(sourceIndex, targetIndex, cardCount);
-                
-                // After a successful move, check for completed suits
-                if (moveResult) {
-                    CheckAndRemoveCompletedSuits();
+        // Length of the face-up descending run on top (any suits)
+        int runLength = 1;
+        for (size_t i = source.size() - 1; i > 0; --i) {
+            const Core::Card& below = source[i - 1];
+            if (!below.IsFaceUp() ||
+                static_cast<int>(below.GetRank()) != static_cast<int>(source[i].GetRank()) + 1) {
+                break;
+            }
+            runLength++;
+        }
+        
+        // A non-empty target takes only the run card one rank below its top card;
+        // an empty one takes any part of the run
+        int topRank = static_cast<int>(source.back().GetRank());
+        for (int targetIndex = 0; targetIndex < 10; ++targetIndex) {
+            if (targetIndex == sourceIndex) {
+                continue;
+            }
+            
+            const std::vector<Core::Card>& target = m_tableau[targetIndex];
+            if (target.empty()) {
+                for (int cardCount = 1; cardCount <= runLength; ++cardCount) {
+                    moves.Add(Core::Move::Make(SpiderMoveType::TABLEAU_TO_TABLEAU, sourceIndex, targetIndex, cardCount));
                 }
-                
-                return moveResult;
+                continue;
+            }
+            
+            int cardCount = static_cast<int>(target.back().GetRank()) - topRank;
+            if (cardCount >= 1 && cardCount <= runLength) {
+                moves.Add(Core::Move::Make(SpiderMoveType::TABLEAU_TO_TABLEAU, sourceIndex, targetIndex, cardCount));
             }
-                
-            case SpiderMoveType::COLLECT_COMPLETED_SUIT:
-                // This should be handled automatically
-                return false;
-                
-            default:
-                return false;
         }
-    } catch (const std::exception&) {
-        return false;
     }
     
-    return false;
+    if (!m_stock.IsEmpty() && !hasEmptyPile) {
+        moves.Add(Core::Move::Make(SpiderMoveType::DEAL_CARDS));
+    }
 }
 
 std::string Spider::SerializeGameState() const
@@ -188,6 +240,14 @@ std::string Spider::SerializeGameState() const
         }
     }
     
+    // Serialize foundation
+    ss << "FOUNDATION " << m_foundation.size() << " ";
+    for (const auto& card : m_foundation) {
+        ss << static_cast<int>(card.GetSuit()) << " " 
+           << static_cast<int>(card.GetRank()) << " "
+           << (card.IsFaceUp() ? 1 : 0) << " ";
+    }
+    
     // Serialize game state
     ss << "GAME_STATE " << m_completedSuits << " " << static_cast<int>(m_difficulty);
     
@@ -237,6 +297,22 @@ bool Spider::DeserializeGameState(const std::string& data)
         }
     }
     
+    // Deserialize foundation
+    ss >> token;
+    if (token != "FOUNDATION") return false;
+    
+    size_t foundationSize;
+    ss >> foundationSize;
+    
+    for (size_t i = 0; i < foundationSize; ++i) {
+        int suit, rank, faceUp;
+        ss >> suit >> rank >> faceUp;
+        
+        Core::Card card(static_cast<Core::Suit>(suit), static_cast<Core::Rank>(rank));
+        if (faceUp) card.SetFaceUp(true);
+        m_foundation.push_back(card);
+    }
+    
     // Deserialize game state
     ss >> token;
     if (token != "GAME_STATE") return false;
@@ -247,6 +323,9 @@ bool Spider::DeserializeGameState(const std::string& data)
     m_completedSuits = completedSuits;
     m_difficulty = static_cast<SpiderDifficulty>(difficulty);
     
+    m_journal.Clear();
+    m_positionHash = ComputePositionHash();
+    
     // Set game state
     SetState(Core::GameState::IN_PROGRESS);
     
@@ -271,12 +350,9 @@ bool Spider::DealCards()
     }
     
     // Deal one card to each tableau pile
-    for (auto& pile : m_tableau) {
-        if (!m_stock.IsEmpty()) {
-            Core::Card card = m_stock.Draw();
-            card.SetFaceUp(true);
-            pile.push_back(card);
-        }
+    for (size_t i = 0; i < m_tableau.size() && !m_stock.IsEmpty(); ++i) {
+        ApplyPileOp(Core::MakePileOp(STOCK_PILE, FIRST_TABLEAU_PILE + static_cast<int>(i), 1,
+                                     Core::PILE_OP_FACE_UP));
     }
     
     // Check for completed suits after dealing
@@ -315,21 +391,10 @@ bool Spider::MoveTableauToTableau(int sourceIndex, int targetIndex, int cardCoun
     }
     
     // Move the cards
-    std::vector<Core::Card> cardsToMove;
-    cardsToMove.insert(cardsToMove.begin(), 
-                      m_tableau[sourceIndex].begin() + startIndex,
-                      m_tableau[sourceIndex].end());
-    
-    m_tableau[targetIndex].insert(m_tableau[targetIndex].end(),
-                                 cardsToMove.begin(), cardsToMove.end());
-    
-    m_tableau[sourceIndex].erase(m_tableau[sourceIndex].begin() + startIndex,
-                               m_tableau[sourceIndex].end());
+    ApplyPileOp(Core::MakePileOp(FIRST_TABLEAU_PILE + sourceIndex, FIRST_TABLEAU_PILE + targetIndex, cardCount));
     
     // Turn over the top card of the source pile if needed
-    if (!m_tableau[sourceIndex].empty() && !m_tableau[sourceIndex].back().IsFaceUp()) {
-        m_tableau[sourceIndex].back().SetFaceUp(true);
-    }
+    RevealTableauTop(sourceIndex);
     
     return true;
 }
@@ -339,34 +404,22 @@ bool Spider::CheckAndRemoveCompletedSuits()
     bool foundCompletedSuit = false;
     
     // Check each tableau pile for completed sequences (K-A of same suit)
-    for (auto& pile : m_tableau) {
-        if (pile.size() >= 13) {
-            // Check from the end of the pile backwards
-            size_t endPos = pile.size();
-            while (endPos >= 13) {
-                // Check if the 13 cards form a King-to-Ace sequence of the same suit
-                if (IsKingToAceSequenceSameSuit(std::vector<Core::Card>(
-                    pile.end() - 13, pile.end()))) {
-                    // Remove the 13 cards
-                    pile.erase(pile.end() - 13, pile.end());
-                    
-                    // Increment completed suits counter
-                    m_completedSuits++;
-                    foundCompletedSuit = true;
-                    
-                    // Turn over the top card of the pile if needed
-                    if (!pile.empty() && !pile.back().IsFaceUp()) {
-                        pile.back().SetFaceUp(true);
-                    }
-                    
-                    // Check for win condition
-                    if (IsGameWon()) {
-                        SetState(Core::GameState::GAME_OVER);
-                    }
-                } else {
-                    // Move to the next potential sequence
-                    endPos--;
-                }
+    for (size_t i = 0; i < m_tableau.size(); ++i) {
+        const std::vector<Core::Card>& pile = m_tableau[i];
+        
+        // Check if the top 13 cards form a King-to-Ace sequence of the same suit
+        while (pile.size() >= 13 &&
+               IsKingToAceSequenceSameSuit(&pile[pile.size() - 13], 13)) {
+            // Move the 13 cards to the foundation (updates the completed suits counter)
+            ApplyPileOp(Core::MakePileOp(FIRST_TABLEAU_PILE + static_cast<int>(i), FOUNDATION_PILE, 13));
+            foundCompletedSuit = true;
+            
+            // Turn over the top card of the pile if needed
+            RevealTableauTop(static_cast<int>(i));
+            
+            // Check for win condition
+            if (IsGameWon()) {
+                SetState(Core::GameState::GAME_OVER);
             }
         }
     }
@@ -382,6 +435,106 @@ void Spider::SetDifficulty(SpiderDifficulty difficulty)
     }
 }
 
+bool Spider::WriteSnapshotBody(Core::SnapshotWriter& writer) const
+{
+    writer.WriteUInt8(static_cast<uint8_t>(m_difficulty));
+    writer.WritePile(m_stock.GetCards());
+    
+    for (const auto& pile : m_tableau) {
+        writer.WritePile(pile);
+    }
+    
+    writer.WritePile(m_foundation);
+    return true;
+}
+
+bool Spider::ReadSnapshotBody(Core::SnapshotReader& reader)
+{
+    uint8_t difficulty = reader.ReadUInt8();
+    if (difficulty > static_cast<uint8_t>(SpiderDifficulty::FOUR_SUITS)) {
+        return false;
+    }
+    
+    m_difficulty = static_cast<SpiderDifficulty>(difficulty);
+    m_stock.Clear();
+    
+    bool ok = reader.ReadPile(m_stock.GetCards());
+    
+    for (auto& pile : m_tableau) {
+        pile.clear();
+        ok = ok && reader.ReadPile(pile);
+    }
+    
+    m_foundation.clear();
+    ok = ok && reader.ReadPile(m_foundation);
+    
+    m_completedSuits = static_cast<int>(m_foundation.size() / 13);
+    return ok;
+}
+
+bool Spider::SupportsDeltas() const
+{
+    return true;
+}
+
+bool Spider::ExecutePileOp(const Core::PileOp& op)
+{
+    std::vector<Core::Card>* source = GetPile(op.source);
+    std::vector<Core::Card>* target = GetPile(op.target);
+    
+    if (!source || !target || !TransferCards(*source, *target, op)) {
+        return false;
+    }
+    
+    m_completedSuits = static_cast<int>(m_foundation.size() / 13);
+    return true;
+}
+
+void Spider::OnDeltaApplied()
+{
+    // Check for win condition
+    if (IsGameWon()) {
+        SetState(Core::GameState::GAME_OVER);
+    }
+}
+
+uint64_t Spider::ComputePositionHash() const
+{
+    uint64_t hash = Core::ZobristPileHash(STOCK_PILE, m_stock.GetCards()) ^
+                    Core::ZobristPileHash(FOUNDATION_PILE, m_foundation);
+    
+    for (size_t i = 0; i < m_tableau.size(); ++i) {
+        hash ^= Core::ZobristPileHash(FIRST_TABLEAU_PILE + static_cast<int>(i), m_tableau[i]);
+    }
+    
+    return hash;
+}
+
+std::vector<Core::Card>* Spider::GetPile(int pileId)
+{
+    if (pileId == STOCK_PILE) {
+        return &m_stock.GetCards();
+    }
+    if (pileId >= FIRST_TABLEAU_PILE && pileId < FIRST_TABLEAU_PILE + static_cast<int>(m_tableau.size())) {
+        return &m_tableau[pileId - FIRST_TABLEAU_PILE];
+    }
+    if (pileId == FOUNDATION_PILE) {
+        return &m_foundation;
+    }
+    
+    return nullptr;
+}
+
+void Spider::RevealTableauTop(int tableauIndex)
+{
+    const std::vector<Core::Card>& pile = m_tableau[tableauIndex];
+    
+    if (!pile.empty() && !pile.back().IsFaceUp()) {
+        int pileId = FIRST_TABLEAU_PILE + tableauIndex;
+        ApplyPileOp(Core::MakePileOp(pileId, pileId, 1, Core::PILE_OP_FACE_UP));
+    }
+}
+
 bool Spider::IsGameWon() const
 {
     // Spider is won when all 8 suits are completed
@@ -408,6 +561,11 @@ SpiderDifficulty Spider::GetDifficulty() const
     return m_difficulty;
 }
 
+int Spider::GetDealVariant() const
+{
+    return static_cast<int>(m_difficulty);
+}
+
 bool Spider::IsValidTableauToTableauMove(const Core::Card& card, const std::vector<Core::Card>& targetPile) const
 {
     if (targetPile.empty()) {
@@ -423,16 +581,26 @@ bool Spider::IsValidTableauToTableauMove(const Core::Card& card, const std::vect
 }
 
 bool Spider::IsDescendingSequence(const std::vector<Core::Card>& cards, size_t startIndex, size_t count) const
+{
+    return count > 0 && IsDescendingSequence(&cards[startIndex], count);
+}
+
+bool Spider::IsSameSuitSequence(const std::vector<Core::Card>& cards, size_t startIndex, size_t count) const
+{
+    return count <= 1 || IsSameSuitSequence(&cards[startIndex], count);
+}
+
+bool Spider::IsDescendingSequence(const Core::Card* cards, size_t count)
 {
     // Check if all cards are face up
-    for (size_t i = startIndex; i < startIndex + count; ++i) {
+    for (size_t i = 0; i < count; ++i) {
         if (!cards[i].IsFaceUp()) {
             return false;
         }
     }
     
     // Check if the cards form a descending sequence
-    for (size_t i = startIndex; i < startIndex + count - 1; ++i) {
+    for (size_t i = 0; i + 1 < count; ++i) {
         if (static_cast<int>(cards[i].GetRank()) != static_cast<int>(cards[i+1].GetRank()) + 1) {
             return false;
         }
@@ -441,15 +609,15 @@ bool Spider::IsDescendingSequence(const std::vector<Core::Card>& cards, size_t s
     return true;
 }
 
-bool Spider::IsSameSuitSequence(const std::vector<Core::Card>& cards, size_t startIndex, size_t count) const
+bool Spider::IsSameSuitSequence(const Core::Card* cards, size_t count)
 {
     if (count <= 1) {
         return true;
     }
     
-    Core::Suit suit = cards[startIndex].GetSuit();
+    Core::Suit suit = cards[0].GetSuit();
     
-    for (size_t i = startIndex + 1; i < startIndex + count; ++i) {
+    for (size_t i = 1; i < count; ++i) {
         if (cards[i].GetSuit() != suit) {
             return false;
         }
@@ -458,18 +626,15 @@ bool Spider::IsSameSuitSequence(const std::vector<Core::Card>& cards, size_t sta
     return true;
 }
 
-bool Spider::IsKingToAceSequenceSameSuit(const std::vector<Core::Card>& cards) const
+bool Spider::IsKingToAceSequenceSameSuit(const Core::Card* cards, size_t count)
 {
-    if (cards.size() != 13) {
+    if (count != 13) {
         return false;
     }
     
     // Check if all cards are of the same suit
-    Core::Suit suit = cards[0].GetSuit();
-    for (const auto& card : cards) {
-        if (card.GetSuit() != suit) {
-            return false;
-        }
+    if (!IsSameSuitSequence(cards, count)) {
+        return false;
     }
     
     // Check if the sequence is King to Ace
@@ -486,6 +651,7 @@ void Spider::CreateSpiderDeck()
 {
     // Spider uses 2 decks (104 cards)
     std::vector<Core::Card> cards;
+    cards.reserve(104);
     
     switch (m_difficulty) {
         case SpiderDifficulty::ONE_SUIT:
@@ -519,12 +685,14 @@ void Spider::CreateSpiderDeck()
             break;
     }
     
-    m_stock = Core::Deck(cards);
-    m_stock.Shuffle();
+    m_stock = Core::Deck(cards, NextDealNumber());
 }
 
 void Spider::DealInitialLayout()
 {
+    // A new deal starts a fresh undo history
+    m_journal.Clear();
+    
     // First deal: 4 cards to each tableau pile
     for (int deal = 0; deal < 4; deal++) {
         for (auto& pile : m_tableau) {
@@ -542,6 +710,23 @@ void Spider::DealInitialLayout()
         card.SetFaceUp(true);
         m_tableau[i].push_back(card);
     }
+    
+    m_positionHash = ComputePositionHash();
+}
+
+bool Spider::IsLayoutDealt() const
+{
+    if (m_completedSuits > 0) {
+        return true;
+    }
+    
+    for (const auto& pile : m_tableau) {
+        if (!pile.empty()) {
+            return true;
+        }
+    }
+    
+    return false;
 }
 
 } // namespace Solitaire
@@ -26,8 +26,9 @@ enum class SpiderMoveType {
 
 class Spider : public Core::Game {
 public:
-    // Constructor, default to ONE_SUIT difficulty
-    Spider(SpiderDifficulty difficulty = SpiderDifficulty::ONE_SUIT);
+    // Constructor, default to ONE_SUIT difficulty. With winnableDealsOnly, random
+    // deals come from the default DealIndex (indexed by difficulty).
+    Spider(SpiderDifficulty difficulty = SpiderDifficulty::ONE_SUIT, bool winnableDealsOnly = false);
     
     // Game setup
     virtual void Initialize() override;
@@ -36,12 +37,25 @@ public:
     virtual void Reset() override;
     
     // Game moves
-    virtual bool IsValidMove(const std::string& moveData) override;
-    virtual bool MakeMove(int playerId, const std::string& moveData) override;
+    using Core::Game::IsValidMove;
+    using Core::Game::MakeMove;
+    virtual bool IsValidMove(const Core::Move& move) override;
+    virtual bool MakeMove(int playerId, const Core::Move& move) override;
+    virtual void GenerateMoves(Core::MoveList& moves) const override;
     
     // Game state serialization
     virtual std::string SerializeGameState() const override;
     virtual bool DeserializeGameState(const std::string& data) override;
+    virtual bool SupportsDeltas() const override;
+    
+    // Pile ids used in game deltas
+    static constexpr int STOCK_PILE = 0;
+    static constexpr int FIRST_TABLEAU_PILE = 1;
+    static constexpr int FOUNDATION_PILE = 11;
+    
+    // Set up the numbered deal: shuffle a fresh deck and lay out the tableau (Start
+    // then plays this layout)
+    void Deal(uint64_t dealNumber);
     
     // Spider-specific methods
     bool DealCards();
@@ -58,20 +72,40 @@ public:
     int GetCompletedSuits() const;
     SpiderDifficulty GetDifficulty() const;
     
+    // Sequence rules, on count cards listed bottom to top (shared with SpiderSolver)
+    static bool IsDescendingSequence(const Core::Card* cards, size_t count);
+    static bool IsSameSuitSequence(const Core::Card* cards, size_t count);
+    static bool IsKingToAceSequenceSameSuit(const Core::Card* cards, size_t count);
+    
 private:
     // Game components
     Core::Deck m_stock;                       // Stock/draw pile
     std::array<std::vector<Core::Card>, 10> m_tableau; // 10 tableau piles
+    std::vector<Core::Card> m_foundation;     // Cards of the completed suits
     int m_completedSuits;                     // Counter for completed suits (0-8)
     SpiderDifficulty m_difficulty;            // Game difficulty
     
+    // Binary snapshot: difficulty, stock, tableau, foundation
+    virtual bool WriteSnapshotBody(Core::SnapshotWriter& writer) const override;
+    virtual bool ReadSnapshotBody(Core::SnapshotReader& reader) override;
+    
+    // Deals are indexed by difficulty
+    virtual int GetDealVariant() const override;
+    
+    // Delta sync
+    virtual bool ExecutePileOp(const Core::PileOp& op) override;
+    virtual void OnDeltaApplied() override;
+    virtual uint64_t ComputePositionHash() const override;
+    std::vector<Core::Card>* GetPile(int pileId);
+    void RevealTableauTop(int tableauIndex);
+    
     // Helper methods
     bool IsValidTableauToTableauMove(const Core::Card& card, const std::vector<Core::Card>& targetPile) const;
     bool IsDescendingSequence(const std::vector<Core::Card>& cards, size_t startIndex, size_t count) const;
     bool IsSameSuitSequence(const std::vector<Core::Card>& cards, size_t startIndex, size_t count) const;
-    bool IsKingToAceSequenceSameSuit(const std::vector<Core::Card>& cards) const;
     void CreateSpiderDeck();
     void DealInitialLayout();
+    bool IsLayoutDealt() const;
 };
 
 } // namespace Solitaire
@@ -0,0 +1,650 @@
+#include "games/solitaire/SpiderSolver.h"
+#include "core/Rng.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace CardGameLib {
+namespace Games {
+namespace Solitaire {
+
+namespace {
+    const int PILES = 10;
+    const int CARDS = 104;
+    const int FACES = 52;
+    const int SUIT_LENGTH = 13;
+    const int SUITS_TO_COMPLETE = 8;
+    const int MAX_MOVES = 160;
+    const size_t FIRST_DEPTH_LIMIT = 300;  // Typical winning lines fit the first pass
+    const size_t MAX_DEPTH = 1200;        // Bounds the recursion
+    const size_t SPLIT_DEPTH = 12;        // Nodes this close to the root may be shared
+    const size_t CHECK_INTERVAL = 1024;   // Nodes between budget checks
+    
+    // A move packed into two bytes: source, target and card count in nibbles
+    const uint16_t DEAL_MOVE = 0xFFFF;
+    
+    uint16_t PackMove(int source, int target, int count)
+    {
+        return static_cast<uint16_t>(source | (target << 4) | (count << 8));
+    }
+    
+    int MoveSource(uint16_t move) { return move & 0x0F; }
+    int MoveTarget(uint16_t move) { return (move >> 4) & 0x0F; }
+    int MoveCount(uint16_t move) { return move >> 8; }
+    
+    std::string UnpackMove(uint16_t move)
+    {
+        if (move == DEAL_MOVE) {
+            return MoveData(SpiderMoveType::DEAL_CARDS);
+        }
+        return MoveData(SpiderMoveType::TABLEAU_TO_TABLEAU, MoveSource(move), MoveTarget(move), MoveCount(move));
+    }
+    
+    // Random keys for the position hash
+    struct ZobristKeys {
+        uint64_t card[2 * FACES][CARDS];   // Face-down or face-up card at a depth in a pile
+        uint64_t stock[CARDS + 1];         // Cards left to deal
+        
+        ZobristKeys()
+        {
+            Core::Rng rng(0x5350494445525331ULL);
+            FillKeys(rng, &card[0][0], 2 * FACES * CARDS);
+            FillKeys(rng, stock, CARDS + 1);
+        }
+    };
+    
+    // Compact Spider position. The stock order never changes, so only its size is
+    // kept here.
+    struct Position {
+        Core::Card cards[CARDS];  // The piles back to back, each bottom to top
+        uint8_t end[PILES];       // Pile p is cards[Start(p)] up to cards[end[p]]
+        uint8_t stockSize;
+        uint8_t completed;
+        
+        int Start(int pile) const { return pile == 0 ? 0 : end[pile - 1]; }
+        int Size(int pile) const { return end[pile] - Start(pile); }
+        const Core::Card* Pile(int pile) const { return cards + Start(pile); }
+        Core::Card Top(int pile) const { return cards[end[pile] - 1]; }
+        
+        bool IsWon() const { return completed == SUITS_TO_COMPLETE; }
+        
+        uint64_t GetHash() const
+        {
+            // Summing the pile hashes makes the hash independent of the pile order
+            const ZobristKeys& keys = GetKeys<ZobristKeys>();
+            uint64_t hash = keys.stock[stockSize];
+            for (int pile = 0; pile < PILES; ++pile) {
+                uint64_t pileHash = 0;
+                const Core::Card* cards = Pile(pile);
+                for (int i = 0, size = Size(pile); i < size; ++i) {
+                    pileHash ^= keys.card[cards[i].GetIndex() + (cards[i].IsFaceUp() ? FACES : 0)][i];
+                }
+                hash += pileHash;
+            }
+            return hash;
+        }
+        
+        // Cards at the top of a pile that Spider lets move together
+        int RunLength(int pile) const
+        {
+            int size = Size(pile);
+            const Core::Card* cards = Pile(pile);
+            if (size == 0 || !cards[size - 1].IsFaceUp()) {
+                return 0;
+            }
+            
+            int run = 1;
+            while (run < size && Spider::IsDescendingSequence(cards + size - run - 1, run + 1)) {
+                ++run;
+            }
+            return run;
+        }
+        
+        void MoveCards(int source, int target, int count)
+        {
+            Core::Card moving[SUIT_LENGTH];
+            std::memcpy(moving, cards + end[source] - count, count);
+            
+            if (source < target) {
+                std::memmove(cards + end[source] - count, cards + end[source], end[target] - end[source]);
+                for (int pile = source; pile < target; ++pile) {
+                    end[pile] = static_cast<uint8_t>(end[pile] - count);
+                }
+                std::memcpy(cards + end[target] - count, moving, count);
+            } else {
+                std::memmove(cards + end[target] + count, cards + end[target], end[source] - count - end[target]);
+                std::memcpy(cards + end[target], moving, count);
+                for (int pile = target; pile < source; ++pile) {
+                    end[pile] = static_cast<uint8_t>(end[pile] + count);
+                }
+            }
+            
+            Reveal(source);
+            CollectCompletedSuits();
+        }
+        
+        // One card from the stock to each pile
+        void DealRow(const Core::Card* stock)
+        {
+            // From the last pile down, so every pile moves up into space already free
+            for (int pile = PILES - 1; pile >= 0; --pile) {
+                int start = Start(pile);
+                std::memmove(cards + start + pile, cards + start, end[pile] - start);
+                end[pile] = static_cast<uint8_t>(end[pile] + pile + 1);
+                
+                Core::Card card = stock[stockSize - 1 - pile];
+                card.SetFaceUp(true);
+                cards[end[pile] - 1] = card;
+            }
+            stockSize = static_cast<uint8_t>(stockSize - PILES);
+            
+            CollectCompletedSuits();
+        }
+        
+        void Reveal(int pile)
+        {
+            if (Size(pile) > 0 && !Top(pile).IsFaceUp()) {
+                cards[end[pile] - 1].SetFaceUp(true);
+            }
+        }
+        
+        // Remove every King to Ace run of one suit, as Spider does after each move
+        void CollectCompletedSuits()
+        {
+            for (int pile = 0; pile < PILES; ++pile) {
+                CollectCompletedSuit(pile);
+            }
+        }
+        
+        void CollectCompletedSuit(int pile)
+        {
+            while (Size(pile) >= SUIT_LENGTH &&
+                   Spider::IsKingToAceSequenceSameSuit(cards + end[pile] - SUIT_LENGTH, SUIT_LENGTH)) {
+                int total = end[PILES - 1];
+                std::memmove(cards + end[pile] - SUIT_LENGTH, cards + end[pile], total - end[pile]);
+                for (int other = pile; other < PILES; ++other) {
+                    end[other] = static_cast<uint8_t>(end[other] - SUIT_LENGTH);
+                }
+                completed++;
+                Reveal(pile);
+            }
+        }
+    };
+    
+    Position MakePosition(const Spider& game)
+    {
+        Position position;
+        int total = 0;
+        
+        const auto& tableau = game.GetTableau();
+        for (int pile = 0; pile < PILES; ++pile) {
+            for (const Core::Card& card : tableau[pile]) {
+                if (total < CARDS) {
+                    position.cards[total++] = card;
+                }
+            }
+            position.end[pile] = static_cast<uint8_t>(total);
+        }
+        
+        position.stockSize = static_cast<uint8_t>(std::min<size_t>(game.GetStock().Size(), CARDS - total));
+        position.completed = static_cast<uint8_t>(game.GetCompletedSuits());
+        return position;
+    }
+    
+    struct Candidate {
+        uint16_t move;
+        int score;
+    };
+    
+    // Candidate moves, most promising first: those turning a card, then emptying a
+    // pile, then joining a card of the same suit, then the rest; dealing comes last
+    int GenerateMoves(const Position& position, Candidate* moves)
+    {
+        int moveCount = 0;
+        auto add = [&](uint16_t move, int score) {
+            if (moveCount < MAX_MOVES) {
+                moves[moveCount++] = Candidate{ move, score };
+            }
+        };
+        
+        int emptyPile = -1;
+        for (int pile = 0; pile < PILES; ++pile) {
+            if (position.Size(pile) == 0) {
+                emptyPile = pile;
+                break;
+            }
+        }
+        
+        for (int source = 0; source < PILES; ++source) {
+            int size = position.Size(source);
+            int run = position.RunLength(source);
+            const Core::Card* cards = position.Pile(source);
+            
+            for (int count = 1; count <= run; ++count) {
+                int base = size - count;
+                Core::Card card = cards[base];
+                bool whole = count == run;
+                
+                // Never split a run of one suit
+                if (!whole && Spider::IsSameSuitSequence(cards + base - 1, 2)) {
+                    continue;
+                }
+                
+                bool turns = whole && base > 0 && !cards[base - 1].IsFaceUp();
+                bool empties = base == 0;
+                int score = (turns ? 1000 : empties ? 500 : 0) + count;
+                
+                for (int target = 0; target < PILES; ++target) {
+                    if (target == source || position.Size(target) == 0) {
+                        continue;
+                    }
+                    
+                    Core::Card top = position.Top(target);
+                    if (static_cast<int>(top.GetRank()) != static_cast<int>(card.GetRank()) + 1) {
+                        continue;
+                    }
+                    
+                    // Part of a run only moves to start a longer run of one suit
+                    bool suited = top.GetSuit() == card.GetSuit();
+                    if (whole || suited) {
+                        add(PackMove(source, target, count), score + (suited ? 200 : 0));
+                    }
+                }
+                
+                // Moving a whole pile to an empty one changes nothing
+                if (emptyPile >= 0 && !empties) {
+                    add(PackMove(source, emptyPile, count), score - 300);
+                }
+            }
+        }
+        
+        // Spider only deals onto ten non-empty piles
+        if (emptyPile < 0 && position.stockSize >= PILES) {
+            add(DEAL_MOVE, -1000);
+        }
+        
+        std::stable_sort(moves, moves + moveCount, [](const Candidate& a, const Candidate& b) {
+            return a.score > b.score;
+        });
+        return moveCount;
+    }
+    
+    // A subtree waiting for a thread, with the line that reaches it
+    struct Task {
+        Position position;
+        std::vector<uint16_t> line;
+    };
+    
+    // Iterative deepening search shared by several threads
+    class Search {
+    public:
+        Search(TranspositionTable& table, const std::vector<Core::Card>& stock,
+               std::chrono::steady_clock::time_point deadline, size_t nodeBudget, size_t threadCount)
+            : m_table(table)
+            , m_stock(stock)
+            , m_deadline(deadline)
+            , m_nodeBudget(nodeBudget)
+            , m_nodesChecked(0)
+            , m_depthLimit(0)
+            , m_stop(false)
+            , m_outOfBudget(false)
+            , m_cutoff(false)
+            , m_pending(0)
+            , m_queued(0)
+            , m_idle(0)
+            , m_solved(false)
+        {
+            for (size_t i = 0; i < threadCount; ++i) {
+                m_workers.emplace_back(new Worker());
+            }
+        }
+        
+        SolveResult Run(const Position& root)
+        {
+            for (size_t limit = FIRST_DEPTH_LIMIT; ; limit = std::min(limit * 2, MAX_DEPTH)) {
+                m_table.NewSearch();
+                m_depthLimit = limit;
+                m_cutoff = false;
+                
+                RunPass(root);
+                
+                if (m_solved) {
+                    return SolveResult::SOLVED;
+                }
+                if (m_outOfBudget) {
+                    return SolveResult::BUDGET_EXHAUSTED;
+                }
+                if (!m_cutoff) {
+                    // Nothing was cut short, so no deeper pass can do better
+                    return SolveResult::UNSOLVABLE;
+                }
+                if (limit == MAX_DEPTH) {
+                    return SolveResult::BUDGET_EXHAUSTED;
+                }
+            }
+        }
+        
+        const std::vector<uint16_t>& GetLine() const { return m_line; }
+        
+        size_t GetNodes() const
+        {
+            size_t nodes = 0;
+            for (const auto& worker : m_workers) {
+                nodes += worker->nodes;
+            }
+            return nodes;
+        }
+    
+    private:
+        // Move list and child position of a ply. They are kept off the stack, so a
+        // deep line costs only a small call frame per ply; a deque never moves the
+        // frames of the plies still being searched as it grows.
+        struct Frame {
+            Candidate moves[MAX_MOVES];
+            Position child;
+        };
+        
+        // A thread's queue of shared subtrees. The owner takes the newest, which
+        // its own search would have reached next; thieves take the oldest, which
+        // is nearest the root and so the largest.
+        struct Worker {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+            std::deque<Frame> frames;  // Indexed by depth below the task being searched
+            size_t nodes = 0;
+        };
+        
+        TranspositionTable& m_table;
+        std::vector<Core::Card> m_stock;
+        std::chrono::steady_clock::time_point m_deadline;
+        size_t m_nodeBudget;
+        std::atomic<size_t> m_nodesChecked;  // Nodes of all threads, counted at each budget check
+        size_t m_depthLimit;
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::atomic<bool> m_stop;
+        std::atomic<bool> m_outOfBudget;
+        std::atomic<bool> m_cutoff;
+        std::atomic<int> m_pending;  // Tasks queued or being searched
+        std::atomic<int> m_queued;   // Tasks queued and not yet taken
+        std::atomic<int> m_idle;     // Threads waiting for a task
+        std::mutex m_waitMutex;
+        std::condition_variable m_wake;  // A task was queued, the pass ran out of work or stopped
+        std::mutex m_lineMutex;
+        bool m_solved;
+        std::vector<uint16_t> m_line;
+        
+        void RunPass(const Position& root)
+        {
+            m_workers[0]->tasks.push_back(Task{ root, {} });
+            m_pending = 1;
+            m_queued = 1;
+            
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < m_workers.size(); ++i) {
+                threads.emplace_back(&Search::Work, this, i);
+            }
+            Work(0);
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            
+            // Left over when the pass stopped early
+            for (auto& worker : m_workers) {
+                worker->tasks.clear();
+            }
+            m_queued = 0;
+        }
+        
+        void Work(size_t id)
+        {
+            Worker& worker = *m_workers[id];
+            Task task;
+            
+            while (!m_stop) {
+                if (TakeTask(id, task)) {
+                    Solve(worker, task.position, task.line, 0);
+                    if (--m_pending == 0) {
+                        Wake();
+                    }
+                    continue;
+                }
+                
+                // Sleep until there is something to take or nothing left to do
+                m_idle++;
+                {
+                    std::unique_lock<std::mutex> lock(m_waitMutex);
+                    m_wake.wait(lock, [this] { return m_stop || m_pending == 0 || m_queued > 0; });
+                }
+                m_idle--;
+                
+                if (m_pending == 0) {
+                    break;
+                }
+            }
+        }
+        
+        // Called after changing what Work waits on. Taking the mutex orders the change
+        // against a waiter between checking it and going to sleep.
+        void Wake()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_waitMutex);
+            }
+            m_wake.notify_all();
+        }
+        
+        void Stop()
+        {
+            m_stop = true;
+            Wake();
+        }
+        
+        // The newest of this thread's tasks, or else the oldest of another's
+        bool TakeTask(size_t id, Task& task)
+        {
+            {
+                Worker& own = *m_workers[id];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    m_queued--;
+                    return true;
+                }
+            }
+            
+            for (size_t i = 1; i < m_workers.size(); ++i) {
+                Worker& victim = *m_workers[(id + i) % m_workers.size()];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    m_queued--;
+                    return true;
+                }
+            }
+            
+            return false;
+        }
+        
+        // Queue moves of a node for idle threads, the first to be taken last
+        void Share(Worker& worker, const Position& position, const std::vector<uint16_t>& line,
+                   const Candidate* moves, int count)
+        {
+            {
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                for (int i = count - 1; i >= 0; --i) {
+                    Task task{ position, line };
+                    Apply(task.position, moves[i].move);
+                    task.line.push_back(moves[i].move);
+                    worker.tasks.push_back(std::move(task));
+                    m_pending++;
+                    m_queued++;
+                }
+            }
+            Wake();
+        }
+        
+        // Called by each thread every CHECK_INTERVAL nodes
+        bool IsOutOfBudget()
+        {
+            if (m_nodeBudget > 0 && (m_nodesChecked += CHECK_INTERVAL) >= m_nodeBudget) {
+                return true;
+            }
+            return std::chrono::steady_clock::now() >= m_deadline;
+        }
+        
+        void Apply(Position& position, uint16_t move) const
+        {
+            if (move == DEAL_MOVE) {
+                position.DealRow(m_stock.data());
+            } else {
+                position.MoveCards(MoveSource(move), MoveTarget(move), MoveCount(move));
+            }
+        }
+        
+        bool Solve(Worker& worker, const Position& position, std::vector<uint16_t>& line, size_t depth)
+        {
+            if (m_stop.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            if (++worker.nodes % CHECK_INTERVAL == 0 && IsOutOfBudget()) {
+                m_outOfBudget = true;
+                Stop();
+                return false;
+            }
+            
+            if (position.IsWon()) {
+                std::lock_guard<std::mutex> lock(m_lineMutex);
+                if (!m_solved) {
+                    m_solved = true;
+                    m_line = line;
+                }
+                Stop();
+                return true;
+            }
+            
+            if (line.size() >= m_depthLimit) {
+                m_cutoff.store(true, std::memory_order_relaxed);
+                return false;
+            }
+            
+            if (!m_table.Insert(position.GetHash())) {
+                return false;
+            }
+            
+            if (depth == worker.frames.size()) {
+                worker.frames.emplace_back();
+            }
+            Frame& frame = worker.frames[depth];
+            int moveCount = GenerateMoves(position, frame.moves);
+            
+            for (int i = 0; i < moveCount; ++i) {
+                // Hand the rest of a shallow node to any idle thread
+                if (i + 1 < moveCount && line.size() < SPLIT_DEPTH && m_idle.load(std::memory_order_relaxed) > 0) {
+                    Share(worker, position, line, frame.moves + i + 1, moveCount - i - 1);
+                    moveCount = i + 1;
+                }
+                
+                frame.child = position;
+                Apply(frame.child, frame.moves[i].move);
+                line.push_back(frame.moves[i].move);
+                
+                if (Solve(worker, frame.child, line, depth + 1)) {
+                    return true;
+                }
+                
+                line.pop_back();
+            }
+            
+            return false;
+        }
+    };
+}
+
+SpiderSolver::SpiderSolver(std::chrono::milliseconds timeBudget, int threadCount, size_t nodeBudget)
+    : m_table(TABLE_CAPACITY_BITS)
+    , m_timeBudget(timeBudget)
+    , m_nodeBudget(nodeBudget)
+    , m_threadCount(threadCount)
+    , m_nodesSearched(0)
+{
+}
+
+SolveResult SpiderSolver::Solve(const Spider& game)
+{
+    m_solution.clear();
+    
+    size_t threads = m_threadCount > 0 ? static_cast<size_t>(m_threadCount)
+                                       : std::max(1u, std::thread::hardware_concurrency());
+    
+    Position root = MakePosition(game);
+    auto deadline = m_timeBudget.count() > 0 ? std::chrono::steady_clock::now() + m_timeBudget
+                                             : std::chrono::steady_clock::time_point::max();
+    Search search(m_table, game.GetStock().GetCards(), deadline, m_nodeBudget, threads);
+    SolveResult result = search.Run(root);
+    m_nodesSearched = search.GetNodes();
+    
+    if (result == SolveResult::SOLVED) {
+        for (uint16_t move : search.GetLine()) {
+            m_solution.push_back(UnpackMove(move));
+        }
+    }
+    
+    return result;
+}
+
+SolveResult SpiderSolver::SolveDeal(uint64_t dealNumber, SpiderDifficulty difficulty)
+{
+    Spider game(difficulty);
+    game.Deal(dealNumber);
+    return Solve(game);
+}
+
+const std::vector<std::string>& SpiderSolver::GetSolution() const
+{
+    return m_solution;
+}
+
+size_t SpiderSolver::GetNodesSearched() const
+{
+    return m_nodesSearched;
+}
+
+std::chrono::milliseconds SpiderSolver::GetTimeBudget() const
+{
+    return m_timeBudget;
+}
+
+void SpiderSolver::SetTimeBudget(std::chrono::milliseconds timeBudget)
+{
+    m_timeBudget = timeBudget;
+}
+
+size_t SpiderSolver::GetNodeBudget() const
+{
+    return m_nodeBudget;
+}
+
+void SpiderSolver::SetNodeBudget(size_t nodeBudget)
+{
+    m_nodeBudget = nodeBudget;
+}
+
+int SpiderSolver::GetThreadCount() const
+{
+    return m_threadCount;
+}
+
+void SpiderSolver::SetThreadCount(int threadCount)
+{
+    m_threadCount = threadCount;
+}
+
+} // namespace Solitaire
+} // namespace Games
+} // namespace CardGameLib
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "games/solitaire/Spider.h"
+#include "games/solitaire/SolitaireSolver.h"
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace CardGameLib {
+namespace Games {
+namespace Solitaire {
+
+// Solver for Spider (one, two or four suits).
+//
+// A depth-first search with iterative deepening over compact positions: the ten
+// piles sit back to back in one array of cards and the stock is the number of
+// cards left to deal. Runs are found with Spider's own sequence rules, and moves
+// are limited to ones that turn a card, empty a pile, or join a run to a card of
+// its own suit without splitting a same-suit run. Each depth-limited pass is
+// shared by several threads: a thread that reaches a shallow node while another
+// is idle queues the node's remaining moves, and idle threads steal the oldest
+// queued subtree. All threads record positions in one lock-free transposition
+// table. The line to each queued subtree is kept as compressed two-byte moves.
+//
+// UNSOLVABLE is relative to that pruning, and is only reported when a pass
+// finished without reaching its depth limit. A search stops with BUDGET_EXHAUSTED
+// when either its time or its node budget runs out; a zero budget is no limit.
+// Budgets are checked every thousand or so nodes, and only a node budget on one
+// thread gives the same result on every machine.
+class SpiderSolver {
+public:
+    static constexpr int DEFAULT_TIME_BUDGET_MS = 2000;
+    static constexpr int TABLE_CAPACITY_BITS = 21;
+    
+    // Node budget for checking many deals on one thread each, with no time budget
+    static constexpr size_t BULK_NODE_BUDGET = 500000;
+    
+    explicit SpiderSolver(std::chrono::milliseconds timeBudget = std::chrono::milliseconds(DEFAULT_TIME_BUDGET_MS),
+                          int threadCount = 0, size_t nodeBudget = 0);
+    
+    // Solve a position (the solver sees the face-down cards and the stock order)
+    SolveResult Solve(const Spider& game);
+    
+    // Solve a numbered deal from its opening layout
+    SolveResult SolveDeal(uint64_t dealNumber, SpiderDifficulty difficulty = SpiderDifficulty::ONE_SUIT);
+    
+    // Winning line of the last solved position, as Spider move data (MakeMove input).
+    // The first move is a hint for the position.
+    const std::vector<std::string>& GetSolution() const;
+    
+    // Positions searched by the last call, over all threads and passes
+    size_t GetNodesSearched() const;
+    
+    std::chrono::milliseconds GetTimeBudget() const;
+    void SetTimeBudget(std::chrono::milliseconds timeBudget);
+    
+    // Most positions searched per call, over all threads and passes
+    size_t GetNodeBudget() const;
+    void SetNodeBudget(size_t nodeBudget);
+    
+    // Threads used per search (0 picks the hardware count)
+    int GetThreadCount() const;
+    void SetThreadCount(int threadCount);
+    
+private:
+    TranspositionTable m_table;
+    std::chrono::milliseconds m_timeBudget;
+    size_t m_nodeBudget;
+    int m_threadCount;
+    size_t m_nodesSearched;
+    std::vector<std::string> m_solution;
+};
+
+} // namespace Solitaire
+} // namespace Games
+} // namespace CardGameLib
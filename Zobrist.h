@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "core/Card.h"
+
+namespace CardGameLib {
+namespace Core {
+
+// Zobrist position hashing for pile-based games.
+//
+// A layout hashes to the XOR of one 64-bit key per card, picked by the card's
+// packed code (face and face-up flag), its pile id and its depth in the pile. A
+// pile operation changes only the keys of the cards it moves or turns, so the hash
+// is kept up to date in O(cards moved). Keys come from a splitmix64 finalizer over
+// those coordinates rather than a random table, so every build and platform agrees
+// on them and hashes can be compared across the network.
+inline uint64_t ZobristKey(int pileId, size_t depth, const Card& card)
+{
+    uint64_t x = (static_cast<uint64_t>(pileId) << 24) | (static_cast<uint64_t>(depth) << 8) | card.GetCode();
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Hash of a whole pile, for computing a layout's hash from scratch
+inline uint64_t ZobristPileHash(int pileId, const std::vector<Card>& cards)
+{
+    uint64_t hash = 0;
+    for (size_t i = 0; i < cards.size(); ++i) {
+        hash ^= ZobristKey(pileId, i, cards[i]);
+    }
+    return hash;
+}
+
+} // namespace Core
+} // namespace CardGameLib
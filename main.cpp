@@ -5,16 +5,31 @@
 #include "input/InputManager.h"
 #include "input/DragDropManager.h"
 #include "games/blackjack/Blackjack.h"
+#include "games/solitaire/DealIndexBuilder.h"
+#include "core/DealIndex.h"
 
 #include <iostream>
 #include <memory>
+#include <string>
 
 using namespace CardGameLib;
 
 int main(int argc, char** argv)
 {
+    // Offline batch mode: pre-solve deals into a winnable-deal index
+    if (argc > 1 && std::string(argv[1]) == "--build-deal-index") {
+        return Games::Solitaire::DealIndexBuilder::RunCommandLine(argc - 2, argv + 2);
+    }
+    
     std::cout << "CardGameLib - Card Game Framework" << std::endl;
     
+    // Winnable deals for solitaire games created with winnableDealsOnly
+    if (argc > 2 && std::string(argv[1]) == "--deal-index") {
+        if (!Core::DealIndex::LoadDefault(argv[2])) {
+            std::cerr << "Failed to load deal index " << argv[2] << std::endl;
+        }
+    }
+    
     // Initialize platform system
     auto platform = std::unique_ptr<Platform::PlatformSystem>(Platform::CreatePlatformSystem());
     if (!platform) {